@@ -1,5 +1,6 @@
 #include "driver/api/impl/impl.h"
 #include "driver/utils/utils.h"
+#include "driver/utils/session_pool.h"
 #include "driver/driver.h"
 #include "driver/environment.h"
 #include "driver/connection.h"
@@ -68,6 +69,18 @@ SQLRETURN allocDesc(
 SQLRETURN freeHandle(
     SQLHANDLE handle
 ) noexcept {
+    // The buffered rows of a statement are sent before it is freed, with the diagnostics recorded, if that fails,
+    // in which case the statement is not freed, and keeps the rows, so that they are not lost silently.
+    const auto flush_rc = CALL_WITH_HANDLE(handle, [&] (auto & object) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(object)>, Statement>)
+            object.flushInsertBatch();
+
+        return SQL_SUCCESS;
+    });
+
+    if (flush_rc != SQL_SUCCESS)
+        return flush_rc;
+
     return CALL_WITH_HANDLE_SKIP_DIAG(handle, [&] (auto & object) {
         if ( // Refuse to manually deallocate an automatically allocated descriptor.
             std::is_convertible<std::decay<decltype(object)> *, Descriptor *>::value &&
@@ -91,8 +104,32 @@ SQLRETURN SetEnvAttr(
         LOG("SetEnvAttr: " << attribute);
 
         switch (attribute) {
-            case SQL_ATTR_CONNECTION_POOLING:
-            case SQL_ATTR_CP_MATCH:
+            case SQL_ATTR_CONNECTION_POOLING: {
+                const auto int_value = static_cast<SQLUINTEGER>(reinterpret_cast<std::uintptr_t>(value));
+                if (int_value != SQL_CP_OFF && int_value != SQL_CP_ONE_PER_DRIVER && int_value != SQL_CP_ONE_PER_HENV
+#if defined(SQL_CP_DRIVER_AWARE)
+                    && int_value != SQL_CP_DRIVER_AWARE
+#endif
+                )
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                environment.connection_pooling = int_value;
+                LOG("Set connection pooling to " << int_value);
+
+                return SQL_SUCCESS;
+            }
+
+            case SQL_ATTR_CP_MATCH: {
+                const auto int_value = static_cast<SQLUINTEGER>(reinterpret_cast<std::uintptr_t>(value));
+                if (int_value != SQL_CP_STRICT_MATCH && int_value != SQL_CP_RELAXED_MATCH)
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                // The pooled sessions are always matched strictly.
+                environment.cp_match = int_value;
+
+                return SQL_SUCCESS;
+            }
+
             case SQL_ATTR_OUTPUT_NTS:
                 return SQL_SUCCESS;
 
@@ -136,7 +173,11 @@ SQLRETURN GetEnvAttr(
                 return fillOutputPOD<SQLUINTEGER>(environment.odbc_version, out_value, out_value_length);
 
             case SQL_ATTR_CONNECTION_POOLING:
+                return fillOutputPOD<SQLUINTEGER>(environment.connection_pooling, out_value, out_value_length);
+
             case SQL_ATTR_CP_MATCH:
+                return fillOutputPOD<SQLUINTEGER>(environment.cp_match, out_value, out_value_length);
+
             case SQL_ATTR_OUTPUT_NTS:
             default:
                 LOG("GetEnvAttr: Unsupported attribute " << attribute);
@@ -205,8 +246,18 @@ SQLRETURN SetConnectAttr(
                 connection.setAttr(SQL_ATTR_METADATA_ID, value);
                 return SQL_SUCCESS;
 
+            // The default for the statements of the connection.
+            case SQL_ATTR_ASYNC_ENABLE: {
+                const auto enable = reinterpret_cast<SQLULEN>(value);
+
+                if (enable != SQL_ASYNC_ENABLE_ON && enable != SQL_ASYNC_ENABLE_OFF)
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                connection.setAttr(SQL_ATTR_ASYNC_ENABLE, enable);
+                return SQL_SUCCESS;
+            }
+
             case SQL_ATTR_ACCESS_MODE:
-            case SQL_ATTR_ASYNC_ENABLE:
             case SQL_ATTR_AUTO_IPD:
             case SQL_ATTR_AUTOCOMMIT:
             case SQL_ATTR_CONNECTION_DEAD:
@@ -275,8 +326,22 @@ SQLRETURN GetConnectAttr(
                     out_value, out_value_length
                 );
 
-            case SQL_ATTR_ACCESS_MODE:
             case SQL_ATTR_ASYNC_ENABLE:
+                return fillOutputPOD<SQLULEN>(
+                    connection.getAttrAs<SQLULEN>(SQL_ATTR_ASYNC_ENABLE, SQL_ASYNC_ENABLE_OFF),
+                    out_value, out_value_length
+                );
+
+            case CH_SQL_ATTR_SESSION_POOL_HITS:
+                return fillOutputPOD<SQLUBIGINT>(SessionPool::getInstance().getHitCount(), out_value, out_value_length);
+
+            case CH_SQL_ATTR_SESSION_POOL_MISSES:
+                return fillOutputPOD<SQLUBIGINT>(SessionPool::getInstance().getMissCount(), out_value, out_value_length);
+
+            case CH_SQL_ATTR_DRAINED_RESPONSES:
+                return fillOutputPOD<SQLUBIGINT>(connection.drained_response_count.load(), out_value, out_value_length);
+
+            case SQL_ATTR_ACCESS_MODE:
             case SQL_ATTR_AUTO_IPD:
             case SQL_ATTR_ODBC_CURSORS:
             case SQL_ATTR_PACKET_SIZE:
@@ -386,9 +451,8 @@ SQLRETURN SetStmtAttr(
 #undef CASE_SET_IN_DESC
 
             case SQL_ATTR_ROW_ARRAY_SIZE: {
-                // TODO: implement arbitrary array size. Currently only the default (1) is supported.
-                if (reinterpret_cast<SQLULEN>(value) != 1)
-                    throw SqlException("Option value changed", "01S02", SQL_SUCCESS_WITH_INFO);
+                if (reinterpret_cast<SQLULEN>(value) == 0)
+                    throw SqlException("Invalid attribute value", "HY024");
 
                 statement.getEffectiveDescriptor(SQL_ATTR_APP_ROW_DESC).setAttr(SQL_DESC_ARRAY_SIZE, reinterpret_cast<SQLULEN>(value));
                 return SQL_SUCCESS;
@@ -402,6 +466,47 @@ SQLRETURN SetStmtAttr(
                 statement.setAttr(SQL_ATTR_METADATA_ID, value);
                 return SQL_SUCCESS;
 
+            case CH_SQL_ATTR_ARROW_BATCH_SIZE: {
+                if (reinterpret_cast<SQLULEN>(value) == 0)
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                statement.setAttr(CH_SQL_ATTR_ARROW_BATCH_SIZE, reinterpret_cast<SQLULEN>(value));
+                return SQL_SUCCESS;
+            }
+
+            case SQL_ATTR_ASYNC_ENABLE: {
+                const auto enable = reinterpret_cast<SQLULEN>(value);
+
+                if (enable != SQL_ASYNC_ENABLE_ON && enable != SQL_ASYNC_ENABLE_OFF)
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                statement.setAttr(SQL_ATTR_ASYNC_ENABLE, enable);
+                return SQL_SUCCESS;
+            }
+
+            case SQL_ATTR_ASYNC_STMT_PCALLBACK:
+            case SQL_ATTR_ASYNC_STMT_PCONTEXT:
+                statement.setAttr(attribute, value);
+                return SQL_SUCCESS;
+
+            case CH_SQL_ATTR_RAW_RESULT: {
+                const auto enable = reinterpret_cast<SQLULEN>(value);
+
+                if (enable != SQL_TRUE && enable != SQL_FALSE)
+                    throw SqlException("Invalid attribute value", "HY024");
+
+                statement.setAttr(CH_SQL_ATTR_RAW_RESULT, enable);
+                return SQL_SUCCESS;
+            }
+
+            case CH_SQL_ATTR_INSERT_FILE:
+            case CH_SQL_ATTR_INSERT_FILE_FORMAT:
+            case CH_SQL_ATTR_INSERT_FILE_ENCODING: {
+                const auto length = (value_length == SQL_NTS ? SQL_NTS : value_length / static_cast<SQLINTEGER>(sizeof(SQLTCHAR)));
+                statement.setAttr(attribute, toUTF8(reinterpret_cast<SQLTCHAR *>(value), length));
+                return SQL_SUCCESS;
+            }
+
             case SQL_ATTR_APP_ROW_DESC:
             case SQL_ATTR_APP_PARAM_DESC:
             case SQL_ATTR_IMP_ROW_DESC:
@@ -410,7 +515,6 @@ SQLRETURN SetStmtAttr(
 
             case SQL_ATTR_CURSOR_SCROLLABLE:
             case SQL_ATTR_CURSOR_SENSITIVITY:
-            case SQL_ATTR_ASYNC_ENABLE:
             case SQL_ATTR_CONCURRENCY:
             case SQL_ATTR_CURSOR_TYPE: /// Libreoffice Base
             case SQL_ATTR_ENABLE_AUTO_IPD:
@@ -477,13 +581,21 @@ SQLRETURN GetStmtAttr(
 
             CASE_NUM(SQL_ATTR_CURSOR_SCROLLABLE, SQLULEN, SQL_NONSCROLLABLE);
             CASE_NUM(SQL_ATTR_CURSOR_SENSITIVITY, SQLULEN, SQL_INSENSITIVE);
-            CASE_NUM(SQL_ATTR_ASYNC_ENABLE, SQLULEN, SQL_ASYNC_ENABLE_OFF);
             CASE_NUM(SQL_ATTR_CONCURRENCY, SQLULEN, SQL_CONCUR_READ_ONLY);
             CASE_NUM(SQL_ATTR_CURSOR_TYPE, SQLULEN, SQL_CURSOR_FORWARD_ONLY);
             CASE_NUM(SQL_ATTR_ENABLE_AUTO_IPD, SQLULEN, SQL_FALSE);
             CASE_NUM(SQL_ATTR_MAX_LENGTH, SQLULEN, 0);
             CASE_NUM(SQL_ATTR_MAX_ROWS, SQLULEN, 0);
 
+            CASE_FALLTHROUGH(SQL_ATTR_ASYNC_ENABLE)
+                return fillOutputPOD<SQLULEN>(
+                    statement.getAttrAs<SQLULEN>(
+                        SQL_ATTR_ASYNC_ENABLE,
+                        statement.getParent().getAttrAs<SQLULEN>(SQL_ATTR_ASYNC_ENABLE, SQL_ASYNC_ENABLE_OFF)
+                    ),
+                    out_value, out_value_length
+                );
+
             CASE_FALLTHROUGH(SQL_ATTR_METADATA_ID)
                 return fillOutputPOD<SQLULEN>(
                     statement.getAttrAs<SQLULEN>(
@@ -507,6 +619,57 @@ SQLRETURN GetStmtAttr(
                 return fillOutputPOD<SQLULEN>(result_set.getCurrentRowPosition(), out_value, out_value_length);
             }
 
+            CASE_FALLTHROUGH(CH_SQL_ATTR_ARROW_BATCH_SIZE)
+                return fillOutputPOD<SQLULEN>(
+                    statement.getAttrAs<SQLULEN>(CH_SQL_ATTR_ARROW_BATCH_SIZE, CH_SQL_ARROW_BATCH_SIZE_DEFAULT),
+                    out_value, out_value_length
+                );
+
+            CASE_FALLTHROUGH(CH_SQL_ATTR_RAW_RESULT)
+                return fillOutputPOD<SQLULEN>(
+                    statement.getAttrAs<SQLULEN>(CH_SQL_ATTR_RAW_RESULT, SQL_FALSE),
+                    out_value, out_value_length
+                );
+
+            case CH_SQL_ATTR_INSERT_FILE:
+            case CH_SQL_ATTR_INSERT_FILE_FORMAT:
+            case CH_SQL_ATTR_INSERT_FILE_ENCODING:
+                return fillOutputString<SQLTCHAR>(
+                    statement.getAttrAs<std::string>(attribute),
+                    out_value, out_value_max_length, out_value_length, true
+                );
+
+            case CH_SQL_ATTR_ARROW_SCHEMA: {
+                if (!out_value)
+                    throw SqlException("Invalid use of null pointer", "HY009");
+
+                if (!statement.hasResultSet())
+                    throw SqlException("Invalid cursor state", "24000");
+
+                statement.getResultSet().exportArrowSchema(*reinterpret_cast<ArrowSchema *>(out_value));
+                return SQL_SUCCESS;
+            }
+
+            case CH_SQL_ATTR_ARROW_ARRAY: {
+                if (!out_value)
+                    throw SqlException("Invalid use of null pointer", "HY009");
+
+                if (!statement.hasResultSet())
+                    return SQL_NO_DATA;
+
+                auto & result_set = statement.getResultSet();
+                const auto batch_size = statement.getAttrAs<SQLULEN>(CH_SQL_ATTR_ARROW_BATCH_SIZE, CH_SQL_ARROW_BATCH_SIZE_DEFAULT);
+
+                // This acts as SQLFetch() that advances to the next row set of the requested size, bypassing the column bindings.
+                if (result_set.fetchRowSet(SQL_FETCH_NEXT, 0, batch_size) == 0) {
+                    statement.setRowCount(result_set.getAffectedRowCount());
+                    return SQL_NO_DATA;
+                }
+
+                result_set.exportArrowArray(*reinterpret_cast<ArrowArray *>(out_value));
+                return SQL_SUCCESS;
+            }
+
             CASE_NUM(SQL_ATTR_QUERY_TIMEOUT, SQLULEN, 0);
             CASE_NUM(SQL_ATTR_RETRIEVE_DATA, SQLULEN, SQL_RD_ON);
             CASE_NUM(SQL_ATTR_USE_BOOKMARKS, SQLULEN, SQL_UB_OFF);
@@ -1111,13 +1274,18 @@ SQLRETURN EndTran(
     SQLSMALLINT     completion_type
 ) noexcept {
     auto func = [&] (auto & object) {
+        using ObjectType = std::decay_t<decltype(object)>;
 
         // TODO: implement.
 
+        // There are no transactions, but the rows of single-row INSERTs buffered so far are sent at their boundaries.
+        if constexpr (std::is_same_v<ObjectType, Environment> || std::is_same_v<ObjectType, Connection>)
+            object.flushInsertBatches();
+
         return SQL_SUCCESS;
     };
 
-    return CALL_WITH_TYPED_HANDLE_SKIP_DIAG(handle_type, handle, func);
+    return CALL_WITH_TYPED_HANDLE(handle_type, handle, func);
 }
 
 SQLRETURN fillBinding(
@@ -1204,16 +1372,28 @@ SQLRETURN FetchScroll(
 
     auto & result_set = statement.getResultSet();
 
+    // Some result sets are readable by SQLGetData() only, and filling the bound columns would consume their data.
+    if (!statement.bindings.empty() && !result_set.supportsBoundColumns())
+        throw SqlException("Function sequence error", "HY010");
+
     const auto rows_fetched = result_set.fetchRowSet(orientation, offset, row_set_size);
 
     if (rows_fetched == 0) {
-        statement.getDiagHeader().setAttr(SQL_DIAG_ROW_COUNT, result_set.getAffectedRowCount());
+        statement.setRowCount(result_set.getAffectedRowCount());
         return SQL_NO_DATA;
     }
 
     if (rows_fetched_ptr)
         *rows_fetched_ptr = rows_fetched;
 
+    auto * row_status_ptr = statement.getEffectiveDescriptor(SQL_ATTR_IMP_ROW_DESC).getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+
+    if (row_status_ptr) {
+        for (std::size_t i = 0; i < row_set_size; ++i) {
+            row_status_ptr[i] = (i < rows_fetched ? SQL_ROW_SUCCESS : SQL_ROW_NOROW);
+        }
+    }
+
     auto res = SQL_SUCCESS;
 
     for (std::size_t i = 0; i < rows_fetched; ++i) {
@@ -1223,7 +1403,7 @@ SQLRETURN FetchScroll(
                 result_set,
                 i,
                 col_num_binding.first - 1,
-                col_num_binding.second
+                statement.getRowBindingInfo(col_num_binding.second, i)
             );
 
             if (code == SQL_SUCCESS_WITH_INFO)
@@ -73,10 +73,12 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLFreeStmt)(HSTMT statement_handle, SQLUSMA
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, [&] (Statement & statement) -> SQLRETURN {
         switch (option) {
             case SQL_CLOSE: /// Close the cursor, ignore the remaining results. If there is no cursor, then noop.
+                statement.flushInsertBatch();
                 statement.closeCursor();
                 return SQL_SUCCESS;
 
             case SQL_DROP:
+                statement.flushInsertBatch();
                 return impl::freeHandle(statement_handle);
 
             case SQL_UNBIND:
@@ -171,9 +173,9 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLGetInfo)(
 
             /// UINTEGER single values
             CASE_NUM(SQL_ODBC_INTERFACE_CONFORMANCE, SQLUINTEGER, SQL_OIC_CORE)
-            CASE_NUM(SQL_ASYNC_MODE, SQLUINTEGER, SQL_AM_NONE)
+            CASE_NUM(SQL_ASYNC_MODE, SQLUINTEGER, SQL_AM_STATEMENT)
 #if defined(SQL_ASYNC_NOTIFICATION)
-            CASE_NUM(SQL_ASYNC_NOTIFICATION, SQLUINTEGER, SQL_ASYNC_NOTIFICATION_NOT_CAPABLE)
+            CASE_NUM(SQL_ASYNC_NOTIFICATION, SQLUINTEGER, SQL_ASYNC_NOTIFICATION_CAPABLE)
 #endif
             CASE_NUM(SQL_DEFAULT_TXN_ISOLATION, SQLUINTEGER, SQL_TXN_SERIALIZABLE)
 #if defined(SQL_DRIVER_AWARE_POOLING_CAPABLE)
@@ -210,6 +212,7 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLGetInfo)(
                 SQL_AT_ADD_COLUMN_DEFAULT | SQL_AT_ADD_COLUMN_SINGLE | SQL_AT_DROP_COLUMN_DEFAULT | SQL_AT_SET_COLUMN_DEFAULT)
             CASE_NUM(SQL_CONVERT_FUNCTIONS, SQLUINTEGER, /*SQL_FN_CVT_CAST |*/ SQL_FN_CVT_CONVERT)
             CASE_NUM(SQL_CREATE_TABLE, SQLUINTEGER, SQL_CT_CREATE_TABLE)
+            CASE_NUM(SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES1, SQLUINTEGER, SQL_CA1_NEXT | SQL_CA1_BULK_ADD)
             CASE_NUM(SQL_CREATE_VIEW, SQLUINTEGER, SQL_CV_CREATE_VIEW)
             CASE_NUM(SQL_DROP_TABLE, SQLUINTEGER, SQL_DT_DROP_TABLE)
             CASE_NUM(SQL_DROP_VIEW, SQLUINTEGER, SQL_DV_DROP_VIEW)
@@ -341,7 +344,6 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLGetInfo)(
             CASE_FALLTHROUGH(SQL_DROP_TRANSLATION)
             CASE_FALLTHROUGH(SQL_DYNAMIC_CURSOR_ATTRIBUTES1)
             CASE_FALLTHROUGH(SQL_DYNAMIC_CURSOR_ATTRIBUTES2)
-            CASE_FALLTHROUGH(SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES1)
             CASE_FALLTHROUGH(SQL_FORWARD_ONLY_CURSOR_ATTRIBUTES2)
             CASE_FALLTHROUGH(SQL_KEYSET_CURSOR_ATTRIBUTES1)
             CASE_FALLTHROUGH(SQL_KEYSET_CURSOR_ATTRIBUTES2)
@@ -502,8 +504,10 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLExecute)(HSTMT statement_handle) {
     LOG(__FUNCTION__);
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, [&](Statement & statement) {
-        statement.executeQuery();
-        return SQL_SUCCESS;
+        return statement.callAsync(SQL_API_SQLEXECUTE, [&statement] () -> SQLRETURN {
+            statement.executeQuery();
+            return (statement.needData() ? SQL_NEED_DATA : SQL_SUCCESS);
+        });
     });
 }
 
@@ -511,9 +515,11 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLExecDirect)(HSTMT statement_handl
     LOG(__FUNCTION__ << " statement_text_size=" << statement_text_size << " statement_text=" << statement_text);
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, [&](Statement & statement) {
-        const auto query = toUTF8(statement_text, statement_text_size);
-        statement.executeQuery(query);
-        return SQL_SUCCESS;
+        // The text is converted right away, since the buffer may be reused by the application, while the query is executed asynchronously.
+        return statement.callAsync(SQL_API_SQLEXECDIRECT, [&statement, query = toUTF8(statement_text, statement_text_size)] () -> SQLRETURN {
+            statement.executeQuery(query);
+            return (statement.needData() ? SQL_NEED_DATA : SQL_SUCCESS);
+        });
     });
 }
 
@@ -564,7 +570,7 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLColAttribute)(
 
         const auto column_idx = column_number - 1;
         const auto & column_info = result_set.getColumnInfo(column_idx);
-        const auto & type_info = statement.getTypeInfo(column_info.type, column_info.type_without_parameters);
+        const auto & type_info = statement.getTypeInfo(column_info);
 
         std::int32_t SQL_DESC_LENGTH_value = 0;
         if (type_info.isBufferType()) {
@@ -679,7 +685,7 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLDescribeCol)(HSTMT statement_hand
 
         const auto column_idx = column_number - 1;
         const auto & column_info = result_set.getColumnInfo(column_idx);
-        const auto & type_info = statement.getTypeInfo(column_info.type, column_info.type_without_parameters);
+        const auto & type_info = statement.getTypeInfo(column_info);
 
         LOG(__FUNCTION__ << " column_number=" << column_number << "name=" << column_info.name << " type=" << type_info.sql_type
                          << " size=" << type_info.column_size << " nullable=" << column_info.is_nullable);
@@ -702,7 +708,9 @@ SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLDescribeCol)(HSTMT statement_hand
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLFetch)(HSTMT statement_handle) {
     auto func = [&] (Statement & statement) {
-        return impl::FetchScroll(statement, SQL_FETCH_NEXT, 0);
+        return statement.callAsync(SQL_API_SQLFETCH, [&statement] () {
+            return impl::FetchScroll(statement, SQL_FETCH_NEXT, 0);
+        });
     };
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, func);
@@ -710,7 +718,9 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLFetch)(HSTMT statement_handle) {
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLFetchScroll)(HSTMT statement_handle, SQLSMALLINT orientation, SQLLEN offset) {
     auto func = [&] (Statement & statement) {
-        return impl::FetchScroll(statement, orientation, offset);
+        return statement.callAsync(SQL_API_SQLFETCHSCROLL, [&statement, orientation, offset] () {
+            return impl::FetchScroll(statement, orientation, offset);
+        });
     };
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, func);
@@ -762,6 +772,9 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLBindCol)(
         if (column_number < 1)
             throw SqlException("Invalid descriptor index", "07009");
 
+        if (!result_set.supportsBoundColumns())
+            throw SqlException("Function sequence error", "HY010");
+
         // Unbinding column
         if (out_value_size_or_indicator == nullptr) {
             statement.bindings.erase(column_number);
@@ -804,14 +817,16 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLMoreResults)(HSTMT statement_handle) {
     LOG(__FUNCTION__);
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, [&](Statement & statement) {
-        return (statement.advanceToNextResultSet() ? SQL_SUCCESS : SQL_NO_DATA);
+        return statement.callAsync(SQL_API_SQLMORERESULTS, [&statement] () -> SQLRETURN {
+            return (statement.advanceToNextResultSet() ? SQL_SUCCESS : SQL_NO_DATA);
+        });
     });
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLDisconnect)(HDBC connection_handle) {
     LOG(__FUNCTION__);
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_DBC, connection_handle, [&](Connection & connection) {
-        connection.session->reset();
+        connection.disconnect();
         return SQL_SUCCESS;
     });
 }
@@ -1249,6 +1264,7 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLCloseCursor)(HSTMT statement_handle) {
     LOG(__FUNCTION__);
 
     return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, statement_handle, [&](Statement & statement) -> SQLRETURN {
+        statement.flushInsertBatch();
         statement.closeCursor();
         return SQL_SUCCESS;
     });
@@ -1268,11 +1284,12 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLCancel)(
     SQLHSTMT     StatementHandle
 ) {
     auto func = [&] (Statement & statement) {
-        statement.closeCursor();
+        statement.cancel();
         return SQL_SUCCESS;
     };
 
-    return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, StatementHandle, func);
+    // The diagnostics are not touched, since the statement may be executing in another thread.
+    return CALL_WITH_TYPED_HANDLE_SKIP_DIAG(SQL_HANDLE_STMT, StatementHandle, func);
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLGetCursorName)(
@@ -1298,14 +1315,14 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLGetFunctions)(HDBC connection_handle, SQL
             SET_EXISTS(SQL_API_SQLBINDPARAM);
 #endif
             //SET_EXISTS(SQL_API_SQLBROWSECONNECT);
-            //SET_EXISTS(SQL_API_SQLBULKOPERATIONS);
+            SET_EXISTS(SQL_API_SQLBULKOPERATIONS);
             SET_EXISTS(SQL_API_SQLCANCEL);
-            //SET_EXISTS(SQL_API_SQLCANCELHANDLE);
+            SET_EXISTS(SQL_API_SQLCANCELHANDLE);
             SET_EXISTS(SQL_API_SQLCLOSECURSOR);
             SET_EXISTS(SQL_API_SQLCOLATTRIBUTE);
             //SET_EXISTS(SQL_API_SQLCOLUMNPRIVILEGES);
             SET_EXISTS(SQL_API_SQLCOLUMNS);
-            //SET_EXISTS(SQL_API_SQLCOMPLETEASYNC);
+            SET_EXISTS(SQL_API_SQLCOMPLETEASYNC);
             SET_EXISTS(SQL_API_SQLCONNECT);
             SET_EXISTS(SQL_API_SQLCOPYDESC);
             SET_EXISTS(SQL_API_SQLDESCRIBECOL);
@@ -1337,12 +1354,12 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLGetFunctions)(HDBC connection_handle, SQL
             SET_EXISTS(SQL_API_SQLNATIVESQL);
             SET_EXISTS(SQL_API_SQLNUMPARAMS);
             SET_EXISTS(SQL_API_SQLNUMRESULTCOLS);
-            //SET_EXISTS(SQL_API_SQLPARAMDATA);
+            SET_EXISTS(SQL_API_SQLPARAMDATA);
             SET_EXISTS(SQL_API_SQLPREPARE);
             //SET_EXISTS(SQL_API_SQLPRIMARYKEYS);
             //SET_EXISTS(SQL_API_SQLPROCEDURECOLUMNS);
             //SET_EXISTS(SQL_API_SQLPROCEDURES);
-            //SET_EXISTS(SQL_API_SQLPUTDATA);
+            SET_EXISTS(SQL_API_SQLPUTDATA);
             SET_EXISTS(SQL_API_SQLROWCOUNT);
             SET_EXISTS(SQL_API_SQLSETCONNECTATTR);
             //SET_EXISTS(SQL_API_SQLSETCURSORNAME);
@@ -1385,12 +1402,28 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLGetFunctions)(HDBC connection_handle, SQL
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLParamData)(HSTMT StatementHandle, PTR * Value) {
     LOG(__FUNCTION__);
-    return SQL_ERROR;
+
+    return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, StatementHandle, [&](Statement & statement) {
+        SQLPOINTER token = nullptr;
+
+        if (statement.advanceDataAtExecParam(token)) {
+            if (Value)
+                *Value = token;
+
+            return SQL_NEED_DATA;
+        }
+
+        return SQL_SUCCESS;
+    });
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLPutData)(HSTMT StatementHandle, PTR Data, SQLLEN StrLen_or_Ind) {
-    LOG(__FUNCTION__);
-    return SQL_ERROR;
+    LOG(__FUNCTION__ << " StrLen_or_Ind=" << StrLen_or_Ind);
+
+    return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, StatementHandle, [&](Statement & statement) {
+        statement.putDataAtExecParamData(Data, StrLen_or_Ind);
+        return SQL_SUCCESS;
+    });
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION_MAYBE_W(SQLSetCursorName)(HSTMT StatementHandle, SQLTCHAR * CursorName, SQLSMALLINT NameLength) {
@@ -1599,18 +1632,74 @@ SQLRETURN SQL_API EXPORTED_FUNCTION(SQLBulkOperations)(
     SQLHSTMT         StatementHandle,
     SQLSMALLINT      Operation
 ) {
-    LOG(__FUNCTION__);
-    return SQL_ERROR;
+    LOG(__FUNCTION__ << " Operation=" << Operation);
+
+    auto func = [&] (Statement & statement) {
+        switch (Operation) {
+            case SQL_ADD: {
+                statement.bulkAdd();
+                return SQL_SUCCESS;
+            }
+        }
+
+        throw SqlException("Optional feature not implemented", "HYC00");
+    };
+
+    return CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, StatementHandle, func);
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLCancelHandle)(SQLSMALLINT HandleType, SQLHANDLE Handle) {
     LOG(__FUNCTION__);
-    return SQL_ERROR;
+
+    switch (HandleType) {
+        case SQL_HANDLE_STMT: {
+            auto func = [&] (Statement & statement) {
+                statement.cancel();
+                return SQL_SUCCESS;
+            };
+
+            return CALL_WITH_TYPED_HANDLE_SKIP_DIAG(SQL_HANDLE_STMT, Handle, func);
+        }
+
+        case SQL_HANDLE_DBC: {
+            // Connection functions are never executed asynchronously, so there is nothing to cancel.
+            auto func = [&] (Connection &) {
+                return SQL_SUCCESS;
+            };
+
+            return CALL_WITH_TYPED_HANDLE_SKIP_DIAG(SQL_HANDLE_DBC, Handle, func);
+        }
+
+        default:
+            return SQL_INVALID_HANDLE;
+    }
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLCompleteAsync)(SQLSMALLINT HandleType, SQLHANDLE Handle, RETCODE * AsyncRetCodePtr) {
     LOG(__FUNCTION__);
-    return SQL_ERROR;
+
+    // Connection functions are never executed asynchronously.
+    if (HandleType != SQL_HANDLE_STMT)
+        return SQL_ERROR;
+
+    if (!AsyncRetCodePtr)
+        return SQL_ERROR;
+
+    auto has_operation = [&] (Statement & statement) -> SQLRETURN {
+        return (statement.hasAsyncOperation() ? SQL_SUCCESS : SQL_NO_DATA);
+    };
+
+    const auto rc = CALL_WITH_TYPED_HANDLE_SKIP_DIAG(SQL_HANDLE_STMT, Handle, has_operation);
+    if (rc != SQL_SUCCESS)
+        return rc;
+
+    // The diagnostics of the statement are those of the completed function.
+    auto complete = [&] (Statement & statement) {
+        return statement.completeAsync();
+    };
+
+    *AsyncRetCodePtr = CALL_WITH_TYPED_HANDLE(SQL_HANDLE_STMT, Handle, complete);
+    return SQL_SUCCESS;
 }
 
 SQLRETURN SQL_API EXPORTED_FUNCTION(SQLEndTran)(
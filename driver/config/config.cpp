@@ -336,6 +336,25 @@ key_value_map_t readDSNInfo(const std::string & dsn_utf8) {
             INI_PATH,
             INI_DATABASE,
             INI_STRINGMAXLENGTH,
+            INI_DECODETHREADS,
+            INI_INLISTTHRESHOLD,
+            INI_INSERTBATCHROWS,
+            INI_INSERTBATCHBYTES,
+            INI_INSERTBATCHTIMEOUT,
+            INI_REQUESTCOMPRESSION,
+            INI_COMPRESSMINSIZE,
+            INI_COMPRESSION,
+            INI_DECOMPRESSTHREAD,
+            INI_ZEROCOPYREAD,
+            INI_READSERVERS,
+            INI_WRITESERVERS,
+            INI_LOADBALANCING,
+            INI_SERVERWEIGHTS,
+            INI_FAILOVERCOOLDOWN,
+            INI_DNSCACHETTL,
+            INI_POOLSIZE,
+            INI_POOLIDLETIMEOUT,
+            INI_DRAINLIMIT,
             INI_DRIVERLOG,
             INI_DRIVERLOGFILE
         }
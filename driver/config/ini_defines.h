@@ -5,30 +5,49 @@
 #define MAX_DSN_KEY_LEN   256
 #define MAX_DSN_VALUE_LEN 10240
 
-#define INI_DRIVER          "Driver"
-#define INI_FILEDSN         "FileDSN"
-#define INI_SAVEFILE        "SaveFile"
-#define INI_DSN             "DSN"
-#define INI_DESC            "Description"     /* Data source description */
-#define INI_URL             "Url"             /* Full url of server running the ClickHouse service */
-#define INI_UID             "UID"             /* Default User Name */
-#define INI_USERNAME        "Username"
-#define INI_PWD             "PWD"             /* Default Password */
-#define INI_PASSWORD        "Password"
-#define INI_PROTO           "Proto"           /* HTTP vs HTTPS */
-#define INI_SERVER          "Server"          /* Name of Server running the ClickHouse service */
-#define INI_HOST            "Host"
-#define INI_PORT            "Port"            /* Port on which the ClickHouse is listening */
-#define INI_TIMEOUT         "Timeout"         /* Connection timeout */
-#define INI_SSLMODE         "SSLMode"         /* Use 'require' for https connections */
-#define INI_PRIVATEKEYFILE  "PrivateKeyFile"
-#define INI_CERTIFICATEFILE "CertificateFile"
-#define INI_CALOCATION      "CALocation"
-#define INI_PATH            "Path"            /* Path portion of the URL */
-#define INI_DATABASE        "Database"        /* Database Name */
-#define INI_STRINGMAXLENGTH "StringMaxLength"
-#define INI_DRIVERLOG       "DriverLog"
-#define INI_DRIVERLOGFILE   "DriverLogFile"
+#define INI_DRIVER             "Driver"
+#define INI_FILEDSN            "FileDSN"
+#define INI_SAVEFILE           "SaveFile"
+#define INI_DSN                "DSN"
+#define INI_DESC               "Description"        /* Data source description */
+#define INI_URL                "Url"                /* Full url of server running the ClickHouse service */
+#define INI_UID                "UID"                /* Default User Name */
+#define INI_USERNAME           "Username"
+#define INI_PWD                "PWD"                /* Default Password */
+#define INI_PASSWORD           "Password"
+#define INI_PROTO              "Proto"              /* HTTP vs HTTPS vs native */
+#define INI_SERVER             "Server"             /* Name of Server running the ClickHouse service, or a comma-separated list of servers */
+#define INI_HOST               "Host"
+#define INI_PORT               "Port"               /* Port on which the ClickHouse is listening */
+#define INI_TIMEOUT            "Timeout"            /* Connection timeout */
+#define INI_SSLMODE            "SSLMode"            /* Use 'require' for https connections */
+#define INI_PRIVATEKEYFILE     "PrivateKeyFile"
+#define INI_CERTIFICATEFILE    "CertificateFile"
+#define INI_CALOCATION         "CALocation"
+#define INI_PATH               "Path"               /* Path portion of the URL */
+#define INI_DATABASE           "Database"           /* Database Name */
+#define INI_STRINGMAXLENGTH    "StringMaxLength"
+#define INI_DECODETHREADS      "DecodeThreads"      /* Number of threads decoding RowBinaryWithNamesAndTypes result sets */
+#define INI_INLISTTHRESHOLD    "InListThreshold"    /* Min number of IN list parameters sent as an external table */
+#define INI_INSERTBATCHROWS    "InsertBatchRows"    /* Max number of buffered rows of single-row prepared INSERTs */
+#define INI_INSERTBATCHBYTES   "InsertBatchBytes"   /* Max size of buffered rows of single-row prepared INSERTs */
+#define INI_INSERTBATCHTIMEOUT "InsertBatchTimeout" /* Max age, in seconds, of buffered rows of single-row prepared INSERTs */
+#define INI_REQUESTCOMPRESSION "RequestCompression" /* Content-Encoding of large request bodies: gzip, deflate, or none */
+#define INI_COMPRESSMINSIZE    "CompressMinSize"    /* Min size of request bodies compressed according to RequestCompression */
+#define INI_COMPRESSION        "Compression"        /* Compression of responses requested from the server: gzip, deflate, lz4 (native protocol only), or none */
+#define INI_DECOMPRESSTHREAD   "DecompressThread"   /* Decompress responses on a helper thread */
+#define INI_ZEROCOPYREAD       "ZeroCopyRead"       /* Read response bodies directly from the socket */
+#define INI_READSERVERS        "ReadServers"        /* Comma-separated list of servers, that the read-only queries are sent to */
+#define INI_WRITESERVERS       "WriteServers"       /* Comma-separated list of servers, that the INSERTs and the DDL queries are sent to */
+#define INI_LOADBALANCING      "LoadBalancing"      /* Policy of choosing among the listed servers: round_robin, least_outstanding, or random */
+#define INI_SERVERWEIGHTS      "ServerWeights"      /* Comma-separated weights of the listed servers, used by the random policy */
+#define INI_FAILOVERCOOLDOWN   "FailoverCooldown"   /* Time, in seconds, between the health checks of a failed server, that is not used meanwhile */
+#define INI_DNSCACHETTL        "DNSCacheTTL"        /* Time, in seconds, the resolved addresses of the servers are cached for */
+#define INI_POOLSIZE           "PoolSize"           /* Max number of idle sessions kept for reuse by later connections with the same settings */
+#define INI_POOLIDLETIMEOUT    "PoolIdleTimeout"    /* Max time, in seconds, an idle session is kept for reuse */
+#define INI_DRAINLIMIT         "DrainLimit"         /* Max size, in bytes, of the unread rest of a response, that is read and discarded to keep the session */
+#define INI_DRIVERLOG          "DriverLog"
+#define INI_DRIVERLOGFILE      "DriverLogFile"
 
 #if defined(UNICODE)
 #   define INI_DSN_DEFAULT          DSN_DEFAULT_UNICODE
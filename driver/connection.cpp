@@ -1,4 +1,7 @@
 #include "driver/utils/utils.h"
+#include "driver/utils/http_response_body.h"
+#include "driver/utils/session_pool.h"
+#include "driver/utils/dns_cache.h"
 #include "driver/config/ini_defines.h"
 #include "driver/connection.h"
 #include "driver/descriptor.h"
@@ -6,7 +9,10 @@
 
 #include <Poco/Base64Encoder.h>
 #include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/Net/SocketAddress.h>
 #include <Poco/NumberParser.h> // TODO: switch to std
+#include <Poco/StringTokenizer.h>
 #include <Poco/URI.h>
 
 #if !defined(WORKAROUND_DISABLE_SSL)
@@ -21,6 +27,58 @@
 
 std::once_flag ssl_init_once;
 
+namespace {
+
+    std::unique_ptr<Poco::Net::HTTPClientSession> makeSession(bool is_ssl, const Endpoint & endpoint, std::uint32_t connection_timeout, std::uint32_t timeout) {
+        // The sessions let the statements read the response bodies directly from their sockets.
+        std::unique_ptr<Poco::Net::HTTPClientSession> new_session;
+
+#if !defined(WORKAROUND_DISABLE_SSL)
+        if (is_ssl)
+            new_session = std::make_unique<DirectReadHTTPSession<Poco::Net::HTTPSClientSession>>();
+        else
+#endif
+            new_session = std::make_unique<DirectReadHTTPSession<Poco::Net::HTTPClientSession>>();
+
+        new_session->setHost(endpoint.host);
+        new_session->setPort(endpoint.port);
+        new_session->setKeepAlive(true);
+        new_session->setTimeout(Poco::Timespan(connection_timeout, 0), Poco::Timespan(timeout, 0), Poco::Timespan(timeout, 0));
+        new_session->setKeepAliveTimeout(Poco::Timespan(86400, 0));
+
+        return new_session;
+    }
+
+    bool isSessionTo(const Poco::Net::HTTPClientSession & session, const Endpoint & endpoint) {
+        return (session.getHost() == endpoint.host && session.getPort() == endpoint.port);
+    }
+
+    bool isSessionTo(const NativeSession & session, const Endpoint & endpoint) {
+        return (session.getEndpoint().host == endpoint.host && session.getEndpoint().port == endpoint.port);
+    }
+
+    // Poco::URI does not accept a list of hosts, so all of them, but the first one, are taken out of the URL, and the entire list is returned.
+    std::string extractServerList(std::string & url) {
+        const auto scheme_end = url.find("://");
+        const auto authority_begin = (scheme_end == std::string::npos ? 0 : scheme_end + 3);
+        auto authority_end = url.find_first_of("/?#", authority_begin);
+        if (authority_end == std::string::npos)
+            authority_end = url.size();
+
+        auto hosts_begin = url.rfind('@', authority_end);
+        hosts_begin = (hosts_begin == std::string::npos || hosts_begin < authority_begin ? authority_begin : hosts_begin + 1);
+
+        const auto comma = url.find(',', hosts_begin);
+        if (comma == std::string::npos || comma >= authority_end)
+            return {};
+
+        auto list = url.substr(hosts_begin, authority_end - hosts_begin);
+        url.erase(comma, authority_end - comma);
+        return list;
+    }
+
+} // namespace
+
 #if !defined(WORKAROUND_DISABLE_SSL)
 void SSLInit(bool ssl_strict, const std::string & privateKeyFile, const std::string & certificateFile, const std::string & caLocation) {
 // http://stackoverflow.com/questions/18315472/https-request-in-c-using-poco
@@ -54,7 +112,7 @@ Connection::Connection(Environment & environment)
 }
 
 void Connection::connect(const std::string & connection_string) {
-    if (session && session->connected())
+    if (load_balancer)
         throw SqlException("Connection name in use", "08002");
 
     auto cs_fields = readConnectionString(connection_string);
@@ -110,28 +168,415 @@ void Connection::connect(const std::string & connection_string) {
     resetConfiguration();
     setConfiguration(cs_fields, dsn_fields);
 
-    LOG("Creating session with " << proto << "://" << server << ":" << port);
+    session.reset();
 
-#if !defined(WORKAROUND_DISABLE_SSL)
+    load_balancer = getSharedLoadBalancer(endpoints);
+
+    // The temporary tables and the settings of a server session (session_id) exist only on the server, that holds it,
+    // so all the queries are sent to the servers of the main list then, instead of being split between the lists.
+    bool session_id_set = false;
+    for (const auto & parameter : buildURI().getQueryParameters()) {
+        if (Poco::UTF8::icompare(parameter.first, "session_id") == 0)
+            session_id_set = true;
+    }
+
+    if (session_id_set && (!read_endpoints.empty() || !write_endpoints.empty()))
+        LOG("session_id is set, ReadServers and WriteServers are ignored");
+
+    // The reads and the writes are sent to the servers of the main list, unless their own lists are configured.
+    if (!read_endpoints.empty() && !session_id_set)
+        read_load_balancer = getSharedLoadBalancer(read_endpoints);
+
+    if (!write_endpoints.empty() && !session_id_set)
+        write_load_balancer = getSharedLoadBalancer(write_endpoints);
+}
+
+std::shared_ptr<LoadBalancer> Connection::getSharedLoadBalancer(const std::vector<Endpoint> & balanced_endpoints) const {
+    // The balancer is shared by all connections to the same servers, so that they all know which of them have failed.
     const auto is_ssl = (Poco::UTF8::icompare(proto, "https") == 0);
+    const auto is_native = isNativeProtocol();
+    const auto health_check_timeout = connection_timeout;
+
+    std::ostringstream balancer_key;
+    balancer_key << Poco::UTF8::toLower(proto) << "\n" << load_balancing << "\n" << failover_cooldown;
+    for (const auto & endpoint : balanced_endpoints)
+        balancer_key << "\n" << endpoint.host << ":" << endpoint.port << "*" << endpoint.weight;
+
+    return LoadBalancer::getShared(balancer_key.str(), [&] () {
+        auto policy = LoadBalancer::Policy::RoundRobin;
+        if (load_balancing == "least_outstanding")
+            policy = LoadBalancer::Policy::LeastOutstanding;
+        else if (load_balancing == "random")
+            policy = LoadBalancer::Policy::Random;
+
+        auto health_check = [is_ssl, is_native, health_check_timeout] (const Endpoint & endpoint) {
+            // The native protocol needs the credentials to ping the server, so the server, that accepts the connections, is healthy.
+            if (is_native) {
+                NativeSession check_session(endpoint, false);
+                check_session.setTimeout(Poco::Timespan(health_check_timeout, 0), Poco::Timespan(health_check_timeout, 0));
+                check_session.connectTo(Poco::Net::SocketAddress(endpoint.host, endpoint.port));
+                return true;
+            }
+
+            auto check_session = makeSession(is_ssl, endpoint, health_check_timeout, health_check_timeout);
+            Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_GET, "/ping", Poco::Net::HTTPRequest::HTTP_1_1);
+            check_session->sendRequest(request);
+
+            Poco::Net::HTTPResponse response;
+            check_session->receiveResponse(response);
+            return (response.getStatus() == Poco::Net::HTTPResponse::HTTP_OK);
+        };
+
+        return std::make_shared<LoadBalancer>(balanced_endpoints, policy, std::chrono::seconds(failover_cooldown), health_check);
+    });
+}
+
+void Connection::disconnect() {
+    flushInsertBatches();
+
+    // The responses, that are still being read, are abandoned, so that the session is either idle or reset.
+    for (auto & handle_statement : statements) {
+        handle_statement.second->closeCursor();
+    }
+
+    std::vector<std::unique_ptr<Poco::Net::HTTPClientSession>> sessions;
+    std::vector<std::unique_ptr<NativeSession>> native_sessions; // Not pooled, closed when dropped.
+
+    {
+        std::lock_guard<std::mutex> lock(session_mutex);
+        sessions.swap(idle_sessions);
+        native_sessions.swap(idle_native_sessions);
+
+        if (session)
+            sessions.emplace_back(std::move(session));
+    }
+
+    for (auto & idle_session : sessions) {
+        if (pool_size > 0 && idle_session->connected())
+            SessionPool::getInstance().release(buildSessionPoolKey(idle_session->getHost(), idle_session->getPort()), std::move(idle_session), pool_size);
+    }
+
+    load_balancer.reset();
+    read_load_balancer.reset();
+    write_load_balancer.reset();
+}
+
+std::unique_ptr<Poco::Net::HTTPClientSession> Connection::createSession(const Endpoint & endpoint) const {
+    LOG("Creating session with " << proto << "://" << endpoint.host << ":" << endpoint.port);
+
+    const auto is_ssl = (Poco::UTF8::icompare(proto, "https") == 0);
+
+#if !defined(WORKAROUND_DISABLE_SSL)
     if (is_ssl) {
         const auto ssl_strict = (Poco::UTF8::icompare(sslmode, "allow") != 0);
         std::call_once(ssl_init_once, SSLInit, ssl_strict, privateKeyFile, certificateFile, caLocation);
     }
 #endif
 
-    session = (
-#if !defined(WORKAROUND_DISABLE_SSL)
-        is_ssl ? std::make_unique<Poco::Net::HTTPSClientSession>() :
-#endif
-        std::make_unique<Poco::Net::HTTPClientSession>()
-    );
+    return makeSession(is_ssl, endpoint, connection_timeout, timeout);
+}
+
+std::unique_ptr<Poco::Net::HTTPClientSession> Connection::borrowSession(QueryKind query_kind) {
+    if (!load_balancer)
+        throw SqlException("Connection does not exist", "08003");
+
+    const auto balancer = getLoadBalancer(query_kind);
+    std::exception_ptr error;
+
+    // Each server is tried at most once, the failed ones are ejected, so that they are not chosen again.
+    for (std::size_t attempt = 0; attempt < balancer->size(); ++attempt) {
+        const auto endpoint_idx = balancer->start();
+        const auto & endpoint = balancer->getEndpoint(endpoint_idx);
+
+        std::unique_ptr<Poco::Net::HTTPClientSession> borrowed;
+
+        {
+            std::lock_guard<std::mutex> lock(session_mutex);
 
-    session->setHost(server);
-    session->setPort(port);
-    session->setKeepAlive(true);
-    session->setTimeout(Poco::Timespan(connection_timeout, 0), Poco::Timespan(timeout, 0), Poco::Timespan(timeout, 0));
-    session->setKeepAliveTimeout(Poco::Timespan(86400, 0));
+            if (session && isSessionTo(*session, endpoint)) {
+                borrowed = std::move(session);
+            }
+            else {
+                for (auto it = idle_sessions.rbegin(); it != idle_sessions.rend(); ++it) {
+                    if (isSessionTo(**it, endpoint)) {
+                        borrowed = std::move(*it);
+                        idle_sessions.erase(std::next(it).base());
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!borrowed && pool_size > 0)
+            borrowed = SessionPool::getInstance().acquire(buildSessionPoolKey(endpoint.host, endpoint.port), std::chrono::seconds(pool_idle_timeout));
+
+        if (borrowed) {
+            // The timeouts may have been changed since the session was created.
+            borrowed->setTimeout(Poco::Timespan(connection_timeout, 0), Poco::Timespan(timeout, 0), Poco::Timespan(timeout, 0));
+        }
+        else {
+            borrowed = createSession(endpoint);
+        }
+
+        try {
+            if (!borrowed->connected())
+                connectSession(*borrowed, endpoint);
+        }
+        catch (const Poco::Exception & ex) {
+            LOG("Failed to connect to " << endpoint.host << ":" << endpoint.port << ": " << ex.displayText() << ", ejecting the server");
+            balancer->finish(endpoint_idx);
+            balancer->eject(endpoint_idx);
+            error = std::current_exception();
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(session_mutex);
+        borrowed_sessions[borrowed.get()] = BorrowedSession{balancer, endpoint_idx};
+        return borrowed;
+    }
+
+    std::rethrow_exception(error);
+}
+
+void Connection::returnSession(std::unique_ptr<Poco::Net::HTTPClientSession> && returned) {
+    if (!returned)
+        return;
+
+    std::lock_guard<std::mutex> lock(session_mutex);
+
+    const auto it = borrowed_sessions.find(returned.get());
+    if (it == borrowed_sessions.end())
+        return;
+
+    const auto borrowed = std::move(it->second);
+    borrowed_sessions.erase(it);
+    borrowed.balancer->finish(borrowed.endpoint_idx);
+
+    // The session, that has been redirected to another server, or is returned after disconnecting, is not reused.
+    if (!load_balancer || !isSessionTo(*returned, borrowed.balancer->getEndpoint(borrowed.endpoint_idx)))
+        return;
+
+    if (!session)
+        session = std::move(returned);
+    else
+        idle_sessions.emplace_back(std::move(returned));
+}
+
+bool Connection::isNativeProtocol() const {
+    return (Poco::UTF8::icompare(proto, "native") == 0);
+}
+
+std::unique_ptr<NativeSession> Connection::borrowNativeSession(QueryKind query_kind) {
+    if (!load_balancer)
+        throw SqlException("Connection does not exist", "08003");
+
+    const auto balancer = getLoadBalancer(query_kind);
+    std::exception_ptr error;
+
+    // Each server is tried at most once, the same as in borrowSession().
+    for (std::size_t attempt = 0; attempt < balancer->size(); ++attempt) {
+        const auto endpoint_idx = balancer->start();
+        const auto & endpoint = balancer->getEndpoint(endpoint_idx);
+
+        std::unique_ptr<NativeSession> borrowed;
+
+        {
+            std::lock_guard<std::mutex> lock(session_mutex);
+
+            for (auto it = idle_native_sessions.rbegin(); it != idle_native_sessions.rend(); ++it) {
+                if (isSessionTo(**it, endpoint)) {
+                    borrowed = std::move(*it);
+                    idle_native_sessions.erase(std::next(it).base());
+                    break;
+                }
+            }
+        }
+
+        try {
+            if (borrowed) {
+                // The server may have closed the idle connection, which is only noticed when talking to it.
+                try {
+                    borrowed->setTimeout(Poco::Timespan(connection_timeout, 0), Poco::Timespan(timeout, 0));
+                    borrowed->getClient().ping();
+                }
+                catch (const std::exception & ex) {
+                    LOG("Idle native session to " << endpoint.host << ":" << endpoint.port << " is broken: " << ex.what() << ", reconnecting");
+                    borrowed->reset();
+                }
+            }
+            else {
+                borrowed = std::make_unique<NativeSession>(endpoint, compression == "lz4");
+            }
+
+            if (!borrowed->connected())
+                connectNativeSession(*borrowed, endpoint);
+        }
+        catch (const Poco::Exception & ex) {
+            LOG("Failed to connect to " << endpoint.host << ":" << endpoint.port << ": " << ex.displayText() << ", ejecting the server");
+            balancer->finish(endpoint_idx);
+            balancer->eject(endpoint_idx);
+            error = std::current_exception();
+            continue;
+        }
+        catch (...) {
+            // E.g., the server has rejected the credentials, which is not a failure of the server.
+            balancer->finish(endpoint_idx);
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock(session_mutex);
+        borrowed_native_sessions[borrowed.get()] = BorrowedSession{balancer, endpoint_idx};
+        return borrowed;
+    }
+
+    std::rethrow_exception(error);
+}
+
+void Connection::returnNativeSession(std::unique_ptr<NativeSession> && returned) {
+    if (!returned)
+        return;
+
+    std::lock_guard<std::mutex> lock(session_mutex);
+
+    const auto it = borrowed_native_sessions.find(returned.get());
+    if (it == borrowed_native_sessions.end())
+        return;
+
+    const auto borrowed = std::move(it->second);
+    borrowed_native_sessions.erase(it);
+    borrowed.balancer->finish(borrowed.endpoint_idx);
+
+    // The session, that is still receiving the results of a query, or is returned after disconnecting, is not reused.
+    if (!load_balancer || !returned->connected() || returned->getClient().isQueryRunning())
+        return;
+
+    idle_native_sessions.emplace_back(std::move(returned));
+}
+
+void Connection::reportSessionFailure(const Poco::Net::HTTPClientSession & failed) {
+    std::lock_guard<std::mutex> lock(session_mutex);
+
+    const auto it = borrowed_sessions.find(&failed);
+    if (it == borrowed_sessions.end())
+        return;
+
+    const auto & borrowed = it->second;
+    const auto & endpoint = borrowed.balancer->getEndpoint(borrowed.endpoint_idx);
+    LOG("Server " << endpoint.host << ":" << endpoint.port << " has failed, ejecting it");
+    borrowed.balancer->eject(borrowed.endpoint_idx);
+}
+
+std::shared_ptr<LoadBalancer> Connection::getLoadBalancer(QueryKind query_kind) const {
+    if (query_kind == QueryKind::Read && read_load_balancer)
+        return read_load_balancer;
+    else if (query_kind == QueryKind::Write && write_load_balancer)
+        return write_load_balancer;
+
+    return load_balancer;
+}
+
+void Connection::connectSession(Poco::Net::HTTPClientSession & unconnected, const Endpoint & endpoint) const {
+    // Sessions of other kinds connect by themselves, when sending the first request.
+    auto * connectable = dynamic_cast<AddressConnectable *>(&unconnected);
+    if (!connectable)
+        return;
+
+    connectToAnyAddress(*connectable, endpoint);
+}
+
+void Connection::connectToAnyAddress(AddressConnectable & connectable, const Endpoint & endpoint) const {
+    const auto addresses = DNSCache::getInstance().resolve(endpoint.host, std::chrono::seconds(dns_cache_ttl));
+
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        try {
+            connectable.connectTo(Poco::Net::SocketAddress(addresses[i], endpoint.port));
+            return;
+        }
+        catch (const Poco::Exception & ex) {
+            LOG("Failed to connect to " << addresses[i].toString() << " of " << endpoint.host << ": " << ex.displayText());
+
+            if (i + 1 == addresses.size()) {
+                // The addresses may have changed.
+                DNSCache::getInstance().invalidate(endpoint.host);
+                throw;
+            }
+        }
+    }
+}
+
+void Connection::connectNativeSession(NativeSession & unconnected, const Endpoint & endpoint) const {
+    unconnected.setTimeout(Poco::Timespan(connection_timeout, 0), Poco::Timespan(timeout, 0));
+    connectToAnyAddress(unconnected, endpoint);
+
+    try {
+        const NativeProtocolClient::ClientInfo client_info{"clickhouse-odbc", VERSION_MAJOR, VERSION_MINOR};
+        unconnected.getClient().handshake(client_info, database, username, password);
+    }
+    catch (...) {
+        unconnected.reset();
+        throw;
+    }
+}
+
+void Connection::killQuery(const std::string & query_id, const Endpoint & endpoint) const {
+    LOG("Killing query " << query_id << " on " << endpoint.host << ":" << endpoint.port);
+
+    // The server is only asked to kill the query, without waiting for it to stop.
+    const auto kill_query = "KILL QUERY WHERE query_id = '" + escapeForSQL(query_id) + "' ASYNC";
+
+    // The sessions of the connection may be busy, or stuck, reading the responses, so a separate one is used.
+    if (isNativeProtocol()) {
+        NativeSession kill_session(endpoint, false);
+        connectNativeSession(kill_session, endpoint);
+
+        auto & client = kill_session.getClient();
+        client.sendQuery("", kill_query);
+
+        NativeProtocolClient::Block ignored;
+        while (client.receiveBlock(ignored)) {
+        }
+
+        return;
+    }
+
+    auto kill_session = createSession(endpoint);
+    kill_session->setKeepAlive(false);
+    connectSession(*kill_session, endpoint);
+
+    Poco::Net::HTTPRequest request(Poco::Net::HTTPRequest::HTTP_POST, buildURI().getPathEtc(), Poco::Net::HTTPRequest::HTTP_1_1);
+    request.setCredentials("Basic", buildCredentialsString());
+    request.set("User-Agent", buildUserAgentString());
+    request.setContentLength(kill_query.size());
+    kill_session->sendRequest(request) << kill_query;
+
+    Poco::Net::HTTPResponse response;
+    auto & response_stream = kill_session->receiveResponse(response);
+
+    if (response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK) {
+        std::stringstream error_message;
+        error_message << "HTTP status code: " << response.getStatus() << std::endl << "Received error:" << std::endl << response_stream.rdbuf() << std::endl;
+        throw std::runtime_error(error_message.str());
+    }
+
+    response_stream.ignore(std::numeric_limits<std::streamsize>::max());
+}
+
+std::string Connection::getRequestEncoding(std::size_t body_size) const {
+    if (body_size < compress_min_size)
+        return {};
+
+    return request_compression;
+}
+
+void Connection::requestCompressedResponse(Poco::Net::HTTPRequest & request) const {
+    if (!compression.empty())
+        request.set("Accept-Encoding", compression);
+}
+
+void Connection::flushInsertBatches() {
+    for (auto & handle_statement : statements) {
+        handle_statement.second->flushInsertBatch();
+    }
 }
 
 void Connection::resetConfiguration() {
@@ -152,6 +597,28 @@ void Connection::resetConfiguration() {
     default_format.clear();
     database.clear();
     stringmaxlength = 0;
+    decode_threads = 0;
+    in_list_threshold = 0;
+    insert_batch_rows = 0;
+    insert_batch_bytes = 0;
+    insert_batch_timeout = 0;
+    request_compression.clear();
+    compress_min_size = 0;
+    compression.clear();
+    decompress_thread = false;
+    zero_copy_read = true;
+    pool_size = 0;
+    pool_idle_timeout = 0;
+    drain_limit = 0;
+    read_servers.clear();
+    write_servers.clear();
+    read_endpoints.clear();
+    write_endpoints.clear();
+    load_balancing.clear();
+    server_weights.clear();
+    failover_cooldown = 0;
+    dns_cache_ttl = 0;
+    endpoints.clear();
 }
 
 void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_value_map_t & dsn_fields) {
@@ -199,7 +666,8 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
             valid_value = (
                 value.empty() ||
                 Poco::UTF8::icompare(value, "http") == 0 ||
-                Poco::UTF8::icompare(value, "https") == 0
+                Poco::UTF8::icompare(value, "https") == 0 ||
+                Poco::UTF8::icompare(value, "native") == 0
             );
             if (valid_value) {
                 proto = value;
@@ -297,6 +765,178 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
                 stringmaxlength = typed_value;
             }
         }
+        else if (Poco::UTF8::icompare(key, INI_DECODETHREADS) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || (
+                Poco::NumberParser::tryParseUnsigned(value, typed_value) &&
+                typed_value <= 256
+            ));
+            if (valid_value) {
+                decode_threads = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_INLISTTHRESHOLD) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                in_list_threshold = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_INSERTBATCHROWS) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                insert_batch_rows = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_INSERTBATCHBYTES) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                insert_batch_bytes = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_INSERTBATCHTIMEOUT) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                insert_batch_timeout = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_REQUESTCOMPRESSION) == 0) {
+            recognized_key = true;
+            valid_value = (
+                value.empty() ||
+                Poco::UTF8::icompare(value, "none") == 0 ||
+                Poco::UTF8::icompare(value, "gzip") == 0 ||
+                Poco::UTF8::icompare(value, "deflate") == 0
+            );
+            if (valid_value) {
+                request_compression = (Poco::UTF8::icompare(value, "none") == 0 ? std::string{} : Poco::UTF8::toLower(value));
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_COMPRESSMINSIZE) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                compress_min_size = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_COMPRESSION) == 0) {
+            recognized_key = true;
+            valid_value = (
+                value.empty() ||
+                Poco::UTF8::icompare(value, "none") == 0 ||
+                Poco::UTF8::icompare(value, "gzip") == 0 ||
+                Poco::UTF8::icompare(value, "deflate") == 0 ||
+                Poco::UTF8::icompare(value, "lz4") == 0
+            );
+            if (valid_value) {
+                compression = (Poco::UTF8::icompare(value, "none") == 0 ? std::string{} : Poco::UTF8::toLower(value));
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_DECOMPRESSTHREAD) == 0) {
+            recognized_key = true;
+            valid_value = (value.empty() || isYesOrNo(value));
+            if (valid_value) {
+                decompress_thread = isYes(value);
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_ZEROCOPYREAD) == 0) {
+            recognized_key = true;
+            valid_value = (value.empty() || isYesOrNo(value));
+            if (valid_value) {
+                zero_copy_read = (value.empty() || isYes(value));
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_READSERVERS) == 0) {
+            recognized_key = true;
+            valid_value = true;
+            if (valid_value) {
+                read_servers = value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_WRITESERVERS) == 0) {
+            recognized_key = true;
+            valid_value = true;
+            if (valid_value) {
+                write_servers = value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_LOADBALANCING) == 0) {
+            recognized_key = true;
+            valid_value = (
+                value.empty() ||
+                Poco::UTF8::icompare(value, "round_robin") == 0 ||
+                Poco::UTF8::icompare(value, "least_outstanding") == 0 ||
+                Poco::UTF8::icompare(value, "random") == 0
+            );
+            if (valid_value) {
+                load_balancing = Poco::UTF8::toLower(value);
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_SERVERWEIGHTS) == 0) {
+            recognized_key = true;
+            valid_value = true;
+            std::vector<std::uint32_t> typed_values;
+            for (const auto & item : Poco::StringTokenizer(value, ",", Poco::StringTokenizer::TOK_TRIM)) {
+                unsigned int typed_value = 0;
+                if (!Poco::NumberParser::tryParseUnsigned(item, typed_value) || typed_value == 0) {
+                    valid_value = false;
+                    break;
+                }
+                typed_values.push_back(typed_value);
+            }
+            if (valid_value) {
+                server_weights = std::move(typed_values);
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_FAILOVERCOOLDOWN) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                failover_cooldown = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_DNSCACHETTL) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                dns_cache_ttl = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_POOLSIZE) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                pool_size = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_POOLIDLETIMEOUT) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                pool_idle_timeout = typed_value;
+            }
+        }
+        else if (Poco::UTF8::icompare(key, INI_DRAINLIMIT) == 0) {
+            recognized_key = true;
+            unsigned int typed_value = 0;
+            valid_value = (value.empty() || Poco::NumberParser::tryParseUnsigned(value, typed_value));
+            if (valid_value) {
+                drain_limit = typed_value;
+            }
+        }
         else if (Poco::UTF8::icompare(key, INI_DRIVERLOGFILE) == 0) {
             recognized_key = true;
             valid_value = true;
@@ -366,7 +1006,9 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
         dsn = INI_DSN_DEFAULT;
 
     if (!url.empty()) {
-        Poco::URI uri(url);
+        auto single_server_url = url;
+        const auto url_servers = extractServerList(single_server_url);
+        Poco::URI uri(single_server_url);
 
         if (proto.empty())
             proto = uri.getScheme();
@@ -382,14 +1024,16 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
         }
 
         if (server.empty())
-            server = uri.getHost();
+            server = (url_servers.empty() ? uri.getHost() : url_servers);
 
-        if (port == 0) {
+        // The ports of the listed servers are a part of the list.
+        if (port == 0 && url_servers.empty()) {
             // TODO(dakovalkov): This doesn't work when you explicitly set 80 for http and 443 for https due to Poco's getPort() behavior.
             const auto tmp_port = uri.getPort();
             if (
                 (Poco::UTF8::icompare(proto, "https") == 0 && tmp_port != 443) ||
-                (Poco::UTF8::icompare(proto, "http") == 0 && tmp_port != 80)
+                (Poco::UTF8::icompare(proto, "http") == 0 && tmp_port != 80) ||
+                (Poco::UTF8::icompare(proto, "native") == 0 && tmp_port != 0)
             )
                 port = tmp_port;
         }
@@ -421,7 +1065,18 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
         server = "localhost";
 
     if (port == 0)
-        port = (Poco::UTF8::icompare(proto, "https") == 0 ? 8443 : 8123);
+        port = (isNativeProtocol() ? 9000 : Poco::UTF8::icompare(proto, "https") == 0 ? 8443 : 8123);
+
+    if (isNativeProtocol()) {
+        if (!sslmode.empty())
+            throw std::runtime_error("SSLMode is not supported with the native protocol");
+
+        if (!compression.empty() && compression != "lz4")
+            throw std::runtime_error("Only lz4 compression is supported with the native protocol");
+    }
+    else if (compression == "lz4") {
+        throw std::runtime_error("lz4 compression is supported with the native protocol only");
+    }
 
     if (timeout == 0)
         timeout = 30;
@@ -443,6 +1098,66 @@ void Connection::setConfiguration(const key_value_map_t & cs_fields, const key_v
 
     if (stringmaxlength == 0)
         stringmaxlength = TypeInfo::string_max_size;
+
+    if (decode_threads == 0)
+        decode_threads = 1;
+
+    if (insert_batch_bytes == 0)
+        insert_batch_bytes = 16 * 1024 * 1024;
+
+    if (insert_batch_timeout == 0)
+        insert_batch_timeout = 5;
+
+    if (compress_min_size == 0)
+        compress_min_size = 64 * 1024;
+
+    // Pooling, when enabled for the environment, but not configured for the connection.
+    if (pool_size == 0 && getParent().connection_pooling != SQL_CP_OFF)
+        pool_size = 8;
+
+    if (pool_idle_timeout == 0)
+        pool_idle_timeout = 10; // The default keep_alive_timeout of the server.
+
+    if (drain_limit == 0)
+        drain_limit = 1024 * 1024;
+
+    endpoints = parseEndpoints(server, port);
+    if (endpoints.empty())
+        throw std::runtime_error("No servers to connect to");
+
+    if (!server_weights.empty()) {
+        if (server_weights.size() != endpoints.size())
+            throw std::runtime_error("The number of server weights does not match the number of servers");
+
+        for (std::size_t i = 0; i < endpoints.size(); ++i) {
+            endpoints[i].weight = server_weights[i];
+        }
+    }
+
+    // The weights are for the servers of the main list only.
+    read_endpoints = parseEndpoints(read_servers, port);
+    write_endpoints = parseEndpoints(write_servers, port);
+
+    if (load_balancing.empty())
+        load_balancing = "round_robin";
+
+    if (failover_cooldown == 0)
+        failover_cooldown = 30;
+
+    if (dns_cache_ttl == 0)
+        dns_cache_ttl = 60;
+}
+
+std::string Connection::buildSessionPoolKey(const std::string & host, std::uint16_t port) const {
+    // The credentials and the timeouts are not a part of the state of a session, so the sessions are shared regardless of them.
+    std::ostringstream key;
+    key << Poco::UTF8::toLower(proto) << "://" << host << ":" << port
+        << "\n" << sslmode << "\n" << privateKeyFile << "\n" << certificateFile << "\n" << caLocation;
+
+    if (getParent().connection_pooling == SQL_CP_ONE_PER_HENV)
+        key << "\n" << getParent().getHandle();
+
+    return key.str();
 }
 
 std::string Connection::buildCredentialsString() const {
@@ -464,6 +1179,42 @@ std::string Connection::buildUserAgentString() const {
     return user_agent.str();
 }
 
+Poco::URI Connection::buildURI() const {
+    auto single_server_url = url;
+    extractServerList(single_server_url);
+    Poco::URI uri(single_server_url);
+
+    // Only the path and the query of the URI are used in the requests, while the server is chosen for each of them.
+    if (!endpoints.empty()) {
+        uri.setHost(endpoints.front().host);
+        uri.setPort(endpoints.front().port);
+    }
+
+    bool database_set = false;
+    bool default_format_set = false;
+
+    for (const auto& parameter : uri.getQueryParameters()) {
+        if (Poco::UTF8::icompare(parameter.first, "default_format") == 0) {
+            default_format_set = true;
+        }
+        else if (Poco::UTF8::icompare(parameter.first, "database") == 0) {
+            database_set = true;
+        }
+    }
+
+    if (!default_format_set)
+        uri.addQueryParameter("default_format", default_format);
+
+    if (!database_set)
+        uri.addQueryParameter("database", database);
+
+    // The server compresses the response only if it is also accepted by the request, see requestCompressedResponse().
+    if (!compression.empty())
+        uri.addQueryParameter("enable_http_compression", "1");
+
+    return uri;
+}
+
 void Connection::initAsAD(Descriptor & desc, bool user) {
     desc.resetAttrs();
     desc.setAttr(SQL_DESC_ALLOC_TYPE, (user ? SQL_DESC_ALLOC_USER : SQL_DESC_ALLOC_AUTO));
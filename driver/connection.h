@@ -3,11 +3,18 @@
 #include "driver/driver.h"
 #include "driver/environment.h"
 #include "driver/config/config.h"
+#include "driver/utils/load_balancer.h"
+#include "driver/utils/native_session.h"
+#include "driver/utils/query_template.h"
 
 #include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPRequest.h>
+#include <Poco/URI.h>
 
+#include <atomic>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 class DescriptorRecord;
 class Descriptor;
@@ -37,25 +44,88 @@ public: // Configuration fields.
     std::string default_format;
     std::string database;
     std::int32_t stringmaxlength = 0;
+    std::uint32_t decode_threads = 0;
+    std::uint32_t in_list_threshold = 0;
+    std::uint32_t insert_batch_rows = 0;
+    std::uint32_t insert_batch_bytes = 0;
+    std::uint32_t insert_batch_timeout = 0;
+    std::string request_compression;
+    std::uint32_t compress_min_size = 0;
+    std::string compression;
+    bool decompress_thread = false;
+    bool zero_copy_read = true;
+    std::uint32_t pool_size = 0;
+    std::uint32_t pool_idle_timeout = 0;
+    std::uint32_t drain_limit = 0;
+    std::string read_servers;
+    std::string write_servers;
+    std::string load_balancing;
+    std::vector<std::uint32_t> server_weights;
+    std::uint32_t failover_cooldown = 0;
+    std::uint32_t dns_cache_ttl = 0;
+    std::vector<Endpoint> endpoints; // Parsed from the list in 'server', or in 'url'.
+    std::vector<Endpoint> read_endpoints; // Parsed from 'read_servers', empty if the reads are sent to 'endpoints'.
+    std::vector<Endpoint> write_endpoints; // Parsed from 'write_servers', empty if the writes are sent to 'endpoints'.
 
 public:
     std::string useragent;
 
-    std::unique_ptr<Poco::Net::HTTPClientSession> session;
+    std::unique_ptr<Poco::Net::HTTPClientSession> session; // The idle session established by connect(), while no statement borrows it.
     int retry_count = 3;
     int redirect_limit = 10;
+    std::atomic<std::uint64_t> drained_response_count{0}; // The number of abandoned responses, that were drained to keep their sessions.
 
 public:
     explicit Connection(Environment & environment);
 
     void connect(const std::string & connection_string);
 
+    // Close the cursors of all statements and release the session to the pool, if pooling is enabled, or reset it otherwise.
+    void disconnect();
+
     // Return a Base64 encoded string of "user:password".
     std::string buildCredentialsString() const;
 
     // Return a crafted User-Agent string.
     std::string buildUserAgentString() const;
 
+    // Return the URI of the server, with the common query parameters (database, default_format) set.
+    Poco::URI buildURI() const;
+
+    // Create a new HTTP(S) session to the server, configured according to the connection settings.
+    std::unique_ptr<Poco::Net::HTTPClientSession> createSession(const Endpoint & endpoint) const;
+
+    // Take an idle session of the connection, or a new one, for the exclusive use by a statement, until it is returned.
+    // The server is chosen by the load balancer of the servers for the kind of the query, failing over to the next one, if connecting to it fails.
+    std::unique_ptr<Poco::Net::HTTPClientSession> borrowSession(QueryKind query_kind = QueryKind::Other);
+
+    // Return the borrowed session, that is not used anymore, for reuse by the other statements.
+    void returnSession(std::unique_ptr<Poco::Net::HTTPClientSession> && session);
+
+    // Stop sending the requests to the server of the borrowed session, until it recovers.
+    void reportSessionFailure(const Poco::Net::HTTPClientSession & session);
+
+    // Indicates whether the statements send the queries over the native TCP protocol (Proto=native), instead of HTTP(S).
+    bool isNativeProtocol() const;
+
+    // The same as borrowSession(), but for the native protocol, the session is connected and authenticated, when borrowed.
+    std::unique_ptr<NativeSession> borrowNativeSession(QueryKind query_kind = QueryKind::Other);
+
+    // Return the borrowed native session, that is kept for reuse, if the results of its last query have been received to the end.
+    void returnNativeSession(std::unique_ptr<NativeSession> && session);
+
+    // Ask the server to kill the query, sending the request in a separate short-lived session to the server.
+    void killQuery(const std::string & query_id, const Endpoint & endpoint) const;
+
+    // Return the Content-Encoding to compress a request body of the given size with, or an empty string, if it is sent as is.
+    std::string getRequestEncoding(std::size_t body_size) const;
+
+    // Ask the server to compress the response to the request, if configured so.
+    void requestCompressedResponse(Poco::Net::HTTPRequest & request) const;
+
+    // Send the rows of single-row INSERTs, that are still buffered by the statements of this connection.
+    void flushInsertBatches();
+
     // Reset the descriptor and initialize it with default attributes.
     void initAsAD(Descriptor & desc, bool user = false); // as Application Descriptor
     void initAsID(Descriptor & desc); // as Implementation Descriptor
@@ -84,7 +154,38 @@ private:
     //     c) values deduced from values of other fields, if unintialized.
     void setConfiguration(const key_value_map_t & cs_fields, const key_value_map_t & dsn_fields);
 
+    // Return the key of the sessions in the pool, that are interchangeable with the sessions of this connection to the server.
+    std::string buildSessionPoolKey(const std::string & host, std::uint16_t port) const;
+
+    // Return the load balancer of the servers, that is shared with the other connections with the same settings.
+    std::shared_ptr<LoadBalancer> getSharedLoadBalancer(const std::vector<Endpoint> & balanced_endpoints) const;
+
+    // Return the load balancer of the servers, that the queries of the kind are sent to.
+    std::shared_ptr<LoadBalancer> getLoadBalancer(QueryKind query_kind) const;
+
+    // Connect the session to the server, trying all of its addresses.
+    void connectSession(Poco::Net::HTTPClientSession & session, const Endpoint & endpoint) const;
+    void connectToAnyAddress(AddressConnectable & connectable, const Endpoint & endpoint) const;
+
+    // Connect the native session to the server, and introduce the client to it, with the credentials of the connection.
+    void connectNativeSession(NativeSession & session, const Endpoint & endpoint) const;
+
 private:
+    // The statements of the connection may be used from several threads, each with a session of its own.
+    std::mutex session_mutex;
+    std::vector<std::unique_ptr<Poco::Net::HTTPClientSession>> idle_sessions; // Returned by the statements, in addition to 'session'.
+    struct BorrowedSession {
+        std::shared_ptr<LoadBalancer> balancer;
+        std::size_t endpoint_idx = 0;
+    };
+
+    std::unordered_map<const Poco::Net::HTTPClientSession *, BorrowedSession> borrowed_sessions;
+    std::vector<std::unique_ptr<NativeSession>> idle_native_sessions; // Used instead of the HTTP(S) sessions, if Proto=native.
+    std::unordered_map<const NativeSession *, BorrowedSession> borrowed_native_sessions;
+    std::shared_ptr<LoadBalancer> load_balancer; // Set while connected.
+    std::shared_ptr<LoadBalancer> read_load_balancer; // Set while connected, if the reads have servers of their own.
+    std::shared_ptr<LoadBalancer> write_load_balancer; // Set while connected, if the writes have servers of their own.
+
     std::unordered_map<SQLHANDLE, std::shared_ptr<Descriptor>> descriptors;
     std::unordered_map<SQLHANDLE, std::shared_ptr<Statement>> statements;
 };
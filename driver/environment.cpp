@@ -30,6 +30,12 @@ const TypeInfo & Environment::getTypeInfo(const std::string & type_name, const s
     throw SqlException("Invalid SQL data type", "HY004");
 }
 
+void Environment::flushInsertBatches() {
+    for (auto & handle_connection : connections) {
+        handle_connection.second->flushInsertBatches();
+    }
+}
+
 template <>
 Connection& Environment::allocateChild<Connection>() {
     auto child_sptr = std::make_shared<Connection>(*this);
@@ -22,6 +22,9 @@ public:
 
     const TypeInfo & getTypeInfo(const std::string & type_name, const std::string & type_name_without_parameters = "") const;
 
+    // Send the rows of single-row INSERTs, that are still buffered by the statements of all connections.
+    void flushInsertBatches();
+
 public:
 #if defined(SQL_OV_ODBC3_80)
     int odbc_version = SQL_OV_ODBC3_80;
@@ -29,6 +32,10 @@ public:
     int odbc_version = SQL_OV_ODBC3;
 #endif
 
+    // Enables the pooling of the sessions of the connections (see SessionPool), unless configured otherwise by their PoolSize.
+    SQLUINTEGER connection_pooling = SQL_CP_OFF;
+    SQLUINTEGER cp_match = SQL_CP_STRICT_MATCH;
+
 private:
     std::unordered_map<SQLHANDLE, std::shared_ptr<Connection>> connections;
 };
@@ -0,0 +1,184 @@
+#include "driver/format/NativeWriter.h"
+
+namespace {
+
+    template <typename T> constexpr SQLSMALLINT getNativeCTypeFor(); // Leave unimplemented for general case.
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int8_t   >() { return SQL_C_STINYINT; }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int16_t  >() { return SQL_C_SSHORT;   }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int32_t  >() { return SQL_C_SLONG;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int64_t  >() { return SQL_C_SBIGINT;  }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint8_t  >() { return SQL_C_UTINYINT; }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint16_t >() { return SQL_C_USHORT;   }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint32_t >() { return SQL_C_ULONG;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint64_t >() { return SQL_C_UBIGINT;  }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< float         >() { return SQL_C_FLOAT;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< double        >() { return SQL_C_DOUBLE;   }
+
+    void writeULEB128(std::string & dest, std::uint64_t value) {
+        do {
+            std::uint8_t byte = value & 0b01111111;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0b10000000;
+            dest.push_back(static_cast<char>(byte));
+        } while (value != 0);
+    }
+
+    void writeString(std::string & dest, const std::string & value) {
+        writeULEB128(dest, value.size());
+        dest.append(value);
+    }
+
+    // Get the binding info that points to the specified element of a column-wise bound array.
+    BindingInfo getElementBindingInfo(const BindingInfo & column_binding, std::size_t row_idx) {
+        const auto octet_length = getCTypeOctetLength(column_binding.c_type);
+        const auto value_stride = (octet_length > 0 ? octet_length : static_cast<std::size_t>(column_binding.value_max_size));
+
+        BindingInfo binding_info = column_binding;
+        binding_info.value = (void *)(column_binding.value ? ((char *)(column_binding.value) + row_idx * value_stride) : 0);
+        binding_info.value_size = (column_binding.value_size ? column_binding.value_size + row_idx : 0);
+        binding_info.indicator = (column_binding.indicator ? column_binding.indicator + row_idx : 0);
+
+        return binding_info;
+    }
+
+    bool isNull(const BindingInfo & binding_info) {
+        return (
+            binding_info.value == nullptr ||
+            (binding_info.indicator && (*binding_info.indicator == SQL_NULL_DATA || *binding_info.indicator == SQL_DEFAULT_PARAM))
+        );
+    }
+
+} // namespace
+
+NativeWriter::NativeWriter(const std::vector<ColumnInfo> & columns_info) {
+    columns.reserve(columns_info.size());
+
+    for (const auto & column_info : columns_info) {
+        Column column;
+        column.name = column_info.name;
+
+        switch (column_info.type_without_parameters_id) {
+            case DataSourceTypeId::Int8:    column.wire_type = WireType::Int8;    break;
+            case DataSourceTypeId::Int16:   column.wire_type = WireType::Int16;   break;
+            case DataSourceTypeId::Int32:   column.wire_type = WireType::Int32;   break;
+            case DataSourceTypeId::Int64:   column.wire_type = WireType::Int64;   break;
+            case DataSourceTypeId::UInt8:   column.wire_type = WireType::UInt8;   break;
+            case DataSourceTypeId::UInt16:  column.wire_type = WireType::UInt16;  break;
+            case DataSourceTypeId::UInt32:  column.wire_type = WireType::UInt32;  break;
+            case DataSourceTypeId::UInt64:  column.wire_type = WireType::UInt64;  break;
+            case DataSourceTypeId::Float32: column.wire_type = WireType::Float32; break;
+            case DataSourceTypeId::Float64: column.wire_type = WireType::Float64; break;
+            default:                        column.wire_type = WireType::String;  break;
+        }
+
+        columns.emplace_back(std::move(column));
+    }
+}
+
+std::string NativeWriter::getStructure() const {
+    std::string structure;
+
+    for (const auto & column : columns) {
+        if (!structure.empty())
+            structure += ", ";
+
+        structure += '`' + escapeForSQL(column.name) + "` " + getTypeName(column.wire_type);
+    }
+
+    return structure;
+}
+
+std::string NativeWriter::getTypeName(WireType wire_type) {
+    switch (wire_type) {
+        case WireType::Int8:    return "Nullable(Int8)";
+        case WireType::Int16:   return "Nullable(Int16)";
+        case WireType::Int32:   return "Nullable(Int32)";
+        case WireType::Int64:   return "Nullable(Int64)";
+        case WireType::UInt8:   return "Nullable(UInt8)";
+        case WireType::UInt16:  return "Nullable(UInt16)";
+        case WireType::UInt32:  return "Nullable(UInt32)";
+        case WireType::UInt64:  return "Nullable(UInt64)";
+        case WireType::Float32: return "Nullable(Float32)";
+        case WireType::Float64: return "Nullable(Float64)";
+        case WireType::String:  return "Nullable(String)";
+    }
+
+    throw std::runtime_error("Unexpected wire type");
+}
+
+void NativeWriter::writeBlock(const std::vector<BindingInfo> & column_bindings, std::size_t first_row, std::size_t row_count, std::string & dest) {
+    if (column_bindings.size() != columns.size())
+        throw std::runtime_error("Unexpected number of columns in a block");
+
+    writeULEB128(dest, columns.size());
+    writeULEB128(dest, row_count);
+
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        writeColumn(columns[i], column_bindings[i], first_row, row_count, dest);
+    }
+}
+
+void NativeWriter::writeColumn(const Column & column, const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest) {
+    writeString(dest, column.name);
+    writeString(dest, getTypeName(column.wire_type));
+
+    // Null map, followed by the values of the nested column, where the values of NULL elements are irrelevant.
+    null_map.assign(row_count, false);
+    dest.reserve(dest.size() + row_count);
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        null_map[i] = isNull(getElementBindingInfo(column_binding, first_row + i));
+        dest.push_back(null_map[i] ? 1 : 0);
+    }
+
+    switch (column.wire_type) {
+        case WireType::Int8:    return writeNumbers< std::int8_t   >(column_binding, first_row, row_count, dest);
+        case WireType::Int16:   return writeNumbers< std::int16_t  >(column_binding, first_row, row_count, dest);
+        case WireType::Int32:   return writeNumbers< std::int32_t  >(column_binding, first_row, row_count, dest);
+        case WireType::Int64:   return writeNumbers< std::int64_t  >(column_binding, first_row, row_count, dest);
+        case WireType::UInt8:   return writeNumbers< std::uint8_t  >(column_binding, first_row, row_count, dest);
+        case WireType::UInt16:  return writeNumbers< std::uint16_t >(column_binding, first_row, row_count, dest);
+        case WireType::UInt32:  return writeNumbers< std::uint32_t >(column_binding, first_row, row_count, dest);
+        case WireType::UInt64:  return writeNumbers< std::uint64_t >(column_binding, first_row, row_count, dest);
+        case WireType::Float32: return writeNumbers< float         >(column_binding, first_row, row_count, dest);
+        case WireType::Float64: return writeNumbers< double        >(column_binding, first_row, row_count, dest);
+        case WireType::String:  return writeStrings(column_binding, first_row, row_count, dest);
+    }
+}
+
+template <typename T>
+void NativeWriter::writeNumbers(const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest) {
+    const auto offset = dest.size();
+    dest.resize(offset + row_count * sizeof(T));
+
+    // Copy the whole array at once, if the application buffer already holds the values in the native representation.
+    if (column_binding.c_type == getNativeCTypeFor<T>() && column_binding.value) {
+        std::memcpy(&dest[offset], static_cast<const T *>(column_binding.value) + first_row, row_count * sizeof(T));
+        return;
+    }
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        if (null_map[i])
+            continue;
+
+        T value = 0;
+
+        readReadyDataTo(getElementBindingInfo(column_binding, first_row + i), tmp_value);
+        value_manip::from_value<std::string>::template to_value<T>::convert(tmp_value, value);
+
+        std::memcpy(&dest[offset + i * sizeof(T)], &value, sizeof(T));
+    }
+}
+
+void NativeWriter::writeStrings(const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest) {
+    for (std::size_t i = 0; i < row_count; ++i) {
+        if (null_map[i]) {
+            writeULEB128(dest, 0);
+            continue;
+        }
+
+        readReadyDataTo(getElementBindingInfo(column_binding, first_row + i), tmp_value);
+        writeString(dest, tmp_value);
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "driver/platform/platform.h"
+#include "driver/result_set.h"
+
+#include <string>
+#include <vector>
+
+// Encoder of values from column-wise bound application arrays into blocks of Native wire format of ClickHouse,
+// for sending them in INSERT queries. Integer and floating-point columns are encoded natively, all other columns
+// are encoded as strings, and are expected to be converted to the actual column types by the server, e.g., by using
+// input() table function with getStructure(). All columns are encoded as Nullable, NULLs are marked in their null maps.
+class NativeWriter {
+public:
+    explicit NativeWriter(const std::vector<ColumnInfo> & columns_info);
+
+    // Structure of the encoded blocks, in a form accepted by input() table function, e.g., "`a` Nullable(Int32), `b` Nullable(String)".
+    std::string getStructure() const;
+
+    // Encode a block of row_count consecutive rows, starting from first_row, and append it to dest. Each binding info
+    // describes the first element of a column-wise bound array, where value_max_size is the size of an element of the
+    // value array for character and binary types, and the elements of the indicator array are SQLLEN's.
+    void writeBlock(const std::vector<BindingInfo> & column_bindings, std::size_t first_row, std::size_t row_count, std::string & dest);
+
+private:
+    enum class WireType {
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        String
+    };
+
+    struct Column {
+        std::string name;
+        WireType wire_type = WireType::String;
+    };
+
+    static std::string getTypeName(WireType wire_type);
+
+    void writeColumn(const Column & column, const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest);
+
+    template <typename T>
+    void writeNumbers(const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest);
+
+    void writeStrings(const BindingInfo & column_binding, std::size_t first_row, std::size_t row_count, std::string & dest);
+
+private:
+    std::vector<Column> columns;
+    std::vector<bool> null_map;
+    std::string tmp_value;
+};
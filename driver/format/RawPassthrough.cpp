@@ -0,0 +1,98 @@
+#include "driver/format/RawPassthrough.h"
+
+namespace {
+
+    // The raw response data is not of any type of the server, and is described as binary data of unknown length.
+    const TypeInfo raw_data_type_info {"LONGVARBINARY", true, SQL_LONGVARBINARY, TypeInfo::string_max_size, TypeInfo::string_max_size};
+
+} // namespace
+
+RawPassthroughResultSet::RawPassthroughResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator)
+    : ResultSet(stream, std::move(mutator))
+{
+    columns_info.emplace_back();
+
+    auto & column_info = columns_info.back();
+    column_info.name = "raw_data";
+    column_info.type = "String"; // Stored as String, while described as SQL_LONGVARBINARY.
+    column_info.type_without_parameters = "String";
+    column_info.updateTypeInfo();
+    column_info.type_info = &raw_data_type_info;
+}
+
+bool RawPassthroughResultSet::supportsBoundColumns() const {
+    // Reading a bound column would consume the stream, that is meant to be read in pieces by SQLGetData().
+    return false;
+}
+
+bool RawPassthroughResultSet::readNextRow(Row & row) {
+    if (row_read)
+        return false;
+
+    // The actual data is never stored in the row, and is read directly from the stream by extractField() instead.
+    row.fields[0].data = DataSourceType<DataSourceTypeId::String>{};
+    row_read = true;
+
+    return true;
+}
+
+SQLRETURN RawPassthroughResultSet::extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info) {
+    if (row_idx >= row_set.size())
+        throw SqlException("Invalid cursor position", "HY109");
+
+    if (column_idx >= columns_info.size())
+        throw SqlException("Invalid descriptor index", "07009");
+
+    if (binding_info.c_type != SQL_C_BINARY && binding_info.c_type != SQL_C_DEFAULT)
+        throw SqlException("Restricted data type attribute violation", "07006");
+
+    if (data_exhausted)
+        return SQL_NO_DATA;
+
+    if (!binding_info.value || binding_info.value_max_size <= 0)
+        throw SqlException("Invalid string or buffer length", "HY090");
+
+    const auto max_size = static_cast<std::size_t>(binding_info.value_max_size);
+    const auto [data, size] = stream.peek(max_size);
+    const auto piece_size = std::min(size, max_size);
+
+    std::memcpy(binding_info.value, data, piece_size);
+    stream.read(nullptr, piece_size);
+
+    if (stream.eof()) {
+        data_exhausted = true;
+
+        if (binding_info.value_size)
+            *binding_info.value_size = piece_size;
+
+        if (binding_info.indicator && binding_info.indicator != binding_info.value_size)
+            *binding_info.indicator = piece_size;
+
+        return SQL_SUCCESS;
+    }
+
+    if (binding_info.value_size)
+        *binding_info.value_size = SQL_NO_TOTAL;
+
+    if (binding_info.indicator && binding_info.indicator != binding_info.value_size)
+        *binding_info.indicator = SQL_NO_TOTAL;
+
+    throw SqlException("String data, right truncated", "01004", SQL_SUCCESS_WITH_INFO);
+}
+
+RawPassthroughResultReader::RawPassthroughResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator)
+    : ResultReader(raw_stream, std::move(mutator))
+{
+    result_set = std::make_unique<RawPassthroughResultSet>(stream, releaseMutator());
+}
+
+bool RawPassthroughResultReader::advanceToNextResultSet() {
+    // The response body is exposed as a single result set, so only a basic cleanup is done here.
+
+    if (result_set) {
+        result_mutator = result_set->releaseMutator();
+        result_set.reset();
+    }
+
+    return hasResultSet();
+}
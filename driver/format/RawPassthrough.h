@@ -0,0 +1,34 @@
+#pragma once
+
+#include "driver/platform/platform.h"
+#include "driver/result_set.h"
+
+// Implementation of ResultSet that exposes the response body as is, in whatever format it is, without decoding it.
+// The result set consists of a single row with a single binary column, which is meant to be read in pieces by SQLGetData().
+class RawPassthroughResultSet
+    : public ResultSet
+{
+public:
+    explicit RawPassthroughResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator);
+    virtual ~RawPassthroughResultSet() override = default;
+
+    virtual bool supportsBoundColumns() const override;
+    virtual SQLRETURN extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info) override;
+
+protected:
+    virtual bool readNextRow(Row & row) override;
+
+private:
+    bool row_read = false;
+    bool data_exhausted = false;
+};
+
+class RawPassthroughResultReader
+    : public ResultReader
+{
+public:
+    explicit RawPassthroughResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator);
+    virtual ~RawPassthroughResultReader() override = default;
+
+    virtual bool advanceToNextResultSet() override;
+};
@@ -1,9 +1,33 @@
 #include "driver/format/RowBinaryWithNamesAndTypes.h"
+#include "driver/utils/thread_pool.h"
+
+#include <Poco/MemoryStream.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
 
 #include <ctime>
 
-RowBinaryWithNamesAndTypesResultSet::RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator)
+namespace {
+
+    // Limits of a single chunk of rows handed over to a worker thread.
+    constexpr std::size_t max_rows_per_chunk = 256;
+    constexpr std::size_t max_bytes_per_chunk = 1 << 18; // 256 KB
+
+    // The process-wide pool of the threads, that decode the chunks, so that they are reused, instead of being started for each chunk.
+    // Decoding is CPU-bound, so there is no point in having more threads than cores. The pool is never destroyed, for the same reasons
+    // as the one returned by ThreadPool::getInstance().
+    ThreadPool & getDecodingPool() {
+        static auto * instance = new ThreadPool(std::max(1u, std::thread::hardware_concurrency()), std::chrono::seconds(60));
+        return *instance;
+    }
+
+} // namespace
+
+RowBinaryWithNamesAndTypesResultSet::RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads)
     : ResultSet(stream, std::move(mutator))
+    , decode_threads(decode_threads)
 {
     std::uint64_t num_columns = 0;
     readSize(num_columns);
@@ -34,7 +58,26 @@ RowBinaryWithNamesAndTypesResultSet::RowBinaryWithNamesAndTypesResultSet(Amortiz
     finished = columns_info.empty();
 }
 
+RowBinaryWithNamesAndTypesResultSet::RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::vector<ColumnInfo> && columns_info)
+    : ResultSet(stream, std::unique_ptr<ResultMutator>{})
+    , decode_threads(1)
+{
+    this->columns_info = std::move(columns_info);
+    finished = this->columns_info.empty();
+}
+
+RowBinaryWithNamesAndTypesResultSet::~RowBinaryWithNamesAndTypesResultSet() {
+    // Wait for all the workers, ignoring their outcomes.
+    for (auto & chunk : chunks_in_flight) {
+        if (chunk.valid())
+            chunk.wait();
+    }
+}
+
 bool RowBinaryWithNamesAndTypesResultSet::readNextRow(Row & row) {
+    if (decode_threads > 1)
+        return readNextRowParallel(row);
+
     if (stream.eof())
         return false;
 
@@ -45,6 +88,251 @@ bool RowBinaryWithNamesAndTypesResultSet::readNextRow(Row & row) {
     return true;
 }
 
+bool RowBinaryWithNamesAndTypesResultSet::readNextRowParallel(Row & row) {
+    while (current_chunk.rows.empty()) {
+        while (!input_exhausted && chunks_in_flight.size() < decode_threads) {
+            scheduleNextChunk();
+        }
+
+        if (chunks_in_flight.empty())
+            return false;
+
+        // Chunks are consumed strictly in the order they were cut from the stream. This rethrows worker's exceptions, if any.
+        current_chunk = chunks_in_flight.front().get();
+        chunks_in_flight.pop_front();
+
+        for (std::size_t i = 0; i < columns_info.size() && i < current_chunk.display_sizes_so_far.size(); ++i) {
+            if (columns_info[i].display_size_so_far < current_chunk.display_sizes_so_far[i])
+                columns_info[i].display_size_so_far = current_chunk.display_sizes_so_far[i];
+        }
+
+        // Keep the workers busy while the current chunk is being consumed.
+        while (!input_exhausted && chunks_in_flight.size() < decode_threads) {
+            scheduleNextChunk();
+        }
+    }
+
+    std::swap(row, current_chunk.rows.front());
+    retireRow(std::move(current_chunk.rows.front()));
+    current_chunk.rows.pop_front();
+
+    return true;
+}
+
+void RowBinaryWithNamesAndTypesResultSet::scheduleNextChunk() {
+    std::string data;
+    std::size_t row_count = 0;
+
+    while (row_count < max_rows_per_chunk && data.size() < max_bytes_per_chunk) {
+        if (stream.eof()) {
+            input_exhausted = true;
+            break;
+        }
+
+        auto [buffer, buffer_size] = stream.peek();
+
+        std::size_t offset = 0;
+        std::size_t row_size = 0;
+
+        while (
+            row_count < max_rows_per_chunk &&
+            data.size() + offset < max_bytes_per_chunk &&
+            tryScanRow(buffer + offset, buffer_size - offset, row_size)
+        ) {
+            offset += row_size;
+            ++row_count;
+        }
+
+        if (offset == 0) {
+            // The next row is not entirely buffered yet, so try to buffer more data.
+            const auto prev_buffer_size = buffer_size;
+            std::tie(buffer, buffer_size) = stream.peek(buffer_size * 2);
+
+            if (buffer_size <= prev_buffer_size)
+                throw std::runtime_error("Incomplete input stream, expected at least 1 more complete row");
+
+            continue;
+        }
+
+        data.append(buffer, offset);
+        stream.read(nullptr, offset);
+    }
+
+    if (row_count == 0)
+        return;
+
+    // Retired rows and their strings are recycled here, so hand them over to the worker, instead of letting the pools grow.
+    std::vector<Row> spare_rows;
+    while (!row_pool.empty() && spare_rows.size() < row_count) {
+        spare_rows.emplace_back(row_pool.get());
+    }
+
+    std::vector<std::string> spare_strings;
+    while (!string_pool.empty() && spare_strings.size() < row_count * columns_info.size()) {
+        spare_strings.emplace_back(string_pool.get());
+    }
+
+    // The structure of the result set is the same for all the chunks, so it is shared by them, instead of being copied for each one.
+    if (!shared_columns_info)
+        shared_columns_info = std::make_shared<const std::vector<ColumnInfo>>(columns_info);
+
+    // The task is shared, since the tasks of the pool must be copyable. If the pool drops it, the future reports a broken promise.
+    auto task = std::make_shared<std::packaged_task<DecodedChunk ()>>(
+        [data = std::move(data), row_count, columns_info = shared_columns_info, spare_rows = std::move(spare_rows), spare_strings = std::move(spare_strings)] () mutable {
+            return decodeChunk(data, row_count, *columns_info, std::move(spare_rows), std::move(spare_strings));
+        }
+    );
+
+    chunks_in_flight.emplace_back(task->get_future());
+    getDecodingPool().schedule([task] () { (*task)(); });
+}
+
+RowBinaryWithNamesAndTypesResultSet::DecodedChunk RowBinaryWithNamesAndTypesResultSet::decodeChunk(const std::string & data, std::size_t row_count, const std::vector<ColumnInfo> & columns_info,
+    std::vector<Row> spare_rows, std::vector<std::string> spare_strings
+) {
+    // The decoder updates the display sizes of its columns, so it gets the part of the shared column infos, that is needed for decoding,
+    // without the names and the types. The types of the columns are already checked to be supported, while the chunk was cut.
+    std::vector<ColumnInfo> decoder_columns_info(columns_info.size());
+    for (std::size_t i = 0; i < columns_info.size(); ++i) {
+        auto & column_info = decoder_columns_info[i];
+        column_info.type_without_parameters_id = columns_info[i].type_without_parameters_id;
+        column_info.fixed_size = columns_info[i].fixed_size;
+        column_info.precision = columns_info[i].precision;
+        column_info.scale = columns_info[i].scale;
+        column_info.is_nullable = columns_info[i].is_nullable;
+    }
+
+    Poco::MemoryInputStream raw_stream(data.data(), data.size());
+    AmortizedIStreamReader stream(raw_stream);
+    RowBinaryWithNamesAndTypesResultSet decoder(stream, std::move(decoder_columns_info));
+
+    for (auto & spare_string : spare_strings) {
+        decoder.string_pool.put(std::move(spare_string));
+    }
+
+    DecodedChunk chunk;
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        auto & row = chunk.rows.emplace_back();
+
+        if (!spare_rows.empty()) {
+            row = std::move(spare_rows.back());
+            spare_rows.pop_back();
+        }
+
+        row.fields.resize(decoder.columns_info.size());
+
+        if (!decoder.readNextRow(row))
+            throw std::runtime_error("Unable to decode a chunk of rows: unexpected end of data");
+    }
+
+    chunk.display_sizes_so_far.reserve(decoder.columns_info.size());
+    for (const auto & column_info : decoder.columns_info) {
+        chunk.display_sizes_so_far.push_back(column_info.display_size_so_far);
+    }
+
+    return chunk;
+}
+
+bool RowBinaryWithNamesAndTypesResultSet::tryScanRow(const char * data, std::size_t size, std::size_t & row_size) const {
+    std::size_t offset = 0;
+
+    for (const auto & column_info : columns_info) {
+        std::size_t value_size = 0;
+
+        if (!tryScanValue(data + offset, size - offset, value_size, column_info))
+            return false;
+
+        offset += value_size;
+    }
+
+    row_size = offset;
+    return true;
+}
+
+bool RowBinaryWithNamesAndTypesResultSet::tryScanValue(const char * data, std::size_t size, std::size_t & value_size, const ColumnInfo & column_info) const {
+    std::size_t offset = 0;
+
+    if (column_info.is_nullable) {
+        if (size < 1)
+            return false;
+
+        offset = 1;
+
+        if (data[0] != 0) {
+            value_size = offset;
+            return true;
+        }
+    }
+
+    std::size_t fixed_size = 0;
+
+    switch (column_info.type_without_parameters_id) {
+        case DataSourceTypeId::Nothing:     fixed_size = 0;  break;
+        case DataSourceTypeId::Int8:        fixed_size = 1;  break;
+        case DataSourceTypeId::UInt8:       fixed_size = 1;  break;
+        case DataSourceTypeId::Int16:       fixed_size = 2;  break;
+        case DataSourceTypeId::UInt16:      fixed_size = 2;  break;
+        case DataSourceTypeId::Date:        fixed_size = 2;  break;
+        case DataSourceTypeId::Int32:       fixed_size = 4;  break;
+        case DataSourceTypeId::UInt32:      fixed_size = 4;  break;
+        case DataSourceTypeId::Float32:     fixed_size = 4;  break;
+        case DataSourceTypeId::DateTime:    fixed_size = 4;  break;
+        case DataSourceTypeId::Int64:       fixed_size = 8;  break;
+        case DataSourceTypeId::UInt64:      fixed_size = 8;  break;
+        case DataSourceTypeId::Float64:     fixed_size = 8;  break;
+        case DataSourceTypeId::UUID:        fixed_size = 16; break;
+        case DataSourceTypeId::FixedString: fixed_size = column_info.fixed_size; break;
+
+        case DataSourceTypeId::Decimal:
+        case DataSourceTypeId::Decimal32:
+        case DataSourceTypeId::Decimal64:
+        case DataSourceTypeId::Decimal128: {
+            if (column_info.precision < 10)
+                fixed_size = 4;
+            else if (column_info.precision < 19)
+                fixed_size = 8;
+            else
+                throw std::runtime_error("Unable to decode value of type 'Decimal' that is represented by 128-bit integer");
+            break;
+        }
+
+        case DataSourceTypeId::String: {
+            // ULEB128 encoded size followed by the data.
+            std::uint64_t string_size = 0;
+            std::uint8_t shift = 0;
+
+            while (true) {
+                if (offset >= size)
+                    return false;
+
+                const auto byte = static_cast<std::uint8_t>(data[offset++]);
+                string_size |= (static_cast<std::uint64_t>(byte & 0b01111111) << shift);
+
+                if ((byte & 0b10000000) == 0)
+                    break;
+
+                shift += 7;
+
+                if (shift > 63)
+                    throw std::runtime_error("ULEB128 value too big");
+            }
+
+            fixed_size = string_size;
+            break;
+        }
+
+        default:
+            throw std::runtime_error("Unable to decode value of type '" + column_info.type + "'");
+    }
+
+    if (size - offset < fixed_size)
+        return false;
+
+    value_size = offset + fixed_size;
+    return true;
+}
+
 void RowBinaryWithNamesAndTypesResultSet::readSize(std::uint64_t & res) {
 
     // Read an ULEB128 encoded integer from the stream.
@@ -293,13 +581,13 @@ void RowBinaryWithNamesAndTypesResultSet::readValue(DataSourceType<DataSourceTyp
     std::copy(ptr, ptr + lengthof(dest.value.Data4), std::make_reverse_iterator(dest.value.Data4 + lengthof(dest.value.Data4)));
 }
 
-RowBinaryWithNamesAndTypesResultReader::RowBinaryWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator)
+RowBinaryWithNamesAndTypesResultReader::RowBinaryWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads)
     : ResultReader(raw_stream, std::move(mutator))
 {
     if (stream.eof())
         return;
 
-    result_set = std::make_unique<RowBinaryWithNamesAndTypesResultSet>(stream, releaseMutator());
+    result_set = std::make_unique<RowBinaryWithNamesAndTypesResultSet>(stream, releaseMutator(), decode_threads);
 }
 
 bool RowBinaryWithNamesAndTypesResultReader::advanceToNextResultSet() {
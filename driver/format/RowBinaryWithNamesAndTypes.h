@@ -3,18 +3,42 @@
 #include "driver/platform/platform.h"
 #include "driver/result_set.h"
 
+#include <future>
+
 // Implementation of ResultSet for RowBinaryWithNamesAndTypes wire format of ClickHouse.
 class RowBinaryWithNamesAndTypesResultSet
     : public ResultSet
 {
 public:
-    explicit RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator);
-    virtual ~RowBinaryWithNamesAndTypesResultSet() override = default;
+    explicit RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads = 1);
+    virtual ~RowBinaryWithNamesAndTypesResultSet() override;
 
 protected:
     virtual bool readNextRow(Row & row) override;
 
 private:
+    // Rows decoded by a worker thread, along with the display sizes observed while decoding them.
+    struct DecodedChunk {
+        std::deque<Row> rows;
+        std::vector<std::size_t> display_sizes_so_far;
+    };
+
+    // Construct a decoder for a chunk of rows with already known structure, without reading the header.
+    explicit RowBinaryWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::vector<ColumnInfo> && columns_info);
+
+    // Decode a chunk of complete rows, reusing the spare rows and strings recycled by the consumer.
+    static DecodedChunk decodeChunk(const std::string & data, std::size_t row_count, const std::vector<ColumnInfo> & columns_info,
+        std::vector<Row> spare_rows, std::vector<std::string> spare_strings);
+
+    bool readNextRowParallel(Row & row);
+
+    // Cut the next chunk of complete rows from the stream and hand it over to a worker thread.
+    void scheduleNextChunk();
+
+    // Determine the size of the row at 'data' by skipping its values. Return false if the row is not entirely in [data, data + size).
+    bool tryScanRow(const char * data, std::size_t size, std::size_t & row_size) const;
+    bool tryScanValue(const char * data, std::size_t size, std::size_t & value_size, const ColumnInfo & column_info) const;
+
     void readSize(std::uint64_t & dest);
 
     void readValue(bool & dest);
@@ -63,13 +87,20 @@ private:
     void readValue(T & dest, ColumnInfo & column_info) {
         throw std::runtime_error("Unable to decode value of type '" + column_info.type + "'");
     }
+
+private:
+    const std::size_t decode_threads;
+    std::shared_ptr<const std::vector<ColumnInfo>> shared_columns_info;
+    std::deque<std::future<DecodedChunk>> chunks_in_flight;
+    DecodedChunk current_chunk;
+    bool input_exhausted = false;
 };
 
 class RowBinaryWithNamesAndTypesResultReader
     : public ResultReader
 {
 public:
-    explicit RowBinaryWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator);
+    explicit RowBinaryWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads = 1);
     virtual ~RowBinaryWithNamesAndTypesResultReader() override = default;
 
     virtual bool advanceToNextResultSet() override;
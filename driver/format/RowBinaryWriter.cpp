@@ -0,0 +1,180 @@
+#include "driver/format/RowBinaryWriter.h"
+
+namespace {
+
+    template <typename T> constexpr SQLSMALLINT getNativeCTypeFor(); // Leave unimplemented for general case.
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int8_t   >() { return SQL_C_STINYINT; }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int16_t  >() { return SQL_C_SSHORT;   }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int32_t  >() { return SQL_C_SLONG;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::int64_t  >() { return SQL_C_SBIGINT;  }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint8_t  >() { return SQL_C_UTINYINT; }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint16_t >() { return SQL_C_USHORT;   }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint32_t >() { return SQL_C_ULONG;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< std::uint64_t >() { return SQL_C_UBIGINT;  }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< float         >() { return SQL_C_FLOAT;    }
+    template <> constexpr SQLSMALLINT getNativeCTypeFor< double        >() { return SQL_C_DOUBLE;   }
+
+    void writeULEB128(std::string & dest, std::uint64_t value) {
+        do {
+            std::uint8_t byte = value & 0b01111111;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0b10000000;
+            dest.push_back(static_cast<char>(byte));
+        } while (value != 0);
+    }
+
+    bool isNull(const BindingInfo & binding_info) {
+        return (binding_info.value == nullptr || (binding_info.indicator && *binding_info.indicator == SQL_NULL_DATA));
+    }
+
+    bool isIgnored(const BindingInfo & binding_info) {
+        return (binding_info.indicator && *binding_info.indicator == SQL_COLUMN_IGNORE);
+    }
+
+} // namespace
+
+RowBinaryWriter::RowBinaryWriter(const std::vector<ColumnInfo> & columns_info) {
+    columns.reserve(columns_info.size());
+
+    for (const auto & column_info : columns_info) {
+        Column column;
+        column.name = column_info.name;
+        column.is_nullable = column_info.is_nullable;
+
+        switch (column_info.type_without_parameters_id) {
+            case DataSourceTypeId::Int8:    column.wire_type = WireType::Int8;    break;
+            case DataSourceTypeId::Int16:   column.wire_type = WireType::Int16;   break;
+            case DataSourceTypeId::Int32:   column.wire_type = WireType::Int32;   break;
+            case DataSourceTypeId::Int64:   column.wire_type = WireType::Int64;   break;
+            case DataSourceTypeId::UInt8:   column.wire_type = WireType::UInt8;   break;
+            case DataSourceTypeId::UInt16:  column.wire_type = WireType::UInt16;  break;
+            case DataSourceTypeId::UInt32:  column.wire_type = WireType::UInt32;  break;
+            case DataSourceTypeId::UInt64:  column.wire_type = WireType::UInt64;  break;
+            case DataSourceTypeId::Float32: column.wire_type = WireType::Float32; break;
+            case DataSourceTypeId::Float64: column.wire_type = WireType::Float64; break;
+            default:                        column.wire_type = WireType::String;  break;
+        }
+
+        columns.emplace_back(std::move(column));
+    }
+}
+
+std::string RowBinaryWriter::getStructure() const {
+    std::string structure;
+
+    for (const auto & column : columns) {
+        if (!structure.empty())
+            structure += ", ";
+
+        std::string type_name;
+
+        switch (column.wire_type) {
+            case WireType::Int8:    type_name = "Int8";    break;
+            case WireType::Int16:   type_name = "Int16";   break;
+            case WireType::Int32:   type_name = "Int32";   break;
+            case WireType::Int64:   type_name = "Int64";   break;
+            case WireType::UInt8:   type_name = "UInt8";   break;
+            case WireType::UInt16:  type_name = "UInt16";  break;
+            case WireType::UInt32:  type_name = "UInt32";  break;
+            case WireType::UInt64:  type_name = "UInt64";  break;
+            case WireType::Float32: type_name = "Float32"; break;
+            case WireType::Float64: type_name = "Float64"; break;
+            case WireType::String:  type_name = "String";  break;
+        }
+
+        if (column.is_nullable)
+            type_name = "Nullable(" + type_name + ")";
+
+        structure += '`' + escapeForSQL(column.name) + "` " + type_name;
+    }
+
+    return structure;
+}
+
+void RowBinaryWriter::writeRow(const std::vector<BindingInfo> & bindings, std::string & dest) {
+    if (bindings.size() != columns.size())
+        throw std::runtime_error("Unexpected number of values in a row");
+
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        const auto & column = columns[i];
+        const auto & binding_info = bindings[i];
+
+        // Ignored values of non-nullable columns are sent as default values of their types.
+        if (isIgnored(binding_info) && !column.is_nullable) {
+            writeDefaultValue(column, dest);
+            continue;
+        }
+
+        if (isNull(binding_info) || isIgnored(binding_info)) {
+            if (!column.is_nullable)
+                throw SqlException("Integrity constraint violation", "23000");
+
+            dest.push_back(1);
+            continue;
+        }
+
+        if (column.is_nullable)
+            dest.push_back(0);
+
+        writeValue(column, binding_info, dest);
+    }
+}
+
+void RowBinaryWriter::writeValue(const Column & column, const BindingInfo & binding_info, std::string & dest) {
+    switch (column.wire_type) {
+        case WireType::Int8:    return writeNumber< std::int8_t   >(binding_info, dest);
+        case WireType::Int16:   return writeNumber< std::int16_t  >(binding_info, dest);
+        case WireType::Int32:   return writeNumber< std::int32_t  >(binding_info, dest);
+        case WireType::Int64:   return writeNumber< std::int64_t  >(binding_info, dest);
+        case WireType::UInt8:   return writeNumber< std::uint8_t  >(binding_info, dest);
+        case WireType::UInt16:  return writeNumber< std::uint16_t >(binding_info, dest);
+        case WireType::UInt32:  return writeNumber< std::uint32_t >(binding_info, dest);
+        case WireType::UInt64:  return writeNumber< std::uint64_t >(binding_info, dest);
+        case WireType::Float32: return writeNumber< float         >(binding_info, dest);
+        case WireType::Float64: return writeNumber< double        >(binding_info, dest);
+
+        case WireType::String: {
+            readReadyDataTo(binding_info, tmp_value);
+            writeULEB128(dest, tmp_value.size());
+            dest.append(tmp_value);
+            return;
+        }
+    }
+}
+
+void RowBinaryWriter::writeDefaultValue(const Column & column, std::string & dest) {
+    std::size_t size = 0;
+
+    switch (column.wire_type) {
+        case WireType::Int8:
+        case WireType::UInt8:   size = 1; break;
+        case WireType::Int16:
+        case WireType::UInt16:  size = 2; break;
+        case WireType::Int32:
+        case WireType::UInt32:
+        case WireType::Float32: size = 4; break;
+        case WireType::Int64:
+        case WireType::UInt64:
+        case WireType::Float64: size = 8; break;
+        case WireType::String:  size = 1; break; // Zero length.
+    }
+
+    dest.append(size, '\0');
+}
+
+template <typename T>
+void RowBinaryWriter::writeNumber(const BindingInfo & binding_info, std::string & dest) {
+    T value = 0;
+
+    // Copy the value as is, if the application buffer already holds it in the native representation.
+    if (binding_info.c_type == getNativeCTypeFor<T>()) {
+        std::memcpy(&value, binding_info.value, sizeof(value));
+    }
+    else {
+        readReadyDataTo(binding_info, tmp_value);
+        value_manip::from_value<std::string>::template to_value<T>::convert(tmp_value, value);
+    }
+
+    dest.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "driver/platform/platform.h"
+#include "driver/result_set.h"
+
+#include <string>
+#include <vector>
+
+// Encoder of values from application buffers into RowBinary wire format of ClickHouse, for sending them in INSERT queries.
+// Integer and floating-point columns are encoded natively, all other columns are encoded as strings, and are expected
+// to be converted to the actual column types by the server, e.g., by using input() table function with getStructure().
+class RowBinaryWriter {
+public:
+    explicit RowBinaryWriter(const std::vector<ColumnInfo> & columns_info);
+
+    // Structure of the encoded rows, in a form accepted by input() table function, e.g., "`a` Int32, `b` Nullable(String)".
+    std::string getStructure() const;
+
+    // Encode the values of all columns of a single row, and append them to dest.
+    void writeRow(const std::vector<BindingInfo> & bindings, std::string & dest);
+
+private:
+    enum class WireType {
+        Int8,
+        Int16,
+        Int32,
+        Int64,
+        UInt8,
+        UInt16,
+        UInt32,
+        UInt64,
+        Float32,
+        Float64,
+        String
+    };
+
+    struct Column {
+        std::string name;
+        WireType wire_type = WireType::String;
+        bool is_nullable = false;
+    };
+
+    void writeValue(const Column & column, const BindingInfo & binding_info, std::string & dest);
+    void writeDefaultValue(const Column & column, std::string & dest);
+
+    template <typename T>
+    void writeNumber(const BindingInfo & binding_info, std::string & dest);
+
+private:
+    std::vector<Column> columns;
+    std::string tmp_value;
+};
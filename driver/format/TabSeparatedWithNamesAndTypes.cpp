@@ -0,0 +1,216 @@
+#include "driver/format/TabSeparatedWithNamesAndTypes.h"
+
+#include <charconv>
+
+namespace {
+
+    // Longest textual representation of a 64-bit integer, with sign, plus a delimiter, with some margin.
+    constexpr std::size_t max_integer_field_size = 32;
+
+    inline int hexDigitValue(const char ch) {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+
+        if (ch >= 'a' && ch <= 'f')
+            return ch - 'a' + 10;
+
+        if (ch >= 'A' && ch <= 'F')
+            return ch - 'A' + 10;
+
+        throw std::runtime_error("Malformed escape sequence in TabSeparated field");
+    }
+
+} // namespace
+
+TabSeparatedWithNamesAndTypesResultSet::TabSeparatedWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator)
+    : ResultSet(stream, std::move(mutator))
+{
+    // The first line contains column names.
+    while (true) {
+        columns_info.emplace_back();
+        readValue(columns_info.back().name);
+
+        if (readDelimiter() == '\n')
+            break;
+    }
+
+    // The second line contains column types.
+    for (std::size_t i = 0; i < columns_info.size(); ++i) {
+        readValue(columns_info[i].type);
+
+        const auto delimiter = readDelimiter();
+        const auto expected_delimiter = (i + 1 < columns_info.size() ? '\t' : '\n');
+
+        if (delimiter != expected_delimiter)
+            throw std::runtime_error("Malformed TabSeparatedWithNamesAndTypes header: number of names and types differ");
+
+        TypeParser parser{columns_info[i].type};
+        TypeAst ast;
+
+        if (parser.parse(&ast)) {
+            columns_info[i].assignTypeInfo(ast);
+
+            if (convertUnparametrizedTypeNameToTypeId(columns_info[i].type_without_parameters) == DataSourceTypeId::Unknown) {
+                // Interpret all unknown types as String.
+                columns_info[i].type_without_parameters = "String";
+            }
+        }
+        else {
+            // Interpret all unparsable types as String.
+            columns_info[i].type_without_parameters = "String";
+        }
+
+        columns_info[i].updateTypeInfo();
+    }
+
+    finished = columns_info.empty();
+}
+
+bool TabSeparatedWithNamesAndTypesResultSet::readNextRow(Row & row) {
+    if (stream.eof())
+        return false;
+
+    for (std::size_t i = 0; i < row.fields.size(); ++i) {
+        readValue(row.fields[i], columns_info[i]);
+
+        const auto delimiter = readDelimiter();
+        const auto expected_delimiter = (i + 1 < row.fields.size() ? '\t' : '\n');
+
+        if (delimiter != expected_delimiter)
+            throw std::runtime_error("Malformed TabSeparatedWithNamesAndTypes row: unexpected number of fields");
+    }
+
+    return true;
+}
+
+char TabSeparatedWithNamesAndTypesResultSet::readDelimiter() {
+    const auto delimiter = stream.get();
+
+    if (delimiter != '\t' && delimiter != '\n')
+        throw std::runtime_error("Malformed TabSeparatedWithNamesAndTypes data: delimiter expected");
+
+    return delimiter;
+}
+
+void TabSeparatedWithNamesAndTypesResultSet::readValue(std::string & dest, bool * is_null) {
+    dest.clear();
+
+    if (is_null)
+        *is_null = false;
+
+    while (true) {
+        const auto [data, size] = stream.peek();
+
+        if (size == 0)
+            break;
+
+        // Copy the longest run of plain characters at once, and stop only at delimiters and escape sequences.
+        const auto * pos = simd::findFirstOf(data, data + size, '\t', '\n', '\\');
+        const std::size_t plain_size = pos - data;
+
+        dest.append(data, plain_size);
+        stream.read(nullptr, plain_size);
+
+        if (plain_size == size)
+            continue;
+
+        if (*pos != '\\')
+            break;
+
+        stream.read(nullptr, 1);
+        const auto escaped = stream.get();
+
+        switch (escaped) {
+            case 'b': dest.push_back('\b'); break;
+            case 'f': dest.push_back('\f'); break;
+            case 'r': dest.push_back('\r'); break;
+            case 'n': dest.push_back('\n'); break;
+            case 't': dest.push_back('\t'); break;
+            case '0': dest.push_back('\0'); break;
+            case 'a': dest.push_back('\a'); break;
+            case 'v': dest.push_back('\v'); break;
+
+            case 'x': {
+                const auto hi = hexDigitValue(stream.get());
+                const auto lo = hexDigitValue(stream.get());
+                dest.push_back(static_cast<char>((hi << 4) | lo));
+                break;
+            }
+
+            case 'N': {
+                if (dest.empty() && is_null) {
+                    *is_null = true;
+                    break;
+                }
+
+                dest.push_back(escaped);
+                break;
+            }
+
+            default: {
+                dest.push_back(escaped);
+                break;
+            }
+        }
+    }
+}
+
+template <typename T>
+bool TabSeparatedWithNamesAndTypesResultSet::tryReadIntegerInPlace(T & dest, std::size_t & length) {
+    const auto [data, size] = stream.peek(max_integer_field_size);
+    const auto * end = data + size;
+    const auto * pos = simd::findFirstOf(data, end, '\t', '\n', '\\');
+
+    // Escape sequences (e.g., \N) and fields not fully buffered are handled by the generic path.
+    if (pos == data || pos == end || *pos == '\\')
+        return false;
+
+    const auto result = std::from_chars(data, pos, dest);
+
+    if (result.ec != std::errc{} || result.ptr != pos)
+        return false;
+
+    length = pos - data;
+    stream.read(nullptr, length);
+
+    return true;
+}
+
+void TabSeparatedWithNamesAndTypesResultSet::readValue(Field & dest, ColumnInfo & column_info) {
+    switch (column_info.type_without_parameters_id) {
+        case DataSourceTypeId::Int8:        return readIntegerAs<DataSourceType< DataSourceTypeId::Int8        >>(dest, column_info);
+        case DataSourceTypeId::Int16:       return readIntegerAs<DataSourceType< DataSourceTypeId::Int16       >>(dest, column_info);
+        case DataSourceTypeId::Int32:       return readIntegerAs<DataSourceType< DataSourceTypeId::Int32       >>(dest, column_info);
+        case DataSourceTypeId::Int64:       return readIntegerAs<DataSourceType< DataSourceTypeId::Int64       >>(dest, column_info);
+        case DataSourceTypeId::UInt8:       return readIntegerAs<DataSourceType< DataSourceTypeId::UInt8       >>(dest, column_info);
+        case DataSourceTypeId::UInt16:      return readIntegerAs<DataSourceType< DataSourceTypeId::UInt16      >>(dest, column_info);
+        case DataSourceTypeId::UInt32:      return readIntegerAs<DataSourceType< DataSourceTypeId::UInt32      >>(dest, column_info);
+        case DataSourceTypeId::UInt64:      return readIntegerAs<DataSourceType< DataSourceTypeId::UInt64      >>(dest, column_info);
+        case DataSourceTypeId::FixedString: return readValueAs<DataSourceType< DataSourceTypeId::FixedString >>(dest, column_info);
+        case DataSourceTypeId::String:      return readValueAs<DataSourceType< DataSourceTypeId::String      >>(dest, column_info);
+
+        // The textual representation of all other types matches the one of ODBCDriver2 format, so we convert them on demand.
+        default:                            return readValueAs<WireTypeAnyAsString                            >(dest, column_info);
+    }
+}
+
+TabSeparatedWithNamesAndTypesResultReader::TabSeparatedWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator)
+    : ResultReader(raw_stream, std::move(mutator))
+{
+    if (stream.eof())
+        return;
+
+    result_set = std::make_unique<TabSeparatedWithNamesAndTypesResultSet>(stream, releaseMutator());
+}
+
+bool TabSeparatedWithNamesAndTypesResultReader::advanceToNextResultSet() {
+    // TabSeparatedWithNamesAndTypes format doesn't support multiple result sets in the response,
+    // so only a basic cleanup is done here.
+
+    if (result_set) {
+        result_mutator = result_set->releaseMutator();
+        result_set.reset();
+    }
+
+    return hasResultSet();
+}
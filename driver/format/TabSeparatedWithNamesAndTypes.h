@@ -0,0 +1,87 @@
+#pragma once
+
+#include "driver/platform/platform.h"
+#include "driver/result_set.h"
+
+// Implementation of ResultSet for TabSeparatedWithNamesAndTypes wire format of ClickHouse.
+class TabSeparatedWithNamesAndTypesResultSet
+    : public ResultSet
+{
+public:
+    explicit TabSeparatedWithNamesAndTypesResultSet(AmortizedIStreamReader & stream, std::unique_ptr<ResultMutator> && mutator);
+    virtual ~TabSeparatedWithNamesAndTypesResultSet() override = default;
+
+protected:
+    virtual bool readNextRow(Row & row) override;
+
+private:
+    // Read and consume the delimiter that follows a field, and return it.
+    char readDelimiter();
+
+    // Read and unescape the field up to (but not including) the next delimiter.
+    void readValue(std::string & dest, bool * is_null = nullptr);
+
+    void readValue(Field & dest, ColumnInfo & column_info);
+
+    template <typename T>
+    void readValueAs(Field & dest, ColumnInfo & column_info) {
+        auto value = string_pool.get();
+        value_manip::to_null(value);
+
+        bool is_null = false;
+        readValue(value, &is_null);
+
+        if (is_null && column_info.is_nullable) {
+            dest.data = DataSourceType<DataSourceTypeId::Nothing>{};
+            string_pool.put(std::move(value));
+            return;
+        }
+
+        if (column_info.display_size_so_far < value.size())
+            column_info.display_size_so_far = value.size();
+
+        T typed_value;
+
+        if constexpr (is_string_data_source_type_v<T>) {
+            typed_value.value = std::move(value);
+        }
+        else {
+            value_manip::from_value<std::string>::template to_value<T>::convert(value, typed_value);
+
+            if (value.capacity() > initial_string_capacity_g)
+                string_pool.put(std::move(value));
+        }
+
+        dest.data = std::move(typed_value);
+    }
+
+    // Parse integer fields directly in the stream buffer, falling back to the generic path when that is not possible.
+    template <typename T>
+    void readIntegerAs(Field & dest, ColumnInfo & column_info) {
+        T typed_value;
+        std::size_t length = 0;
+
+        if (tryReadIntegerInPlace(typed_value.value, length)) {
+            if (column_info.display_size_so_far < length)
+                column_info.display_size_so_far = length;
+
+            dest.data = std::move(typed_value);
+            return;
+        }
+
+        return readValueAs<T>(dest, column_info);
+    }
+
+    template <typename T>
+    bool tryReadIntegerInPlace(T & dest, std::size_t & length);
+};
+
+class TabSeparatedWithNamesAndTypesResultReader
+    : public ResultReader
+{
+public:
+    explicit TabSeparatedWithNamesAndTypesResultReader(std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator);
+    virtual ~TabSeparatedWithNamesAndTypesResultReader() override = default;
+
+    virtual bool advanceToNextResultSet() override;
+};
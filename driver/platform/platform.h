@@ -122,6 +122,16 @@
 #    define SQL_ASYNC_NOTIFICATION_CAPABLE 0x00000001L
 #endif // ODBCVER >= 0x0380
 
+// Statement attributes, that the Driver Manager sets to be notified of the completion of the asynchronously executed functions.
+#if !defined(SQL_ATTR_ASYNC_STMT_PCALLBACK)
+#    define SQL_ATTR_ASYNC_STMT_PCALLBACK 30
+#    define SQL_ATTR_ASYNC_STMT_PCONTEXT 31
+#endif
+
+#if !defined(SQL_API_SQLCOMPLETEASYNC)
+#    define SQL_API_SQLCOMPLETEASYNC 1023
+#endif
+
 #if defined(UNICODE)
 #    define DRIVER_FILE_NAME "CLICKHOUSEODBCW.DLL"
 #else
@@ -134,3 +144,28 @@
 
 #define CH_SQL_ATTR_DRIVERLOG            (SQL_ATTR_TRACE + CH_SQL_OFFSET)
 #define CH_SQL_ATTR_DRIVERLOGFILE        (SQL_ATTR_TRACEFILE + CH_SQL_OFFSET)
+
+// Statement attributes for exporting result sets via Arrow C Data Interface (see driver/utils/arrow_c_data.h).
+#define CH_SQL_ATTR_ARROW_SCHEMA         (CH_SQL_OFFSET + 1001) // Read-only. Fills the caller's ArrowSchema with the structure of the result set.
+#define CH_SQL_ATTR_ARROW_ARRAY          (CH_SQL_OFFSET + 1002) // Read-only. Fetches the next row set and fills the caller's ArrowArray with it.
+#define CH_SQL_ATTR_ARROW_BATCH_SIZE     (CH_SQL_OFFSET + 1003) // Max number of rows fetched by a single CH_SQL_ATTR_ARROW_ARRAY request.
+
+#define CH_SQL_ARROW_BATCH_SIZE_DEFAULT  65536
+
+// Statement attribute that enables raw passthrough of the response body (SQL_TRUE/SQL_FALSE). When enabled,
+// the result set consists of a single row with a single binary column, that is meant to be read in pieces by SQLGetData().
+#define CH_SQL_ATTR_RAW_RESULT           (CH_SQL_OFFSET + 1004)
+
+// Statement attributes for sending the contents of a local file as the data of the next executed INSERT query (e.g., "INSERT INTO t").
+#define CH_SQL_ATTR_INSERT_FILE          (CH_SQL_OFFSET + 1005) // Path of the file. Reset by the execution that sends the file.
+#define CH_SQL_ATTR_INSERT_FILE_FORMAT   (CH_SQL_OFFSET + 1006) // Input format of the file (e.g., CSV, TSV, Parquet, Native), appended to the query as a FORMAT clause.
+#define CH_SQL_ATTR_INSERT_FILE_ENCODING (CH_SQL_OFFSET + 1007) // Compression the file is already compressed with (e.g., gzip, zstd, lz4), sent as Content-Encoding.
+
+// Read-only connection attributes with the process-wide numbers of connections, that have reused an idle session from the pool,
+// and that have found none to reuse there, while pooling was enabled for them (see SQL_ATTR_CONNECTION_POOLING and PoolSize).
+#define CH_SQL_ATTR_SESSION_POOL_HITS    (CH_SQL_OFFSET + 1008)
+#define CH_SQL_ATTR_SESSION_POOL_MISSES  (CH_SQL_OFFSET + 1009)
+
+// Read-only connection attribute with the number of responses, that the statements of the connection have abandoned before reading
+// them to the end, but have read and discarded the rest of, avoiding reconnecting to the server (see DrainLimit).
+#define CH_SQL_ATTR_DRAINED_RESPONSES    (CH_SQL_OFFSET + 1010)
@@ -1,6 +1,9 @@
 #include "driver/result_set.h"
 #include "driver/format/ODBCDriver2.h"
 #include "driver/format/RowBinaryWithNamesAndTypes.h"
+#include "driver/format/TabSeparatedWithNamesAndTypes.h"
+
+#include <limits>
 
 const std::string::size_type initial_string_capacity_g = std::string{}.capacity();
 
@@ -202,13 +205,370 @@ std::size_t ResultSet::getAffectedRowCount() const {
     return affected_row_count;
 }
 
-SQLRETURN ResultSet::extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info) const {
+bool ResultSet::supportsBoundColumns() const {
+    return true;
+}
+
+SQLRETURN ResultSet::extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info) {
     if (row_idx >= row_set.size())
         throw SqlException("Invalid cursor position", "HY109");
 
     return row_set[row_idx].extractField(column_idx, binding_info);
 }
 
+namespace {
+
+    struct ArrowSchemaPrivateData {
+        std::string format;
+        std::string name;
+        std::vector<ArrowSchema> children;
+        std::vector<ArrowSchema *> child_ptrs;
+    };
+
+    struct ArrowArrayPrivateData {
+        std::vector<std::uint8_t> validity;
+        std::vector<std::uint8_t> values;
+        std::vector<std::int32_t> offsets;
+        std::vector<const void *> buffers;
+        std::vector<ArrowArray> children;
+        std::vector<ArrowArray *> child_ptrs;
+    };
+
+    void releaseArrowSchema(ArrowSchema * schema) {
+        if (!schema || !schema->release)
+            return;
+
+        auto * private_data = static_cast<ArrowSchemaPrivateData *>(schema->private_data);
+
+        for (auto * child : private_data->child_ptrs) {
+            if (child->release)
+                child->release(child);
+        }
+
+        delete private_data;
+        schema->release = nullptr;
+    }
+
+    void releaseArrowArray(ArrowArray * array) {
+        if (!array || !array->release)
+            return;
+
+        auto * private_data = static_cast<ArrowArrayPrivateData *>(array->private_data);
+
+        for (auto * child : private_data->child_ptrs) {
+            if (child->release)
+                child->release(child);
+        }
+
+        delete private_data;
+        array->release = nullptr;
+    }
+
+    std::string getArrowFormat(const ColumnInfo & column_info) {
+        switch (column_info.type_without_parameters_id) {
+            case DataSourceTypeId::Int8:       return "c";
+            case DataSourceTypeId::UInt8:      return "C";
+            case DataSourceTypeId::Int16:      return "s";
+            case DataSourceTypeId::UInt16:     return "S";
+            case DataSourceTypeId::Int32:      return "i";
+            case DataSourceTypeId::UInt32:     return "I";
+            case DataSourceTypeId::Int64:      return "l";
+            case DataSourceTypeId::UInt64:     return "L";
+            case DataSourceTypeId::Float32:    return "f";
+            case DataSourceTypeId::Float64:    return "g";
+            case DataSourceTypeId::Date:       return "tdD";  // Days since epoch.
+            case DataSourceTypeId::DateTime:   return "tss:"; // Seconds since epoch, without timezone.
+            case DataSourceTypeId::Nothing:    return "n";
+
+            case DataSourceTypeId::Decimal:
+            case DataSourceTypeId::Decimal32:
+            case DataSourceTypeId::Decimal64:
+            case DataSourceTypeId::Decimal128: return "d:" + std::to_string(column_info.precision) + "," + std::to_string(column_info.scale);
+
+            // FixedString values are padded with zero bytes, so they are exported as binary, unlike String ones, that are usually text.
+            case DataSourceTypeId::FixedString: return "z";
+
+            // Everything else, including UUID, is exported in its textual representation.
+            default:                           return "u";
+        }
+    }
+
+    // Number of days since 1970-01-01 in proleptic Gregorian calendar.
+    std::int64_t daysSinceEpoch(std::int64_t year, unsigned int month, unsigned int day) {
+        year -= (month <= 2 ? 1 : 0);
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const auto year_of_era = static_cast<unsigned int>(year - era * 400);
+        const auto day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+        const auto day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + static_cast<std::int64_t>(day_of_era) - 719468;
+    }
+
+    // Convert the value of the field to T, the same way SQLGetData() would do. Return false if the value is Null.
+    template <typename T>
+    bool extractFieldAs(const Field & field, T & dest, const std::int16_t precision = 0, const std::int16_t scale = 0) {
+        SQLLEN indicator = 0;
+
+        BindingInfo binding_info;
+        binding_info.c_type = getCTypeFor<T>();
+        binding_info.value = &dest;
+        binding_info.value_max_size = sizeof(dest);
+        binding_info.value_size = &indicator;
+        binding_info.indicator = &indicator;
+        binding_info.precision = precision;
+        binding_info.scale = scale;
+
+        field.extract(binding_info);
+
+        return (indicator != SQL_NULL_DATA);
+    }
+
+    void setValidity(ArrowArrayPrivateData & data, const std::size_t row_count, const std::size_t idx, const bool is_valid) {
+        if (is_valid)
+            return;
+
+        if (data.validity.empty())
+            data.validity.resize((row_count + 7) / 8, 0xFF);
+
+        data.validity[idx / 8] &= static_cast<std::uint8_t>(~(1u << (idx % 8)));
+    }
+
+    template <typename ValueType, typename Converter>
+    void exportFixedWidthColumn(const std::deque<Row> & rows, const std::size_t column_idx, ArrowArrayPrivateData & data, Converter && convert) {
+        data.values.resize(rows.size() * sizeof(ValueType));
+        auto * values = reinterpret_cast<ValueType *>(data.values.data());
+
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            values[i] = ValueType{};
+            setValidity(data, rows.size(), i, convert(rows[i].fields[column_idx], values[i]));
+        }
+    }
+
+    template <typename ValueType>
+    void exportFixedWidthColumn(const std::deque<Row> & rows, const std::size_t column_idx, ArrowArrayPrivateData & data) {
+        exportFixedWidthColumn<ValueType>(rows, column_idx, data, [] (const Field & field, ValueType & value) {
+            return extractFieldAs(field, value);
+        });
+    }
+
+    void exportStringColumn(const std::deque<Row> & rows, const std::size_t column_idx, ArrowArrayPrivateData & data) {
+        data.offsets.resize(rows.size() + 1);
+        data.offsets[0] = 0;
+
+        std::string tmp;
+
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const std::string * value = nullptr;
+
+            std::visit([&] (auto & src) {
+                using SourceType = std::decay_t<decltype(src)>;
+
+                if constexpr (std::is_same_v<SourceType, DataSourceType<DataSourceTypeId::Nothing>>) {
+                    // Null.
+                }
+                else if constexpr (is_string_data_source_type_v<SourceType>) {
+                    value = &src.value;
+                }
+                else {
+                    value_manip::to_null(tmp);
+                    value_manip::from_value<SourceType>::template to_value<std::string>::convert(src, tmp);
+                    value = &tmp;
+                }
+            }, rows[i].fields[column_idx].data);
+
+            setValidity(data, rows.size(), i, value != nullptr);
+
+            if (value) {
+                if (data.values.size() + value->size() > static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()))
+                    throw std::runtime_error("Unable to export the row set in Arrow format: too much string data, try smaller batches");
+
+                data.values.insert(data.values.end(), value->begin(), value->end());
+            }
+
+            data.offsets[i + 1] = static_cast<std::int32_t>(data.values.size());
+        }
+    }
+
+    void exportColumn(const ColumnInfo & column_info, const std::deque<Row> & rows, const std::size_t column_idx, ArrowArray & array) {
+        auto data = std::make_unique<ArrowArrayPrivateData>();
+
+        switch (column_info.type_without_parameters_id) {
+            case DataSourceTypeId::Int8:    exportFixedWidthColumn< SQLSCHAR     >(rows, column_idx, *data); break;
+            case DataSourceTypeId::UInt8:   exportFixedWidthColumn< SQLCHAR      >(rows, column_idx, *data); break;
+            case DataSourceTypeId::Int16:   exportFixedWidthColumn< SQLSMALLINT  >(rows, column_idx, *data); break;
+            case DataSourceTypeId::UInt16:  exportFixedWidthColumn< SQLUSMALLINT >(rows, column_idx, *data); break;
+            case DataSourceTypeId::Int32:   exportFixedWidthColumn< SQLINTEGER   >(rows, column_idx, *data); break;
+            case DataSourceTypeId::UInt32:  exportFixedWidthColumn< SQLUINTEGER  >(rows, column_idx, *data); break;
+            case DataSourceTypeId::Int64:   exportFixedWidthColumn< SQLBIGINT    >(rows, column_idx, *data); break;
+            case DataSourceTypeId::UInt64:  exportFixedWidthColumn< SQLUBIGINT   >(rows, column_idx, *data); break;
+            case DataSourceTypeId::Float32: exportFixedWidthColumn< SQLREAL      >(rows, column_idx, *data); break;
+            case DataSourceTypeId::Float64: exportFixedWidthColumn< SQLDOUBLE    >(rows, column_idx, *data); break;
+
+            case DataSourceTypeId::Date: {
+                exportFixedWidthColumn<std::int32_t>(rows, column_idx, *data, [] (const Field & field, std::int32_t & value) {
+                    SQL_DATE_STRUCT date;
+                    value_manip::to_null(date);
+
+                    if (!extractFieldAs(field, date))
+                        return false;
+
+                    value = static_cast<std::int32_t>(daysSinceEpoch(date.year, date.month, date.day));
+                    return true;
+                });
+                break;
+            }
+
+            case DataSourceTypeId::DateTime: {
+                exportFixedWidthColumn<std::int64_t>(rows, column_idx, *data, [] (const Field & field, std::int64_t & value) {
+                    SQL_TIMESTAMP_STRUCT timestamp;
+                    value_manip::to_null(timestamp);
+
+                    if (!extractFieldAs(field, timestamp))
+                        return false;
+
+                    value = daysSinceEpoch(timestamp.year, timestamp.month, timestamp.day) * 86400 +
+                        timestamp.hour * 3600 + timestamp.minute * 60 + timestamp.second;
+                    return true;
+                });
+                break;
+            }
+
+            case DataSourceTypeId::Decimal:
+            case DataSourceTypeId::Decimal32:
+            case DataSourceTypeId::Decimal64:
+            case DataSourceTypeId::Decimal128: {
+                // Arrow decimal128 is a 16-byte little-endian two's complement integer.
+                struct Decimal128 { std::uint8_t bytes[16]; };
+                static_assert(sizeof(Decimal128) == sizeof(SQL_NUMERIC_STRUCT::val));
+
+                const auto precision = static_cast<std::int16_t>(column_info.precision);
+                const auto scale = static_cast<std::int16_t>(column_info.scale);
+
+                exportFixedWidthColumn<Decimal128>(rows, column_idx, *data, [&] (const Field & field, Decimal128 & value) {
+                    SQL_NUMERIC_STRUCT numeric;
+                    value_manip::to_null(numeric);
+
+                    if (!extractFieldAs(field, numeric, precision, scale))
+                        return false;
+
+                    std::memcpy(value.bytes, numeric.val, sizeof(value.bytes));
+
+                    if (numeric.sign == 0) { // Negative, so negate the magnitude.
+                        unsigned int carry = 1;
+                        for (auto & byte : value.bytes) {
+                            const unsigned int sum = static_cast<std::uint8_t>(~byte) + carry;
+                            byte = static_cast<std::uint8_t>(sum & 0xFF);
+                            carry = sum >> 8;
+                        }
+                    }
+
+                    return true;
+                });
+                break;
+            }
+
+            case DataSourceTypeId::Nothing:
+                break;
+
+            default:
+                exportStringColumn(rows, column_idx, *data);
+                break;
+        }
+
+        std::int64_t null_count = 0;
+
+        if (column_info.type_without_parameters_id == DataSourceTypeId::Nothing) {
+            null_count = rows.size();
+        }
+        else {
+            for (std::size_t i = 0; i < rows.size() && !data->validity.empty(); ++i) {
+                if ((data->validity[i / 8] & (1u << (i % 8))) == 0)
+                    ++null_count;
+            }
+
+            data->buffers.push_back(data->validity.empty() ? nullptr : data->validity.data());
+
+            if (!data->offsets.empty())
+                data->buffers.push_back(data->offsets.data());
+
+            data->buffers.push_back(data->values.data());
+        }
+
+        array.length = rows.size();
+        array.null_count = null_count;
+        array.offset = 0;
+        array.n_buffers = data->buffers.size();
+        array.n_children = 0;
+        array.buffers = data->buffers.data();
+        array.children = nullptr;
+        array.dictionary = nullptr;
+        array.release = &releaseArrowArray;
+        array.private_data = data.release();
+    }
+
+} // namespace
+
+void ResultSet::exportArrowSchema(ArrowSchema & schema) const {
+    const auto fill_schema = [] (ArrowSchema & dest, ArrowSchemaPrivateData & data, const std::int64_t flags) {
+        dest.format = data.format.c_str();
+        dest.name = data.name.c_str();
+        dest.metadata = nullptr;
+        dest.flags = flags;
+        dest.n_children = data.child_ptrs.size();
+        dest.children = (data.child_ptrs.empty() ? nullptr : data.child_ptrs.data());
+        dest.dictionary = nullptr;
+        dest.release = &releaseArrowSchema;
+        dest.private_data = &data;
+    };
+
+    auto data = std::make_unique<ArrowSchemaPrivateData>();
+    data->format = "+s";
+    data->children.resize(columns_info.size());
+
+    for (std::size_t i = 0; i < columns_info.size(); ++i) {
+        const auto & column_info = columns_info[i];
+
+        auto child_data = std::make_unique<ArrowSchemaPrivateData>();
+        child_data->format = getArrowFormat(column_info);
+        child_data->name = column_info.name;
+
+        fill_schema(data->children[i], *child_data.release(), (column_info.is_nullable ? ARROW_FLAG_NULLABLE : 0));
+        data->child_ptrs.push_back(&data->children[i]);
+    }
+
+    fill_schema(schema, *data.release(), 0);
+}
+
+void ResultSet::exportArrowArray(ArrowArray & array) const {
+    auto data = std::make_unique<ArrowArrayPrivateData>();
+    data->children.resize(columns_info.size());
+
+    try {
+        for (std::size_t i = 0; i < columns_info.size(); ++i) {
+            exportColumn(columns_info[i], row_set, i, data->children[i]);
+            data->child_ptrs.push_back(&data->children[i]);
+        }
+    }
+    catch (...) {
+        for (auto * child : data->child_ptrs) {
+            child->release(child);
+        }
+        throw;
+    }
+
+    data->buffers.push_back(nullptr); // Struct arrays have only the validity buffer, and all the rows are valid here.
+
+    array.length = row_set.size();
+    array.null_count = 0;
+    array.offset = 0;
+    array.n_buffers = data->buffers.size();
+    array.n_children = data->child_ptrs.size();
+    array.buffers = data->buffers.data();
+    array.children = (data->child_ptrs.empty() ? nullptr : data->child_ptrs.data());
+    array.dictionary = nullptr;
+    array.release = &releaseArrowArray;
+    array.private_data = data.release();
+}
+
 void ResultSet::tryPrefetchRows(std::size_t size) {
     while (!finished && prefetched_rows.size() < size) {
         prefetched_rows.emplace_back(row_pool.get());
@@ -317,7 +677,7 @@ std::unique_ptr<ResultMutator> ResultReader::releaseMutator() {
     return std::move(result_mutator);
 }
 
-std::unique_ptr<ResultReader> make_result_reader(const std::string & format, std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator) {
+std::unique_ptr<ResultReader> make_result_reader(const std::string & format, std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads) {
     if (format == "ODBCDriver2") {
         return std::make_unique<ODBCDriver2ResultReader>(raw_stream, std::move(mutator));
     }
@@ -325,7 +685,10 @@ std::unique_ptr<ResultReader> make_result_reader(const std::string & format, std
         if (!is_little_endian())
             throw std::runtime_error("'" + format + "' format is supported only on little-endian platforms");
 
-        return std::make_unique<RowBinaryWithNamesAndTypesResultReader>(raw_stream, std::move(mutator));
+        return std::make_unique<RowBinaryWithNamesAndTypesResultReader>(raw_stream, std::move(mutator), decode_threads);
+    }
+    else if (format == "TabSeparatedWithNamesAndTypes" || format == "TSVWithNamesAndTypes") {
+        return std::make_unique<TabSeparatedWithNamesAndTypesResultReader>(raw_stream, std::move(mutator));
     }
 
     throw std::runtime_error("'" + format + "' format is not supported");
@@ -4,6 +4,7 @@
 #include "driver/utils/utils.h"
 #include "driver/utils/type_parser.h"
 #include "driver/utils/type_info.h"
+#include "driver/utils/arrow_c_data.h"
 
 #include <deque>
 #include <iostream>
@@ -30,6 +31,7 @@ public:
     std::size_t precision = 0;
     std::size_t scale = 0;
     bool is_nullable = false;
+    const TypeInfo * type_info = nullptr; // Set only for the columns, that are not of a type of the server, and describe themselves.
 };
 
 class Field {
@@ -101,8 +103,17 @@ public:
     std::size_t getCurrentRowPosition() const;    // 1-based. 1 means positioned at the first row of the entire result set.
     std::size_t getAffectedRowCount() const;
 
+    // Whether the fields can be read into the bound columns, when the row set is fetched, and not only by SQLGetData().
+    virtual bool supportsBoundColumns() const;
+
     // row_idx - row index within the row set.
-    SQLRETURN extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info) const;
+    virtual SQLRETURN extractField(std::size_t row_idx, std::size_t column_idx, BindingInfo & binding_info);
+
+    // Export the structure of the result set, as an Arrow struct type with a child per column.
+    void exportArrowSchema(ArrowSchema & schema) const;
+
+    // Export the current row set, as an Arrow struct array with a child per column.
+    void exportArrowArray(ArrowArray & array) const;
 
 protected:
     void tryPrefetchRows(std::size_t size);
@@ -144,4 +155,4 @@ protected:
     std::unique_ptr<ResultSet> result_set;
 };
 
-std::unique_ptr<ResultReader> make_result_reader(const std::string & format, std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator);
+std::unique_ptr<ResultReader> make_result_reader(const std::string & format, std::istream & raw_stream, std::unique_ptr<ResultMutator> && mutator, std::size_t decode_threads = 1);
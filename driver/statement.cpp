@@ -1,393 +1,2271 @@
 #include "driver/platform/platform.h"
 #include "driver/utils/utils.h"
+#include "driver/utils/query_template.h"
+#include "driver/utils/decompressing_stream.h"
+#include "driver/utils/http_response_body.h"
+#include "driver/utils/thread_pool.h"
 #include "driver/escaping/lexer.h"
 #include "driver/escaping/escape_sequences.h"
 #include "driver/statement.h"
+#include "driver/format/NativeWriter.h"
+#include "driver/format/RawPassthrough.h"
+#include "driver/format/RowBinaryWriter.h"
 
+#include <Poco/DeflatingStream.h>
 #include <Poco/Exception.h>
 #include <Poco/Net/HTTPClientSession.h>
 #include <Poco/Net/HTTPRequest.h>
+#include <Poco/Net/MessageHeader.h>
+#include <Poco/Net/MultipartWriter.h>
 #include <Poco/URI.h>
-#include <Poco/UUID.h>
 #include <Poco/UUIDGenerator.h>
 
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <string_view>
+
 #include <cctype>
 #include <cstdio>
+#include <cstring>
+
+namespace {
+
+    // Sets the flag for the lifetime of the guard.
+    class FlagGuard {
+    public:
+        explicit FlagGuard(std::atomic<bool> & flag)
+            : flag_(flag)
+        {
+            flag_ = true;
+        }
+
+        ~FlagGuard() {
+            flag_ = false;
+        }
+
+    private:
+        std::atomic<bool> & flag_;
+    };
+
+    // Calls the function, when the guard goes out of scope.
+    class ExitGuard {
+    public:
+        explicit ExitGuard(std::function<void ()> && on_exit)
+            : on_exit_(std::move(on_exit))
+        {
+        }
+
+        ~ExitGuard() {
+            on_exit_();
+        }
+
+    private:
+        const std::function<void ()> on_exit_;
+    };
+
+    // Generates an identifier of a query, that is sent to the server, so that the query can be killed there.
+    std::string generateQueryId() {
+        return Poco::UUIDGenerator::defaultGenerator().createRandom().toString();
+    }
+
+    // Checks whether the response is read up to its end, so that the session can be reused for the next request.
+    bool isFullyRead(std::istream & stream) {
+        try {
+            return (stream && stream.peek() == EOF);
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+    bool startsWithNoCase(const std::string & str, std::size_t pos, const char * prefix) {
+        for (; *prefix; ++pos, ++prefix) {
+            if (pos >= str.size() || std::toupper(static_cast<unsigned char>(str[pos])) != *prefix)
+                return false;
+        }
+        return true;
+    }
+
+    std::size_t skipSpaces(const std::string & str, std::size_t pos) {
+        while (pos < str.size() && std::isspace(static_cast<unsigned char>(str[pos])))
+            ++pos;
+        return pos;
+    }
+
+    bool isIdentifierChar(char ch) {
+        return (ch == '_' || std::isalnum(static_cast<unsigned char>(ch)));
+    }
+
+    // Checks whether the text is a plain decimal number, with an optional sign, fraction, and exponent, that can be inlined as is.
+    bool isNumericLiteral(const std::string & str) {
+        const auto skip_digits = [&] (std::size_t & pos) {
+            const auto begin = pos;
+            while (pos < str.size() && std::isdigit(static_cast<unsigned char>(str[pos])))
+                ++pos;
+            return pos - begin;
+        };
+
+        std::size_t pos = 0;
+        if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+            ++pos;
+
+        auto digit_count = skip_digits(pos);
+        if (pos < str.size() && str[pos] == '.') {
+            ++pos;
+            digit_count += skip_digits(pos);
+        }
+
+        if (digit_count == 0)
+            return false;
+
+        if (pos < str.size() && (str[pos] == 'e' || str[pos] == 'E')) {
+            ++pos;
+            if (pos < str.size() && (str[pos] == '-' || str[pos] == '+'))
+                ++pos;
+
+            if (skip_digits(pos) == 0)
+                return false;
+        }
+
+        return (pos == str.size());
+    }
+
+    // Checks whether the text is a special floating-point value, e.g., "-inf" or "nan", that the server accepts only as a string.
+    bool isSpecialFloatLiteral(const std::string & str) {
+        const auto pos = (!str.empty() && (str[0] == '-' || str[0] == '+') ? 1 : 0);
+        return (
+            Poco::icompare(str.substr(pos), "inf") == 0 ||
+            Poco::icompare(str.substr(pos), "infinity") == 0 ||
+            Poco::icompare(str.substr(pos), "nan") == 0
+        );
+    }
+
+    // Parameters of larger total size are sent in a multipart/form-data request body instead of the URL.
+    constexpr std::size_t max_params_size_in_url = 1 << 14; // 16 KB
+
+    // Bulk operation rows are encoded and sent in pieces of roughly this size.
+    constexpr std::size_t bulk_operation_chunk_size = 1 << 20;
+
+    // Opens a local file for sending its contents as a request body, and determines its size.
+    std::ifstream openFileForSending(const std::string & path, std::streamsize & size) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file)
+            throw std::runtime_error("Unable to open file '" + path + "'");
+
+        size = file.tellg();
+        file.seekg(0);
+
+        return file;
+    }
+
+    // Copies the contents of a stream as is, in large pieces.
+    void copyStream(std::istream & from, std::ostream & to) {
+        std::string buffer;
+        resize_without_initialization(buffer, bulk_operation_chunk_size);
+
+        while (from) {
+            from.read(&buffer[0], buffer.size());
+            if (from.gcount() > 0)
+                to.write(buffer.data(), from.gcount());
+        }
+
+        if (from.bad())
+            throw std::runtime_error("Unable to read the file sent in the request body");
+    }
+
+    // Writes a request body to the request stream, compressing it on the fly according to its Content-Encoding, if any.
+    class RequestBodyWriter {
+    public:
+        explicit RequestBodyWriter(std::ostream & request_stream, const std::string & encoding)
+            : stream(&request_stream)
+        {
+            if (!encoding.empty()) {
+                compressing_stream.emplace(request_stream,
+                    (encoding == "gzip" ? Poco::DeflatingStreamBuf::STREAM_GZIP : Poco::DeflatingStreamBuf::STREAM_ZLIB)
+                );
+                stream = &*compressing_stream;
+            }
+        }
+
+        std::ostream & get() {
+            return *stream;
+        }
+
+        // Write out the data that is still buffered by the compressor.
+        void finish() {
+            if (compressing_stream)
+                compressing_stream->close();
+        }
+
+    private:
+        std::optional<Poco::DeflatingOutputStream> compressing_stream;
+        std::ostream * stream = nullptr;
+    };
+
+    // Escapes a value for using it in TabSeparated format.
+    std::string escapeForTSV(const std::string & value) {
+        std::string res;
+        res.reserve(value.size() + 2);
+        for (auto ch : value) {
+            switch (ch) {
+                case '\\': res += "\\\\"; break;
+                case '\t': res += "\\t"; break;
+                case '\n': res += "\\n"; break;
+                default:   res += ch; break;
+            }
+        }
+        return res;
+    }
+
+    // Checks whether the type is numeric, i.e., whether an empty text is not a valid value of it.
+    bool isNumericType(std::string type_name) {
+        for (const auto * wrapper : { "Nullable(", "LowCardinality(" }) {
+            if (startsWithNoCase(type_name, 0, wrapper)) {
+                type_name.erase(0, std::strlen(wrapper));
+                type_name.pop_back();
+            }
+        }
+
+        for (const auto * numeric_type : { "INT", "UINT", "FLOAT", "DECIMAL" }) {
+            if (startsWithNoCase(type_name, 0, numeric_type))
+                return true;
+        }
+
+        return false;
+    }
+
+} // namespace
+
+Statement::Statement(Connection & connection)
+    : ChildType(connection)
+{
+    allocateImplicitDescriptors();
+}
+
+Statement::~Statement() {
+    try {
+        abandonAsyncOperation();
+        resetDataAtExecState();
+        releaseSession();
+    }
+    catch (...) {
+    }
+
+    deallocateImplicitDescriptors();
+}
+
+const TypeInfo & Statement::getTypeInfo(const std::string & type_name, const std::string & type_name_without_parameters) const {
+    return getParent().getParent().getTypeInfo(type_name, type_name_without_parameters);
+}
+
+const TypeInfo & Statement::getTypeInfo(const ColumnInfo & column_info) const {
+    if (column_info.type_info)
+        return *column_info.type_info;
+
+    return getTypeInfo(column_info.type, column_info.type_without_parameters);
+}
+
+void Statement::prepareQuery(const std::string & q) {
+    closeCursor();
+    query = q;
+    processEscapeSequences();
+    extractParametersinfo();
+    query_kind = classifyQuery(query);
+    is_prepared = true;
+}
+
+bool Statement::isPrepared() const {
+    return is_prepared;
+}
+
+bool Statement::isExecuted() const {
+    return is_executed;
+}
+
+void Statement::executeQuery(std::unique_ptr<ResultMutator> && mutator) {
+    if (!is_prepared)
+        throw std::runtime_error("statement not prepared");
+
+    if (is_executed && is_forward_executed) {
+        is_forward_executed = false;
+        return;
+    }
+
+    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
+    if (param_set_processed_ptr)
+        *param_set_processed_ptr = 0;
+
+    next_param_set = 0;
+    in_list_tables.clear();
+    param_in_in_list_table.clear();
+    resetDataAtExecState();
+
+    // The file is sent by this execution only.
+    insert_file = getAttrAs<std::string>(CH_SQL_ATTR_INSERT_FILE);
+    resetAttr(CH_SQL_ATTR_INSERT_FILE);
+
+    const auto param_bindings = getParamsBindingInfo(0);
+    data_at_exec_params = findDataAtExecParams(param_bindings);
+
+    if (!insert_file.empty()) {
+        if (!startsWithNoCase(query, skipSpaces(query, 0), "INSERT"))
+            throw SqlException("Function sequence error", "HY010");
+
+        const auto param_set_array_size = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
+        if (param_set_array_size > 1 || !data_at_exec_params.empty())
+            throw SqlException("Optional feature not implemented", "HYC00");
+    }
+
+    if (!data_at_exec_params.empty()) {
+        flushInsertBatch();
+
+        const auto param_set_array_size = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
+        if (param_set_array_size > 1)
+            throw SqlException("Optional feature not implemented", "HYC00");
+
+        // The data of the last character or binary parameter of a plain INSERT ... VALUES (?, ...) query is streamed
+        // directly into the request body, all other parameters are buffered until the execution is completed.
+        std::string insert_values_prefix;
+        if (!getParent().isNativeProtocol() && extractInsertValuesPrefix(insert_values_prefix)) {
+            for (auto it = data_at_exec_params.rbegin(); it != data_at_exec_params.rend(); ++it) {
+                const auto c_type = param_bindings[*it].c_type;
+
+                if (c_type == SQL_C_CHAR || c_type == SQL_C_WCHAR || c_type == SQL_C_BINARY) {
+                    streamed_param = *it;
+                    data_at_exec_params.erase(std::next(it).base());
+                    data_at_exec_params.push_back(streamed_param);
+                    break;
+                }
+            }
+        }
+
+        data_at_exec_mutator = std::move(mutator);
+        need_data = true;
+        return;
+    }
+
+    if (insert_file.empty() && tryAddToInsertBatch()) {
+        is_executed = true;
+        return;
+    }
+
+    requestNextPackOfResultSets(std::move(mutator));
+    is_executed = true;
+}
+
+bool Statement::needData() const {
+    return need_data;
+}
+
+bool Statement::advanceDataAtExecParam(SQLPOINTER & token) {
+    if (!need_data)
+        throw SqlException("Function sequence error", "HY010");
+
+    if (data_at_exec_params_requested < data_at_exec_params.size()) {
+        const auto param_idx = data_at_exec_params[data_at_exec_params_requested++];
+
+        if (param_idx == streamed_param)
+            startStreamedDataAtExecRequest();
+        else
+            data_at_exec_values[param_idx].emplace();
+
+        token = getParamsBindingInfo(0)[param_idx].value;
+        return true;
+    }
+
+    try {
+        if (request_body)
+            finishStreamedDataAtExecRequest(std::move(data_at_exec_mutator));
+        else
+            requestNextPackOfResultSets(std::move(data_at_exec_mutator));
+    }
+    catch (...) {
+        resetDataAtExecState();
+        throw;
+    }
+
+    resetDataAtExecState();
+    is_executed = true;
+
+    return false;
+}
+
+void Statement::putDataAtExecParamData(SQLPOINTER data, SQLLEN data_size) {
+    if (!need_data || data_at_exec_params_requested == 0)
+        throw SqlException("Function sequence error", "HY010");
+
+    const auto param_idx = data_at_exec_params[data_at_exec_params_requested - 1];
+    const auto c_type = getParamsBindingInfo(0)[param_idx].c_type;
+
+    if (data_size == SQL_NULL_DATA) {
+        if (param_idx == streamed_param)
+            throw SqlException("Optional feature not implemented", "HYC00");
+
+        auto & value = data_at_exec_values[param_idx];
+
+        if (!value || !value->empty())
+            throw SqlException("Attempt to concatenate a null value", "HY020");
+
+        value.reset();
+        return;
+    }
+
+    if (!data && data_size != 0)
+        throw SqlException("Invalid use of null pointer", "HY009");
+
+    if (data_size == SQL_NTS) {
+        if (c_type == SQL_C_WCHAR) {
+            const auto * wstr = reinterpret_cast<const SQLWCHAR *>(data);
+            std::size_t length = 0;
+
+            while (wstr[length] != 0)
+                ++length;
+
+            data_size = length * sizeof(SQLWCHAR);
+        }
+        else {
+            data_size = std::strlen(reinterpret_cast<const char *>(data));
+        }
+    }
+    else if (data_size < 0) {
+        throw SqlException("Invalid string or buffer length", "HY090");
+    }
+
+    if (param_idx == streamed_param) {
+        if (c_type == SQL_C_WCHAR) {
+            // A piece of data may end in the middle of a character, so an incomplete code unit, or the high surrogate of a pair,
+            // is kept and converted together with the next piece.
+            std::string_view bytes(reinterpret_cast<const char *>(data), data_size);
+            if (!streamed_wchar_tail.empty()) {
+                streamed_wchar_tail.append(bytes.data(), bytes.size());
+                bytes = streamed_wchar_tail;
+            }
+
+            auto length = bytes.size() / sizeof(SQLWCHAR);
+            if constexpr (sizeof(SQLWCHAR) == 2) {
+                SQLWCHAR last = 0;
+                if (length > 0)
+                    std::memcpy(&last, bytes.data() + (length - 1) * sizeof(SQLWCHAR), sizeof(SQLWCHAR));
+                if (last >= 0xD800 && last <= 0xDBFF)
+                    --length;
+            }
+
+            const auto chunk = toUTF8(reinterpret_cast<const SQLWCHAR *>(bytes.data()), length);
+            request_body->write(chunk.data(), chunk.size());
+
+            std::string tail(bytes.substr(length * sizeof(SQLWCHAR)));
+            streamed_wchar_tail = std::move(tail);
+        }
+        else {
+            request_body->write(reinterpret_cast<const char *>(data), data_size);
+        }
+
+        if (!*request_body)
+            throw std::runtime_error("Failed to send the data of a data-at-execution parameter");
+
+        return;
+    }
+
+    auto & value = data_at_exec_values[param_idx];
+
+    if (!value)
+        throw SqlException("Attempt to concatenate a null value", "HY020");
+
+    // The length is ignored for fixed-size types, and the last piece of data supplied for them is used.
+    const auto octet_length = getCTypeOctetLength(c_type);
+
+    if (octet_length > 0)
+        value->assign(reinterpret_cast<const char *>(data), octet_length);
+    else
+        value->append(reinterpret_cast<const char *>(data), data_size);
+}
+
+void Statement::requestNextPackOfResultSets(std::unique_ptr<ResultMutator> && mutator) {
+    result_reader.reset();
+
+    // The buffered rows are sent before any other query, so that it sees them.
+    flushInsertBatch();
+
+    const auto param_set_array_size = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
+    // The session is not needed anymore, once all parameter sets are processed.
+    if (next_param_set >= param_set_array_size) {
+        releaseSession();
+        return;
+    }
+
+    // Send all parameter sets of a plain INSERT ... VALUES (?, ...) query in a single request, as a multi-row VALUES clause.
+    std::string insert_values_prefix;
+    const auto param_set_count = (
+        (next_param_set == 0 && param_set_array_size > 1 && extractInsertValuesPrefix(insert_values_prefix)) ?
+        param_set_array_size : 1
+    );
+
+    setRowCount(0);
+
+    auto & connection = getParent();
+
+    releaseSession();
+
+    if (connection.isNativeProtocol()) {
+        sendNativeQuery(insert_values_prefix, param_set_count, std::move(mutator));
+        return;
+    }
+
+    auto uri = connection.buildURI();
+
+    std::string prepared_query;
+    std::string multipart_boundary;
+    std::ifstream insert_file_stream;
+    std::streamsize insert_file_size = 0;
+    std::string body_encoding;
+
+    if (param_set_count > 1) {
+        const auto param_bind_type = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_BIND_TYPE, SQL_PARAM_BIND_BY_COLUMN);
+
+        // Column-wise bound parameter arrays are sent as Native blocks, the query itself is passed in the URL then.
+        if (param_bind_type == SQL_PARAM_BIND_BY_COLUMN) {
+            std::string insert_query;
+            prepared_query = buildNativeInsertBody(insert_values_prefix, param_set_count, insert_query);
+
+            if (!prepared_query.empty()) {
+                uri.addQueryParameter("query", insert_query);
+                body_encoding = connection.getRequestEncoding(prepared_query.size());
+            }
+        }
+        else {
+            prepared_query = buildBatchInsertQuery(insert_values_prefix, param_set_count);
+            body_encoding = connection.getRequestEncoding(prepared_query.size());
+        }
+
+        if (prepared_query.empty()) {
+            setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_UNUSED);
+            next_param_set += param_set_count;
+            return;
+        }
+    }
+    else {
+        const auto param_bindings = getParamsBindingInfo(next_param_set);
+        const auto params_size = estimateParamsSize(param_bindings);
+        prepareInListTables(param_bindings);
+
+        if (!insert_file.empty()) {
+            // The file is sent as the request body, so the query and the parameters are passed in the URL.
+            if (!in_list_tables.empty())
+                throw SqlException("Optional feature not implemented", "HYC00");
+
+            auto final_query = buildFinalQuery(param_bindings);
+
+            const auto format = getAttrAs<std::string>(CH_SQL_ATTR_INSERT_FILE_FORMAT);
+            if (!format.empty()) {
+                while (!final_query.empty() && (final_query.back() == ';' || std::isspace(static_cast<unsigned char>(final_query.back()))))
+                    final_query.pop_back();
+
+                final_query += " FORMAT " + format;
+            }
+
+            insert_file_stream = openFileForSending(insert_file, insert_file_size);
+            uri.addQueryParameter("query", final_query);
+            addParamsToURI(uri, param_bindings);
+
+            // A file, that is already compressed, is sent as is.
+            if (getAttrAs<std::string>(CH_SQL_ATTR_INSERT_FILE_ENCODING).empty())
+                body_encoding = connection.getRequestEncoding(insert_file_size);
+        }
+        else if (!in_list_tables.empty() || params_size > max_params_size_in_url) {
+            // Large parameter values are sent in the request body, to keep the URL short, and avoid URL-encoding them.
+            // External tables, that hold the values of long IN lists, can be sent only in the request body too.
+            // The query is written into the body along with them, when the body is sent.
+            multipart_boundary = Poco::Net::MultipartWriter::createBoundary();
+            body_encoding = connection.getRequestEncoding(query.size() + params_size);
+
+            for (const auto & table : in_list_tables) {
+                uri.addQueryParameter(table.name + "_structure", "x " + table.type);
+                uri.addQueryParameter(table.name + "_format", "TabSeparated");
+            }
+        }
+        else {
+            addParamsToURI(uri, param_bindings);
+            prepared_query = buildFinalQuery(param_bindings);
+            body_encoding = connection.getRequestEncoding(prepared_query.size());
+        }
+    }
+
+    // TODO: set this only after this single query is fully fetched (when output parameter support is added)
+    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
+    if (param_set_processed_ptr)
+        *param_set_processed_ptr = next_param_set + param_set_count;
+
+    // The statuses are set to success only when the request succeeds.
+    setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_ERROR);
+
+    Poco::Net::HTTPRequest request;
+    const auto query_id = prepareQueryRequest(uri, request, true);
+    request.setChunkedTransferEncoding(true);
+    connection.requestCompressedResponse(request);
+
+    if (!multipart_boundary.empty())
+        request.setContentType("multipart/form-data; boundary=" + multipart_boundary);
+
+    if (insert_file_stream.is_open()) {
+        const auto encoding = getAttrAs<std::string>(CH_SQL_ATTR_INSERT_FILE_ENCODING);
+        if (!encoding.empty())
+            request.set("Content-Encoding", encoding);
+
+        // The size of the body is known in advance, unless it is compressed on the fly.
+        if (body_encoding.empty()) {
+            request.setChunkedTransferEncoding(false);
+            request.setContentLength(insert_file_size);
+        }
+    }
+
+    if (!body_encoding.empty())
+        request.set("Content-Encoding", body_encoding);
+
+    const FlagGuard executing_guard(is_executing);
+    is_canceled = false;
+
+    session = connection.borrowSession(query_kind);
+
+    LOG(request.getMethod() << " " << session->getHost() << request.getURI() << " body=" << prepared_query
+                            << " UA=" << request.get("User-Agent"));
+
+    // LOG("curl 'http://" << session->getHost() << ":" << session->getPort() << request.getURI() << "' -d '" << prepared_query << "'");
+
+    int redirect_count = 0;
+    // Send request to server with finite count of retries.
+    for (int i = 1;; ++i) {
+        try {
+            for (; redirect_count < connection.redirect_limit; ++redirect_count) {
+                // The header is set by the session to its own host, which may differ between the attempts.
+                request.erase("Host");
+                setRunningQuery(query_id, session->getHost(), session->getPort());
+                RequestBodyWriter body(session->sendRequest(request), body_encoding);
+
+                if (insert_file_stream.is_open()) {
+                    insert_file_stream.clear();
+                    insert_file_stream.seekg(0);
+                    copyStream(insert_file_stream, body.get());
+                }
+                else if (multipart_boundary.empty()) {
+                    body.get() << prepared_query;
+                }
+                else {
+                    writeParamsAsMultipart(body.get(), multipart_boundary, getParamsBindingInfo(next_param_set));
+                }
+
+                body.finish();
+
+                response = std::make_unique<Poco::Net::HTTPResponse>();
+                in = &session->receiveResponse(*response);
+                auto status = response->getStatus();
+                if (status != Poco::Net::HTTPResponse::HTTP_PERMANENT_REDIRECT && status != Poco::Net::HTTPResponse::HTTP_TEMPORARY_REDIRECT) {
+                    break;
+                }
+                session->reset(); // reset keepalived connection
+                auto newLocation = response->get("Location");
+                LOG("Redirected to " << newLocation << ", redirect index=" << redirect_count + 1 << "/" << connection.redirect_limit);
+                uri = newLocation;
+                session->setHost(uri.getHost());
+                session->setPort(uri.getPort());
+                request.setURI(uri.getPathEtc());
+            }
+            break;
+        } catch (const Poco::IOException & e) {
+            session->reset(); // reset keepalived connection
+            LOG("Http request try=" << i << "/" << connection.retry_count << " failed: " << e.what() << ": " << e.message());
+            if (is_canceled)
+                throw SqlException("Operation canceled", "HY008");
+
+            if (i > connection.retry_count)
+                throw;
+
+            // The request is retried with another session, that may be to another server.
+            response.reset();
+            in = nullptr;
+            connection.returnSession(std::move(session));
+            session = connection.borrowSession(query_kind);
+        }
+    }
+
+    processResponse(std::move(mutator));
+
+    setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_SUCCESS);
+    next_param_set += param_set_count;
+}
+
+void Statement::sendNativeQuery(const std::string & insert_values_prefix, std::size_t param_set_count, std::unique_ptr<ResultMutator> && mutator) {
+    auto & connection = getParent();
+
+    // Neither the files, nor the raw bodies of the responses, are there to be passed through over the native protocol.
+    if (!insert_file.empty() || getAttrAs<SQLULEN>(CH_SQL_ATTR_RAW_RESULT, SQL_FALSE) == SQL_TRUE)
+        throw SqlException("Optional feature not implemented", "HYC00");
+
+    // The revision of the protocol, that the client speaks, has no query parameters, so the values are a part of the query.
+    std::string prepared_query;
+
+    if (param_set_count > 1) {
+        prepared_query = buildBatchInsertQuery(insert_values_prefix, param_set_count);
+
+        if (prepared_query.empty()) {
+            setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_UNUSED);
+            next_param_set += param_set_count;
+            return;
+        }
+    }
+    else {
+        prepared_query = buildNativeFinalQuery(getParamsBindingInfo(next_param_set));
+    }
+
+    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
+    if (param_set_processed_ptr)
+        *param_set_processed_ptr = next_param_set + param_set_count;
+
+    // The statuses are set to success only when the query succeeds.
+    setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_ERROR);
+
+    // The query is identified, so that it can be killed on the server, when the statement is canceled from another thread.
+    const auto query_id = generateQueryId();
+
+    const FlagGuard executing_guard(is_executing);
+    is_canceled = false;
+
+    native_session = connection.borrowNativeSession(query_kind);
+
+    const auto & endpoint = native_session->getEndpoint();
+    setRunningQuery(query_id, endpoint.host, endpoint.port);
+
+    LOG("Native " << endpoint.host << ":" << endpoint.port << " query_id=" << query_id << " query=" << prepared_query);
+
+    // The structure of the results, or the exception, that the server has sent instead, is received by the reader right away.
+    try {
+        auto & client = native_session->getClient();
+        client.sendQuery(query_id, prepared_query);
+        native_in = makeNativeResultStream(client);
+        result_reader = make_result_reader("RowBinaryWithNamesAndTypes", *native_in, std::move(mutator), connection.decode_threads);
+    }
+    catch (...) {
+        if (is_canceled)
+            throw SqlException("Operation canceled", "HY008");
+
+        throw;
+    }
+
+    setParamSetStatuses(next_param_set, param_set_count, SQL_PARAM_SUCCESS);
+    next_param_set += param_set_count;
+}
+
+void Statement::processResponse(std::unique_ptr<ResultMutator> && mutator) {
+    auto & connection = getParent();
+
+    Poco::Net::HTTPResponse::HTTPStatus status = response->getStatus();
+
+    // The body of a successful response is read directly from the socket of the session, bypassing the stream buffers of Poco.
+    auto * body_source = dynamic_cast<ResponseBodySource *>(session.get());
+    if (status == Poco::Net::HTTPResponse::HTTP_OK && connection.zero_copy_read && body_source) {
+        direct_in = makeResponseBodyStream(*body_source, *response);
+        in = direct_in.get();
+    }
+
+    // The response is decompressed on the fly, if the server has compressed it.
+    decompressed_in = makeDecompressingStream(*in, response->get("Content-Encoding", ""), connection.decompress_thread);
+    auto & response_stream = (decompressed_in ? *decompressed_in : *in);
+
+    if (status != Poco::Net::HTTPResponse::HTTP_OK) {
+        // These are returned by the proxies and the servers, that are not able to process any requests at the moment.
+        if (
+            status == Poco::Net::HTTPResponse::HTTP_BAD_GATEWAY ||
+            status == Poco::Net::HTTPResponse::HTTP_SERVICE_UNAVAILABLE ||
+            status == Poco::Net::HTTPResponse::HTTP_GATEWAY_TIMEOUT
+        )
+            connection.reportSessionFailure(*session);
+
+        std::stringstream error_message;
+        if (status == Poco::Net::HTTPResponse::HTTP_TEMPORARY_REDIRECT || status == Poco::Net::HTTPResponse::HTTP_PERMANENT_REDIRECT) {
+            error_message << "Redirect count exceeded" << std::endl << "Redirect limit: " << connection.redirect_limit << std::endl;
+        } else {
+            error_message << "HTTP status code: " << status << std::endl << "Received error:" << std::endl << response_stream.rdbuf() << std::endl;
+        }
+        LOG(error_message.str());
+
+        if (is_canceled)
+            throw SqlException("Operation canceled", "HY008");
+
+        throw std::runtime_error(error_message.str());
+    }
+
+    if (getAttrAs<SQLULEN>(CH_SQL_ATTR_RAW_RESULT, SQL_FALSE) == SQL_TRUE)
+        result_reader = std::make_unique<RawPassthroughResultReader>(response_stream, std::move(mutator));
+    else
+        result_reader = make_result_reader(response->get("X-ClickHouse-Format", connection.default_format), response_stream, std::move(mutator), connection.decode_threads);
+}
+
+void Statement::addParamsToURI(Poco::URI & uri, const std::vector<ParamBindingInfo> & param_bindings) {
+    std::string value;
+
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        // The data of the streamed parameter is sent in the request body.
+        if (i == streamed_param || (i < param_in_in_list_table.size() && param_in_in_list_table[i]))
+            continue;
+
+        readParamValue(param_bindings, i, value);
+        uri.addQueryParameter("param_" + getParamFinalName(i), value);
+    }
+}
+
+void Statement::writeParamsAsMultipart(std::ostream & stream, const std::string & boundary, const std::vector<ParamBindingInfo> & param_bindings) {
+    Poco::Net::MultipartWriter writer(stream, boundary);
+    std::string value;
+
+    // The server concatenates the query from all the parts of this name.
+    {
+        Poco::Net::MessageHeader header;
+        header.set("Content-Disposition", "form-data; name=\"query\"");
+
+        writer.nextPart(header);
+        writeFinalQuery(stream, param_bindings);
+    }
+
+    // Each value is converted and written right away, so that no copy of all the values is assembled in memory.
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        if (i < param_in_in_list_table.size() && param_in_in_list_table[i])
+            continue;
+
+        readParamValue(param_bindings, i, value);
+
+        Poco::Net::MessageHeader header;
+        header.set("Content-Disposition", "form-data; name=\"param_" + getParamFinalName(i) + "\"");
+
+        writer.nextPart(header);
+        stream.write(value.data(), value.size());
+    }
+
+    // Parts with a file name are interpreted as external tables by the server.
+    for (std::size_t i = 0; i < in_list_tables.size(); ++i) {
+        const auto & table_name = in_list_tables[i].name;
+
+        Poco::Net::MessageHeader header;
+        header.set("Content-Disposition", "form-data; name=\"" + table_name + "\"; filename=\"" + table_name + "\"");
+
+        writer.nextPart(header);
+        writeInListTable(stream, param_bindings, i);
+    }
+
+    writer.close();
+}
+
+std::size_t Statement::estimateParamsSize(const std::vector<ParamBindingInfo> & param_bindings) const {
+    std::size_t size = 0;
+
+    for (std::size_t i = 0; i < param_bindings.size() && i < parameters.size(); ++i) {
+        const auto & binding_info = param_bindings[i];
+
+        const auto data_at_exec_value_it = data_at_exec_values.find(i);
+        if (data_at_exec_value_it != data_at_exec_values.end()) {
+            size += (data_at_exec_value_it->second ? data_at_exec_value_it->second->size() : 0);
+            continue;
+        }
+
+        if (binding_info.value == nullptr || (binding_info.indicator && *binding_info.indicator == SQL_NULL_DATA))
+            continue;
+
+        const auto octet_length = getCTypeOctetLength(binding_info.c_type);
+        if (octet_length > 0) {
+            size += octet_length;
+            continue;
+        }
+
+        const auto * sz_ptr = (binding_info.indicator && *binding_info.indicator > 0 ? binding_info.indicator : binding_info.value_size);
+
+        if (sz_ptr && *sz_ptr > 0) {
+            size += *sz_ptr;
+        }
+        else if (binding_info.c_type == SQL_C_WCHAR) {
+            const auto * wstr = reinterpret_cast<const SQLWCHAR *>(binding_info.value);
+            while (*wstr++ != 0)
+                size += sizeof(SQLWCHAR);
+        }
+        else {
+            size += std::strlen(reinterpret_cast<const char *>(binding_info.value));
+        }
+    }
+
+    return size;
+}
+
+void Statement::readParamValue(const std::vector<ParamBindingInfo> & param_bindings, std::size_t param_idx, std::string & value) {
+    if (param_bindings.size() <= param_idx) {
+        value = "Null";
+        return;
+    }
+
+    const auto & binding_info = param_bindings[param_idx];
+
+    if (!isInputParam(binding_info.io_type) || isStreamParam(binding_info.io_type))
+        throw std::runtime_error("Unable to extract data from bound param buffer: param IO type is not supported");
+
+    const auto data_at_exec_value_it = data_at_exec_values.find(param_idx);
+
+    if (data_at_exec_value_it != data_at_exec_values.end()) {
+        const auto & data_at_exec_value = data_at_exec_value_it->second;
+
+        // Zero-terminated, in case the value is empty and gets interpreted as a null-terminated string.
+        auto buffer = data_at_exec_value.value_or(std::string{});
+        buffer.append(sizeof(SQLWCHAR), '\0');
+
+        SQLLEN buffer_size = (data_at_exec_value ? data_at_exec_value->size() : SQL_NULL_DATA);
+
+        BindingInfo buffer_binding_info = binding_info;
+        buffer_binding_info.value = &buffer[0];
+        buffer_binding_info.value_size = &buffer_size;
+        buffer_binding_info.indicator = &buffer_size;
+
+        readReadyDataTo(buffer_binding_info, value);
+    }
+    else if (binding_info.value == nullptr) {
+        value = "Null";
+    }
+    else {
+        readReadyDataTo(binding_info, value);
+    }
+}
+
+std::vector<std::size_t> Statement::findDataAtExecParams(const std::vector<ParamBindingInfo> & param_bindings) const {
+    std::vector<std::size_t> param_indices;
+
+    for (std::size_t i = 0; i < param_bindings.size() && i < parameters.size(); ++i) {
+        const auto & binding_info = param_bindings[i];
+
+        if (
+            binding_info.indicator &&
+            (*binding_info.indicator == SQL_DATA_AT_EXEC || *binding_info.indicator <= SQL_LEN_DATA_AT_EXEC_OFFSET)
+        ) {
+            param_indices.push_back(i);
+        }
+    }
+
+    return param_indices;
+}
+
+void Statement::startStreamedDataAtExecRequest() {
+    std::string insert_values_prefix;
+    if (!extractInsertValuesPrefix(insert_values_prefix))
+        throw std::runtime_error("Unable to stream data-at-execution parameter: not an INSERT ... VALUES query");
+
+    const auto param_bindings = getParamsBindingInfo(0);
+
+    // The streamed value is read from the request body as a single String value, all other parameters stay query parameters.
+    std::string select_list;
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        if (i > 0)
+            select_list += ", ";
+
+        if (i == streamed_param)
+            select_list += "odbc_data_at_exec";
+        else
+            select_list += "{" + getParamFinalName(i) + ":" + getParamType(param_bindings, i) + "}";
+    }
+
+    insert_values_prefix.resize(insert_values_prefix.size() - std::strlen("VALUES"));
+    const auto insert_query = insert_values_prefix + "SELECT " + select_list + " FROM input('odbc_data_at_exec String') FORMAT RawBLOB";
+
+    auto & connection = getParent();
+
+    releaseSession();
+
+    setRowCount(0);
+
+    auto uri = connection.buildURI();
+    addParamsToURI(uri, param_bindings);
+    uri.addQueryParameter("query", insert_query);
+
+    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
+    if (param_set_processed_ptr)
+        *param_set_processed_ptr = 1;
+
+    // The statuses are set to success only when the request succeeds.
+    setParamSetStatuses(0, 1, SQL_PARAM_ERROR);
+
+    Poco::Net::HTTPRequest request;
+    const auto query_id = prepareQueryRequest(uri, request, true);
+    request.setChunkedTransferEncoding(true);
+    connection.requestCompressedResponse(request);
+
+    session = connection.borrowSession(QueryKind::Write);
+    setRunningQuery(query_id, session->getHost(), session->getPort());
+
+    LOG(request.getMethod() << " " << session->getHost() << request.getURI() << " body=<data-at-execution parameter data>"
+                            << " UA=" << request.get("User-Agent"));
+
+    // The body is not retained, so neither retries nor redirects are possible for this request.
+    request_body = &session->sendRequest(request);
+}
+
+void Statement::finishStreamedDataAtExecRequest(std::unique_ptr<ResultMutator> && mutator) {
+    // A high surrogate, that was not followed by the rest of its pair, is converted on its own.
+    if (streamed_wchar_tail.size() >= sizeof(SQLWCHAR)) {
+        const auto chunk = toUTF8(reinterpret_cast<const SQLWCHAR *>(streamed_wchar_tail.data()), streamed_wchar_tail.size() / sizeof(SQLWCHAR));
+        request_body->write(chunk.data(), chunk.size());
+
+        if (!*request_body)
+            throw std::runtime_error("Failed to send the data of a data-at-execution parameter");
+    }
+
+    streamed_wchar_tail.clear();
+    request_body = nullptr;
+    response = std::make_unique<Poco::Net::HTTPResponse>();
+    in = &session->receiveResponse(*response);
+
+    processResponse(std::move(mutator));
+
+    setParamSetStatuses(0, 1, SQL_PARAM_SUCCESS);
+    next_param_set = 1;
+}
+
+void Statement::resetDataAtExecState() {
+    // A partially sent request body can't be finished, so the connection is dropped.
+    if (request_body) {
+        if (session)
+            session->reset();
+        request_body = nullptr;
+    }
+
+    need_data = false;
+    data_at_exec_params.clear();
+    data_at_exec_params_requested = 0;
+    data_at_exec_values.clear();
+    streamed_param = std::numeric_limits<std::size_t>::max();
+    streamed_wchar_tail.clear();
+    data_at_exec_mutator.reset();
+}
+
+bool Statement::tryAddToInsertBatch() {
+    auto & connection = getParent();
+
+    // The batches are sent over HTTP only.
+    if (connection.insert_batch_rows == 0 || connection.isNativeProtocol())
+        return false;
+
+    const auto param_set_array_size = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
+    if (param_set_array_size != 1)
+        return false;
+
+    std::string insert_values_prefix;
+    if (!extractInsertValuesPrefix(insert_values_prefix))
+        return false;
+
+    const auto param_bindings = getParamsBindingInfo(0);
+
+    std::vector<ColumnInfo> columns_info(parameters.size());
+    std::vector<BindingInfo> row_bindings(parameters.size());
+
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        if (i < param_bindings.size()) {
+            const auto & binding_info = param_bindings[i];
+
+            if (!isInputParam(binding_info.io_type) || isStreamParam(binding_info.io_type))
+                return false;
+
+            row_bindings[i] = binding_info;
+        }
+
+        auto & column_info = columns_info[i];
+        column_info.name = "odbc_param_" + std::to_string(i + 1);
+        column_info.type = getParamType(param_bindings, i);
+
+        TypeParser parser{column_info.type};
+        TypeAst ast;
+
+        if (parser.parse(&ast))
+            column_info.assignTypeInfo(ast);
+
+        column_info.updateTypeInfo();
+
+        // NULL values are accepted regardless of the nullability of the parameter, the same way the server does that for VALUES.
+        column_info.is_nullable = true;
+    }
+
+    RowBinaryWriter writer(columns_info);
+
+    const auto values_keyword_size = std::strlen("VALUES");
+    auto insert_query = insert_values_prefix.substr(0, insert_values_prefix.size() - values_keyword_size) + "SELECT * FROM input('" +
+        escapeForSQL(writer.getStructure()) + "') FORMAT RowBinary";
+
+    // Rows of a different query, or of the same query with parameters bound differently, can't be sent in the same batch.
+    if (insert_batch_writer && insert_batch_query != insert_query)
+        flushInsertBatch();
+
+    if (!insert_batch_writer) {
+        insert_batch_writer = std::make_unique<RowBinaryWriter>(std::move(writer));
+        insert_batch_query = std::move(insert_query);
+        insert_batch_start_time = std::chrono::steady_clock::now();
+    }
+
+    // Don't leave a partially encoded row in the batch.
+    const auto batch_size = insert_batch.size();
+    try {
+        insert_batch_writer->writeRow(row_bindings, insert_batch);
+    }
+    catch (...) {
+        insert_batch.resize(batch_size);
+        throw;
+    }
+
+    ++insert_batch_row_count;
+
+    result_reader.reset();
+    next_param_set = 1;
+
+    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
+    if (param_set_processed_ptr)
+        *param_set_processed_ptr = 1;
+
+    // The statuses are set to success only when the row is buffered, or the batch is sent, if it is full.
+    setParamSetStatuses(0, 1, SQL_PARAM_ERROR);
+
+    if (
+        insert_batch_row_count >= connection.insert_batch_rows ||
+        insert_batch.size() >= connection.insert_batch_bytes ||
+        std::chrono::steady_clock::now() - insert_batch_start_time >= std::chrono::seconds(connection.insert_batch_timeout)
+    ) {
+        flushInsertBatch();
+    }
+
+    setParamSetStatuses(0, 1, SQL_PARAM_SUCCESS);
+    setRowCount(1);
+
+    return true;
+}
+
+void Statement::processEscapeSequences() {
+    if (getAttrAs<SQLULEN>(SQL_ATTR_NOSCAN, SQL_NOSCAN_OFF) != SQL_NOSCAN_ON)
+        query = replaceEscapeSequences(query);
+}
+
+void Statement::extractParametersinfo() {
+    auto & apd_desc = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC);
+    auto & ipd_desc = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC);
+
+    const auto apd_record_count = apd_desc.getRecordCount();
+    auto ipd_record_count = ipd_desc.getRecordCount();
+
+    // Reset IPD records but preserve possible info set by SQLBindParameter.
+    ipd_record_count = std::min(ipd_record_count, apd_record_count);
+    ipd_desc.setAttr(SQL_DESC_COUNT, ipd_record_count);
+
+    // TODO: implement this all in an upgraded Lexer.
+
+    // The markers are extracted only once here, so that each execution only has to render the final query.
+    parameters = extractQueryParameters(query);
+
+    ipd_record_count = std::max(ipd_record_count, parameters.size());
+    ipd_desc.setAttr(SQL_DESC_COUNT, ipd_record_count);
+}
+
+void Statement::prepareInListTables(const std::vector<ParamBindingInfo>& param_bindings) {
+    in_list_tables.clear();
+    param_in_in_list_table.assign(parameters.size(), false);
+
+    const auto in_list_threshold = getParent().in_list_threshold;
+    if (in_list_threshold > 0)
+        findInLists(param_bindings, in_list_threshold);
+}
+
+std::string Statement::buildFinalQuery(const std::vector<ParamBindingInfo>& param_bindings) {
+    std::string prepared_query;
+    prepared_query.reserve(query.size() + parameters.size() * 32);
+
+    std::size_t next_in_list_table = 0;
+
+    renderQuery(prepared_query, query, parameters, [&] (std::size_t param_idx, std::string & dest) {
+        return renderParamPlaceholder(param_bindings, param_idx, next_in_list_table, dest);
+    });
+
+    return prepared_query;
+}
+
+void Statement::writeFinalQuery(std::ostream & stream, const std::vector<ParamBindingInfo>& param_bindings) {
+    std::size_t next_in_list_table = 0;
+    std::string placeholder;
+
+    renderQuery(stream, query, parameters, [&] (std::size_t param_idx, std::ostream & dest) {
+        placeholder.clear();
+        const auto rendered = renderParamPlaceholder(param_bindings, param_idx, next_in_list_table, placeholder);
+        dest.write(placeholder.data(), placeholder.size());
+        return rendered;
+    });
+}
+
+std::size_t Statement::renderParamPlaceholder(const std::vector<ParamBindingInfo>& param_bindings, std::size_t param_idx, std::size_t & next_in_list_table, std::string & dest) {
+    if (next_in_list_table < in_list_tables.size() && in_list_tables[next_in_list_table].first_param == param_idx) {
+        const auto & table = in_list_tables[next_in_list_table++];
+        dest += "SELECT x FROM ";
+        dest += table.name;
+        return table.param_count;
+    }
+
+    dest += '{';
+    dest += getParamFinalName(param_idx);
+    dest += ':';
+    dest += getParamType(param_bindings, param_idx);
+    dest += '}';
+    return 1;
+}
+
+std::string Statement::buildNativeFinalQuery(const std::vector<ParamBindingInfo>& param_bindings) {
+    in_list_tables.clear();
+    param_in_in_list_table.assign(parameters.size(), false);
+
+    std::string prepared_query;
+    prepared_query.reserve(query.size() + parameters.size() * 32);
+
+    std::string value;
+
+    // The values are converted from their text form the same way the server does that for the query parameters.
+    renderQuery(prepared_query, query, parameters, [&] (std::size_t param_idx, std::string & dest) -> std::size_t {
+        const auto data_at_exec_value_it = data_at_exec_values.find(param_idx);
+
+        const bool is_null = (
+            param_bindings.size() <= param_idx || (
+                data_at_exec_value_it != data_at_exec_values.end() ? !data_at_exec_value_it->second : (
+                    param_bindings[param_idx].value == nullptr ||
+                    (param_bindings[param_idx].indicator && (
+                        *param_bindings[param_idx].indicator == SQL_NULL_DATA ||
+                        *param_bindings[param_idx].indicator == SQL_DEFAULT_PARAM
+                    ))
+                )
+            )
+        );
+
+        if (is_null) {
+            dest += "NULL";
+            return 1;
+        }
+
+        readParamValue(param_bindings, param_idx, value);
+
+        dest += "CAST('";
+        dest += escapeForSQL(value);
+        dest += "' AS ";
+        dest += getParamType(param_bindings, param_idx);
+        dest += ')';
+        return 1;
+    });
+
+    return prepared_query;
+}
+
+void Statement::findInLists(const std::vector<ParamBindingInfo>& param_bindings, std::size_t min_param_count) {
+    // Checks that only a comma, possibly surrounded by spaces, is between the positions in the query text.
+    auto is_comma_separated = [&] (std::size_t begin, std::size_t end) {
+        begin = skipSpaces(query, begin);
+        return (begin < end && query[begin] == ',' && skipSpaces(query, begin + 1) >= end);
+    };
+
+    std::size_t i = 0;
+
+    while (i < parameters.size()) {
+        const auto list_begin = parameters[i].position;
+
+        // Look for "IN (" right before the parameter.
+        auto pos = list_begin;
+        while (pos > 0 && std::isspace(static_cast<unsigned char>(query[pos - 1])))
+            --pos;
+
+        if (pos == 0 || query[pos - 1] != '(') {
+            ++i;
+            continue;
+        }
+
+        --pos;
+        while (pos > 0 && std::isspace(static_cast<unsigned char>(query[pos - 1])))
+            --pos;
+
+        if (pos < 2 || !startsWithNoCase(query, pos - 2, "IN") || (pos > 2 && isIdentifierChar(query[pos - 3]))) {
+            ++i;
+            continue;
+        }
+
+        // The list must consist of consecutive parameters only.
+        std::size_t j = i + 1;
+        while (j < parameters.size() && is_comma_separated(parameters[j - 1].position, parameters[j].position))
+            ++j;
+
+        const auto first_param = i;
+        i = j;
+
+        pos = skipSpaces(query, parameters[j - 1].position);
+        if (pos >= query.size() || query[pos] != ')' || j - first_param < min_param_count)
+            continue;
+
+        // All the values must be of the same type.
+        const auto type = getParamType(param_bindings, first_param);
+        bool same_type = true;
+
+        for (std::size_t k = first_param + 1; k < j && same_type; ++k) {
+            same_type = (getParamType(param_bindings, k) == type);
+        }
+
+        if (!same_type)
+            continue;
+
+        InListTable table;
+        table.name = "odbc_in_list_" + std::to_string(in_list_tables.size() + 1);
+        table.type = type;
+        table.first_param = first_param;
+        table.param_count = j - first_param;
+
+        for (std::size_t k = first_param; k < j; ++k) {
+            param_in_in_list_table[k] = true;
+        }
+
+        in_list_tables.emplace_back(std::move(table));
+    }
+}
+
+void Statement::writeInListTable(std::ostream & stream, const std::vector<ParamBindingInfo>& param_bindings, std::size_t table_idx) {
+    const auto & table = in_list_tables[table_idx];
+    const bool is_nullable = startsWithNoCase(table.type, 0, "NULLABLE(");
+
+    std::string value;
+    std::string line;
+
+    for (std::size_t i = table.first_param; i < table.first_param + table.param_count; ++i) {
+        const bool is_null = (
+            param_bindings.size() <= i ||
+            param_bindings[i].value == nullptr ||
+            (param_bindings[i].indicator && *param_bindings[i].indicator == SQL_NULL_DATA)
+        );
+
+        // Non-nullable values are sent exactly as they would be sent as query parameters.
+        if (is_null && is_nullable) {
+            line = "\\N";
+        }
+        else {
+            readParamValue(param_bindings, i, value);
+            line = escapeForTSV(value);
+        }
+
+        line += '\n';
+        stream.write(line.data(), line.size());
+    }
+}
+
+std::string Statement::getParamType(const std::vector<ParamBindingInfo>& param_bindings, std::size_t param_idx) {
+    if (param_bindings.size() <= param_idx)
+        return "Nullable(Nothing)";
+
+    const auto & binding_info = param_bindings[param_idx];
+
+    BoundTypeInfo type_info;
+    type_info.c_type = binding_info.c_type;
+    type_info.sql_type = binding_info.sql_type;
+    type_info.value_max_size = binding_info.value_max_size;
+    type_info.precision = binding_info.precision;
+    type_info.scale = binding_info.scale;
+    type_info.is_nullable = (binding_info.is_nullable || binding_info.value == nullptr);
+
+    return convertSQLOrCTypeToDataSourceType(type_info);
+}
+
+bool Statement::extractInsertValuesPrefix(std::string & prefix) const {
+    if (parameters.empty())
+        return false;
+
+    auto pos = skipSpaces(query, 0);
+    if (!startsWithNoCase(query, pos, "INSERT"))
+        return false;
+
+    // The parameters must form the only tuple of the VALUES clause, in the same order as they appear in the query.
+    const auto tuple_begin = parameters.front().position;
+
+    auto values_end = tuple_begin;
+    while (values_end > 0 && std::isspace(static_cast<unsigned char>(query[values_end - 1])))
+        --values_end;
+
+    if (values_end == 0 || query[values_end - 1] != '(')
+        return false;
+
+    --values_end;
+    while (values_end > 0 && std::isspace(static_cast<unsigned char>(query[values_end - 1])))
+        --values_end;
+
+    const auto values_keyword_size = std::strlen("VALUES");
+    if (values_end < values_keyword_size || !startsWithNoCase(query, values_end - values_keyword_size, "VALUES"))
+        return false;
+
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        const auto next_param_pos = (i + 1 < parameters.size() ? parameters[i + 1].position : query.size());
+        pos = skipSpaces(query, parameters[i].position);
+
+        if (pos >= next_param_pos || query[pos] != (i + 1 < parameters.size() ? ',' : ')'))
+            return false;
+
+        pos = skipSpaces(query, pos + 1);
+
+        if (i + 1 < parameters.size() && pos < next_param_pos)
+            return false;
+    }
+
+    if (pos < query.size() && query[pos] == ';')
+        pos = skipSpaces(query, pos + 1);
+
+    if (pos != query.size())
+        return false;
+
+    prefix = query.substr(0, values_end);
+    return true;
+}
+
+std::string Statement::extractSelectTableName() const {
+    if (!startsWithNoCase(query, skipSpaces(query, 0), "SELECT"))
+        throw std::runtime_error("Unable to perform bulk operation: not a SELECT query");
+
+    // Find the first FROM keyword, that is not quoted and not nested in parentheses.
+    std::size_t pos = 0;
+    std::size_t depth = 0;
+    char quoted_by = '\0';
+
+    for (; pos < query.size(); ++pos) {
+        const char curr = query[pos];
+
+        if (quoted_by != '\0') {
+            if (curr == '\\')
+                ++pos;
+            else if (curr == quoted_by)
+                quoted_by = '\0';
+        }
+        else if (curr == '\'' || curr == '"' || curr == '`') {
+            quoted_by = curr;
+        }
+        else if (curr == '(') {
+            ++depth;
+        }
+        else if (curr == ')') {
+            if (depth > 0)
+                --depth;
+        }
+        else if (
+            depth == 0 &&
+            startsWithNoCase(query, pos, "FROM") &&
+            (pos == 0 || !isIdentifierChar(query[pos - 1])) &&
+            (pos + 4 >= query.size() || !isIdentifierChar(query[pos + 4]))
+        ) {
+            break;
+        }
+    }
+
+    if (pos >= query.size())
+        throw std::runtime_error("Unable to perform bulk operation: unable to deduce the table name from the query");
+
+    // Read the table name, optionally qualified by the database name, and return it as is, including the quotes, if any.
+    const auto name_begin = skipSpaces(query, pos + 4);
+    pos = name_begin;
+
+    for (int part = 0; part < 2; ++part) {
+        if (pos < query.size() && (query[pos] == '`' || query[pos] == '"')) {
+            const auto closing_pos = query.find(query[pos], pos + 1);
+
+            if (closing_pos == std::string::npos)
+                throw std::runtime_error("Unable to perform bulk operation: unable to deduce the table name from the query");
+
+            pos = closing_pos + 1;
+        }
+        else {
+            while (pos < query.size() && isIdentifierChar(query[pos]))
+                ++pos;
+        }
+
+        if (pos >= query.size() || query[pos] != '.')
+            break;
+
+        ++pos;
+    }
+
+    // Table functions and subqueries are not tables.
+    if (pos == name_begin || (pos < query.size() && query[skipSpaces(query, pos)] == '('))
+        throw std::runtime_error("Unable to perform bulk operation: unable to deduce the table name from the query");
+
+    return query.substr(name_begin, pos - name_begin);
+}
+
+std::string Statement::buildBatchInsertQuery(const std::string & prefix, std::size_t param_set_count) {
+    auto & apd_desc = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC);
+    const auto * param_operation_ptr = apd_desc.getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+
+    std::string batch_query = prefix;
+    batch_query.reserve(prefix.size() + param_set_count * parameters.size() * 8);
+
+    std::string value;
+    bool first_tuple = true;
+
+    for (std::size_t param_set_idx = 0; param_set_idx < param_set_count; ++param_set_idx) {
+        if (param_operation_ptr && param_operation_ptr[param_set_idx] == SQL_PARAM_IGNORE)
+            continue;
+
+        const auto param_bindings = getParamsBindingInfo(param_set_idx);
+
+        batch_query += (first_tuple ? " (" : ", (");
+        first_tuple = false;
+
+        for (std::size_t i = 0; i < parameters.size(); ++i) {
+            if (i > 0)
+                batch_query += ", ";
+
+            if (param_bindings.size() <= i) {
+                batch_query += "NULL";
+                continue;
+            }
+
+            const auto & binding_info = param_bindings[i];
+
+            if (!isInputParam(binding_info.io_type) || isStreamParam(binding_info.io_type))
+                throw std::runtime_error("Unable to extract data from bound param buffer: param IO type is not supported");
+
+            // NULL is inserted as a default value of the column by the server, unless the column is Nullable.
+            if (
+                binding_info.value == nullptr ||
+                (binding_info.indicator && (*binding_info.indicator == SQL_NULL_DATA || *binding_info.indicator == SQL_DEFAULT_PARAM))
+            ) {
+                batch_query += "NULL";
+                continue;
+            }
+
+            BoundTypeInfo type_info;
+            type_info.c_type = binding_info.c_type;
+            type_info.sql_type = binding_info.sql_type;
+            type_info.value_max_size = binding_info.value_max_size;
+            type_info.precision = binding_info.precision;
+            type_info.scale = binding_info.scale;
+            type_info.is_nullable = binding_info.is_nullable;
+
+            readReadyDataTo(binding_info, value);
+
+            // Numbers are inlined as is, so that the server parses the values quickly, without evaluating them as expressions,
+            // and everything else is quoted. The text of a numeric value is checked to be a number, so that it can't change the query.
+            if (isNumericType(convertSQLOrCTypeToDataSourceType(type_info)) && !isSpecialFloatLiteral(Poco::trimInPlace(value))) {
+                if (!isNumericLiteral(value))
+                    throw SqlException("Invalid character value for cast specification", "22018");
+
+                batch_query += value;
+                continue;
+            }
+
+            batch_query += '\'';
+            batch_query += escapeForSQL(value);
+            batch_query += '\'';
+        }
+
+        batch_query += ')';
+    }
+
+    // All parameter sets are ignored, nothing to insert.
+    if (first_tuple)
+        batch_query.clear();
+
+    return batch_query;
+}
+
+std::string Statement::buildNativeInsertBody(const std::string & prefix, std::size_t param_set_count, std::string & insert_query) {
+    auto & apd_desc = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC);
+    const auto * param_operation_ptr = apd_desc.getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+    const auto param_bindings = getParamsBindingInfo(0);
+
+    std::vector<ColumnInfo> columns_info(parameters.size());
+    std::vector<BindingInfo> column_bindings(parameters.size());
+
+    for (std::size_t i = 0; i < parameters.size(); ++i) {
+        auto & column_info = columns_info[i];
+        column_info.name = "odbc_param_" + std::to_string(i + 1);
+
+        // Unbound parameters are sent as NULLs.
+        if (param_bindings.size() <= i)
+            continue;
+
+        const auto & binding_info = param_bindings[i];
+
+        if (!isInputParam(binding_info.io_type) || isStreamParam(binding_info.io_type))
+            throw std::runtime_error("Unable to extract data from bound param buffer: param IO type is not supported");
+
+        column_info.type = getParamType(param_bindings, i);
+
+        TypeParser parser{column_info.type};
+        TypeAst ast;
+
+        if (parser.parse(&ast))
+            column_info.assignTypeInfo(ast);
+
+        column_info.updateTypeInfo();
+
+        // The bindings point to the first elements of the column-wise bound arrays.
+        column_bindings[i] = binding_info;
+        column_bindings[i].value_max_size = apd_desc.getRecord(i + 1, SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLLEN>(SQL_DESC_OCTET_LENGTH, 0);
+    }
+
+    NativeWriter writer(columns_info);
+    std::string body;
+
+    // Each run of consecutive parameter sets, that are not ignored, is sent as a separate block.
+    std::size_t first_param_set = 0;
+    for (std::size_t param_set_idx = 0; param_set_idx <= param_set_count; ++param_set_idx) {
+        if (
+            param_set_idx < param_set_count &&
+            (!param_operation_ptr || param_operation_ptr[param_set_idx] != SQL_PARAM_IGNORE)
+        ) {
+            continue;
+        }
+
+        if (param_set_idx > first_param_set)
+            writer.writeBlock(column_bindings, first_param_set, param_set_idx - first_param_set, body);
+
+        first_param_set = param_set_idx + 1;
+    }
+
+    // All parameter sets are ignored, nothing to insert.
+    if (body.empty())
+        return body;
+
+    // Values that are not natively encoded by the writer are converted to the actual column types by the server.
+    const auto values_keyword_size = std::strlen("VALUES");
+    insert_query = prefix.substr(0, prefix.size() - values_keyword_size) + "SELECT * FROM input('" +
+        escapeForSQL(writer.getStructure()) + "') FORMAT Native";
+
+    return body;
+}
+
+void Statement::setParamSetStatuses(std::size_t first_param_set, std::size_t param_set_count, SQLUSMALLINT status) {
+    auto * param_status_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+    if (!param_status_ptr)
+        return;
+
+    const auto * param_operation_ptr = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+
+    for (std::size_t i = first_param_set; i < first_param_set + param_set_count; ++i) {
+        if (param_operation_ptr && param_operation_ptr[i] == SQL_PARAM_IGNORE)
+            param_status_ptr[i] = SQL_PARAM_UNUSED;
+        else
+            param_status_ptr[i] = status;
+    }
+}
+
+void Statement::executeQuery(const std::string & q, std::unique_ptr<ResultMutator> && mutator) {
+    prepareQuery(q);
+    executeQuery(std::move(mutator));
+}
+
+void Statement::forwardExecuteQuery(std::unique_ptr<ResultMutator> && mutator) {
+    if (!is_prepared)
+        throw std::runtime_error("statement not prepared");
+
+    if (is_executed)
+        return;
+
+    // The execution can't be completed without the application supplying the data of data-at-execution parameters.
+    if (!findDataAtExecParams(getParamsBindingInfo(0)).empty())
+        return;
+
+    executeQuery(std::move(mutator));
+    is_forward_executed = true;
+}
+
+bool Statement::hasResultSet() const {
+    return (result_reader && result_reader->hasResultSet());
+}
+
+ResultSet & Statement::getResultSet() {
+    return result_reader->getResultSet();
+}
+
+bool Statement::advanceToNextResultSet() {
+    if (!is_executed)
+        return false;
+
+    setRowCount(0);
+
+    std::unique_ptr<ResultMutator> mutator;
+
+    if (result_reader) {
+        if (result_reader->advanceToNextResultSet())
+            return true;
+
+        mutator = result_reader->releaseMutator();
+    }
+
+    requestNextPackOfResultSets(std::move(mutator));
+    return hasResultSet();
+}
+
+BindingInfo Statement::getRowBindingInfo(const BindingInfo & binding_info, std::size_t row_idx) {
+    auto & ard_desc = getEffectiveDescriptor(SQL_ATTR_APP_ROW_DESC);
+
+    const auto single_row_struct_size = ard_desc.getAttrAs<SQLULEN>(SQL_DESC_BIND_TYPE, SQL_BIND_BY_COLUMN);
+    const auto * bind_offset_ptr = ard_desc.getAttrAs<SQLULEN *>(SQL_DESC_BIND_OFFSET_PTR, 0);
+    const auto bind_offset = (bind_offset_ptr ? *bind_offset_ptr : 0);
+
+    // In column-wise binding, the elements of the value arrays are of the size of the C type, or of the buffer length for character and binary types.
+    const auto octet_length = getCTypeOctetLength(binding_info.c_type);
+    const auto value_stride = (single_row_struct_size != SQL_BIND_BY_COLUMN ? single_row_struct_size :
+        octet_length > 0 ? octet_length : static_cast<std::size_t>(binding_info.value_max_size));
+    const auto indicator_stride = (single_row_struct_size != SQL_BIND_BY_COLUMN ? single_row_struct_size : sizeof(SQLLEN));
+
+    BindingInfo row_binding_info = binding_info;
+    row_binding_info.value = (void *)(binding_info.value ? ((char *)(binding_info.value) + bind_offset + row_idx * value_stride) : 0);
+    row_binding_info.value_size = (SQLLEN *)(binding_info.value_size ? ((char *)(binding_info.value_size) + bind_offset + row_idx * indicator_stride) : 0);
+    row_binding_info.indicator = (SQLLEN *)(binding_info.indicator ? ((char *)(binding_info.indicator) + bind_offset + row_idx * indicator_stride) : 0);
+
+    return row_binding_info;
+}
+
+void Statement::bulkAdd() {
+    if (!hasResultSet())
+        throw SqlException("Invalid cursor state", "24000");
+
+    // The rows are sent over HTTP only.
+    if (getParent().isNativeProtocol())
+        throw SqlException("Optional feature not implemented", "HYC00");
+
+    const auto & result_set = getResultSet();
+    const auto table_name = extractSelectTableName();
+
+    std::vector<ColumnInfo> columns_info;
+    std::vector<BindingInfo> bindings_per_column;
+
+    for (const auto & col_num_binding : bindings) {
+        if (col_num_binding.first < 1) // Bookmark column.
+            continue;
+
+        if (col_num_binding.first > result_set.getColumnCount())
+            throw SqlException("Invalid descriptor index", "07009");
+
+        columns_info.push_back(result_set.getColumnInfo(col_num_binding.first - 1));
+        bindings_per_column.push_back(col_num_binding.second);
+    }
+
+    if (columns_info.empty())
+        throw SqlException("Function sequence error", "HY010");
+
+    RowBinaryWriter writer(columns_info);
+
+    std::string column_list;
+    for (const auto & column_info : columns_info) {
+        if (!column_list.empty())
+            column_list += ", ";
+        column_list += '`' + escapeForSQL(column_info.name) + '`';
+    }
+
+    // Values that are not natively encoded by the writer are converted to the actual column types by the server.
+    const auto insert_query = "INSERT INTO " + table_name + " (" + column_list + ") SELECT * FROM input('" +
+        escapeForSQL(writer.getStructure()) + "') FORMAT RowBinary";
+
+    auto & ard_desc = getEffectiveDescriptor(SQL_ATTR_APP_ROW_DESC);
+    auto & ird_desc = getEffectiveDescriptor(SQL_ATTR_IMP_ROW_DESC);
+
+    const auto row_set_size = ard_desc.getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
+    const auto * row_operation_ptr = ard_desc.getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+    auto * row_status_ptr = ird_desc.getAttrAs<SQLUSMALLINT *>(SQL_DESC_ARRAY_STATUS_PTR, 0);
+
+    auto set_row_statuses = [&] (SQLUSMALLINT status) {
+        if (!row_status_ptr)
+            return;
+
+        for (std::size_t i = 0; i < row_set_size; ++i) {
+            if (!row_operation_ptr || row_operation_ptr[i] != SQL_ROW_IGNORE)
+                row_status_ptr[i] = status;
+        }
+    };
 
-Statement::Statement(Connection & connection)
-    : ChildType(connection)
-{
-    allocateImplicitDescriptors();
-}
+    auto & connection = getParent();
 
-Statement::~Statement() {
-    deallocateImplicitDescriptors();
-}
+    auto uri = connection.buildURI();
+    uri.addQueryParameter("query", insert_query);
 
-const TypeInfo & Statement::getTypeInfo(const std::string & type_name, const std::string & type_name_without_parameters) const {
-    return getParent().getParent().getTypeInfo(type_name, type_name_without_parameters);
-}
+    Poco::Net::HTTPRequest request;
+    const auto query_id = prepareQueryRequest(uri, request, false);
+    request.setChunkedTransferEncoding(true);
 
-void Statement::prepareQuery(const std::string & q) {
-    closeCursor();
-    query = q;
-    processEscapeSequences();
-    extractParametersinfo();
-    is_prepared = true;
-}
+    LOG(request.getMethod() << " " << connection.server << request.getURI() << " rows=" << row_set_size);
 
-bool Statement::isPrepared() const {
-    return is_prepared;
-}
+    // The current result set is still being read from the session of this statement, so another one is borrowed here.
+    auto bulk_session = connection.borrowSession(QueryKind::Write);
 
-bool Statement::isExecuted() const {
-    return is_executed;
-}
+    // The insert is killed, if the statement is canceled while it is being sent, and the query of the current result set is killed after it.
+    auto previous_query = setRunningQuery(query_id, bulk_session->getHost(), bulk_session->getPort());
+    ExitGuard running_query_guard([&] () { setRunningQuery(std::move(previous_query)); });
 
-void Statement::executeQuery(std::unique_ptr<ResultMutator> && mutator) {
-    if (!is_prepared)
-        throw std::runtime_error("statement not prepared");
+    // The statuses are set to success only when the request succeeds.
+    set_row_statuses(SQL_ROW_ERROR);
 
-    if (is_executed && is_forward_executed) {
-        is_forward_executed = false;
-        return;
+    std::vector<BindingInfo> row_bindings(bindings_per_column.size());
+    std::string chunk;
+    chunk.reserve(bulk_operation_chunk_size);
+    std::size_t added_row_count = 0;
+    std::optional<RequestBodyWriter> body;
+
+    // The total size of the body is not known in advance, so the size of the first chunk decides whether the body is compressed.
+    auto write_chunk = [&] () {
+        if (!body) {
+            const auto body_encoding = connection.getRequestEncoding(chunk.size());
+            if (!body_encoding.empty())
+                request.set("Content-Encoding", body_encoding);
+
+            body.emplace(bulk_session->sendRequest(request), body_encoding);
+        }
+
+        body->get().write(chunk.data(), chunk.size());
+        chunk.clear();
+    };
+
+    for (std::size_t row_idx = 0; row_idx < row_set_size; ++row_idx) {
+        if (row_operation_ptr && row_operation_ptr[row_idx] == SQL_ROW_IGNORE)
+            continue;
+
+        for (std::size_t i = 0; i < bindings_per_column.size(); ++i) {
+            row_bindings[i] = getRowBindingInfo(bindings_per_column[i], row_idx);
+        }
+
+        writer.writeRow(row_bindings, chunk);
+        ++added_row_count;
+
+        if (chunk.size() >= bulk_operation_chunk_size)
+            write_chunk();
     }
 
-    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
-    if (param_set_processed_ptr)
-        *param_set_processed_ptr = 0;
+    if (!chunk.empty() || !body)
+        write_chunk();
 
-    next_param_set = 0;
-    requestNextPackOfResultSets(std::move(mutator));
-    is_executed = true;
+    body->finish();
+
+    Poco::Net::HTTPResponse bulk_response;
+    auto & response_stream = bulk_session->receiveResponse(bulk_response);
+
+    if (bulk_response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK) {
+        std::stringstream error_message;
+        error_message << "HTTP status code: " << bulk_response.getStatus() << std::endl << "Received error:" << std::endl << response_stream.rdbuf() << std::endl;
+        LOG(error_message.str());
+        throw std::runtime_error(error_message.str());
+    }
+
+    response_stream.ignore(std::numeric_limits<std::streamsize>::max());
+    connection.returnSession(std::move(bulk_session));
+
+    set_row_statuses(SQL_ROW_ADDED);
+    setRowCount(added_row_count);
 }
 
-void Statement::requestNextPackOfResultSets(std::unique_ptr<ResultMutator> && mutator) {
-    result_reader.reset();
+void Statement::flushInsertBatch() {
+    if (!insert_batch_writer)
+        return;
 
-    const auto param_set_array_size = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC).getAttrAs<SQLULEN>(SQL_DESC_ARRAY_SIZE, 1);
-    if (next_param_set >= param_set_array_size)
+    // The batch is kept until the server accepts it, so that the rows are not lost, if sending it fails,
+    // the error is reported by the call that triggered the sending, and the sending is retried by the next one.
+    if (insert_batch_row_count == 0) {
+        insert_batch_writer.reset();
+        insert_batch_query.clear();
+        insert_batch.clear();
         return;
+    }
 
-    getDiagHeader().setAttr(SQL_DIAG_ROW_COUNT, 0);
+    const auto & insert_query = insert_batch_query;
+    const auto & body = insert_batch;
+    const auto row_count = insert_batch_row_count;
 
     auto & connection = getParent();
 
-    if (connection.session && response && in)
-        if (!*in || in->peek() != EOF)
-            connection.session->reset();
+    auto uri = connection.buildURI();
+    uri.addQueryParameter("query", insert_query);
+
+    Poco::Net::HTTPRequest request;
+    const auto query_id = prepareQueryRequest(uri, request, false);
+
+    const auto body_encoding = connection.getRequestEncoding(body.size());
+    if (body_encoding.empty()) {
+        request.setContentLength(body.size());
+    }
+    else {
+        request.setChunkedTransferEncoding(true);
+        request.set("Content-Encoding", body_encoding);
+    }
+
+    LOG(request.getMethod() << " " << connection.server << request.getURI() << " rows=" << row_count);
+
+    // The result set of this statement may still be being read from its session, so another one is borrowed here.
+    auto batch_session = connection.borrowSession(QueryKind::Write);
+
+    // The batch is killed, if the statement is canceled while it is being sent, and the query of the current result set is killed after it.
+    auto previous_query = setRunningQuery(query_id, batch_session->getHost(), batch_session->getPort());
+    ExitGuard running_query_guard([&] () { setRunningQuery(std::move(previous_query)); });
+
+    RequestBodyWriter body_writer(batch_session->sendRequest(request), body_encoding);
+    body_writer.get().write(body.data(), body.size());
+    body_writer.finish();
+
+    Poco::Net::HTTPResponse batch_response;
+    auto & response_stream = batch_session->receiveResponse(batch_response);
+
+    if (batch_response.getStatus() != Poco::Net::HTTPResponse::HTTP_OK) {
+        std::stringstream error_message;
+        error_message << "HTTP status code: " << batch_response.getStatus() << std::endl << "Received error:" << std::endl << response_stream.rdbuf() << std::endl;
+        LOG(error_message.str());
+        throw std::runtime_error(error_message.str());
+    }
+
+    response_stream.ignore(std::numeric_limits<std::streamsize>::max());
+    connection.returnSession(std::move(batch_session));
+
+    insert_batch_writer.reset();
+    insert_batch_query.clear();
+    insert_batch.clear();
+    insert_batch_row_count = 0;
+}
+
+void Statement::releaseSession() {
+    // The decompression of the response must be over before the session is touched.
+    result_reader.reset();
+    decompressed_in.reset();
+
+    if (session && response && in) {
+        if (!drainResponse())
+            session->reset();
+    }
+
+    if (native_session && !drainNativeResults())
+        native_session->reset();
 
-    Poco::URI uri(connection.url);
+    {
+        std::lock_guard<std::mutex> lock(running_query_mutex);
+        running_query.reset();
+    }
 
-    if (connection.port != 0)
-        uri.setPort(connection.port);
+    in = nullptr;
+    direct_in.reset();
+    response.reset();
+    native_in.reset();
 
-    if (!connection.server.empty())
-        uri.setHost(connection.server);
+    getParent().returnSession(std::move(session));
+    getParent().returnNativeSession(std::move(native_session));
+}
 
-    bool database_set = false;
-    bool default_format_set = false;
+bool Statement::drainResponse() {
+    auto & connection = getParent();
+    auto * body = (direct_in && in == direct_in.get() ? dynamic_cast<HTTPResponseBodyStreamBuf *>(direct_in->rdbuf()) : nullptr);
 
-    for (const auto& parameter : uri.getQueryParameters()) {
-        if (Poco::UTF8::icompare(parameter.first, "default_format") == 0) {
-            default_format_set = true;
+    // The server may still be executing the query, that nobody is going to read the results of.
+    const auto kill_running_query = [&] () {
+        try {
+            return killRunningQuery();
         }
-        else if (Poco::UTF8::icompare(parameter.first, "database") == 0) {
-            database_set = true;
+        catch (const std::exception & ex) {
+            LOG("Failed to kill the query: " << ex.what());
+            return false;
         }
-    }
+    };
 
-    if (!default_format_set)
-        uri.addQueryParameter("default_format", connection.default_format);
+    try {
+        // The end of a response, that is not read directly from the socket, can't be looked for without blocking.
+        if (!body) {
+            if (isFullyRead(*in))
+                return true;
 
-    if (!database_set)
-        uri.addQueryParameter("database", connection.database);
+            kill_running_query();
+            return false;
+        }
 
-    const auto param_bindings = getParamsBindingInfo(next_param_set);
+        const std::streamsize limit = connection.drain_limit;
+        const auto remaining = body->getRemainingSize();
+        std::streamsize skipped = 0;
 
-    for (std::size_t i = 0; i < parameters.size(); ++i) {
-        std::string value;
+        if (remaining == 0)
+            return true;
 
-        if (param_bindings.size() <= i) {
-            value = "Null";
+        // The rest of a response of a known size is read, if it is small, otherwise only the data, that has already arrived.
+        auto drained = false;
+        if (remaining > 0 && remaining <= limit) {
+            in->ignore(remaining);
+            skipped = in->gcount();
+            drained = (body->getRemainingSize() == 0);
         }
         else {
-            const auto & binding_info = param_bindings[i];
+            drained = body->skipAvailable(limit, skipped);
+        }
 
-            if (!isInputParam(binding_info.io_type) || isStreamParam(binding_info.io_type))
-                throw std::runtime_error("Unable to extract data from bound param buffer: param IO type is not supported");
+        // Once the query is killed, the server ends the response soon, so the data, that is already on its way, is read then.
+        // Otherwise, nothing makes the response end any time soon, and the session is reset without waiting for it.
+        if (!drained && skipped <= limit && kill_running_query()) {
+            in->ignore(limit - skipped + 1);
+            skipped += in->gcount();
+            drained = (in->eof() && skipped <= limit);
+        }
+
+        if (!drained) {
+            LOG("Resetting the session, more than " << limit << " bytes of the response are left unread");
+            return false;
+        }
 
-            if (binding_info.value == nullptr)
-                value = "Null";
-            else
-                readReadyDataTo(binding_info, value);
+        if (skipped > 0) {
+            ++connection.drained_response_count;
+            LOG("Drained " << skipped << " bytes of the response, keeping the session");
         }
 
-        const auto param_name = getParamFinalName(i);
-        uri.addQueryParameter("param_" + param_name, value);
+        return true;
     }
+    catch (const std::exception & ex) {
+        LOG("Failed to drain the response: " << ex.what());
+        return false;
+    }
+}
 
-    const auto prepared_query = buildFinalQuery(param_bindings);
+bool Statement::drainNativeResults() {
+    if (!native_session->connected())
+        return true;
 
-    // TODO: set this only after this single query is fully fetched (when output parameter support is added)
-    auto * param_set_processed_ptr = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC).getAttrAs<SQLULEN *>(SQL_DESC_ROWS_PROCESSED_PTR, 0);
-    if (param_set_processed_ptr)
-        *param_set_processed_ptr = next_param_set;
+    auto & connection = getParent();
+    auto & client = native_session->getClient();
+
+    if (!client.isQueryRunning())
+        return true;
+
+    const std::size_t limit = connection.drain_limit;
+    std::size_t skipped_bytes = 0;
+    std::size_t skipped_blocks = 0;
+
+    try {
+        // The server stops executing the query, once asked to, and ends the results soon, which is cheaper than reconnecting.
+        client.sendCancel();
+
+        NativeProtocolClient::Block ignored;
+        while (client.receiveBlock(ignored)) {
+            // The limit is in bytes, so each block is counted by the size of its data, along with the names and the types of its columns.
+            skipped_bytes += ignored.rows.size();
+            for (std::size_t i = 0; i < ignored.column_names.size(); ++i)
+                skipped_bytes += ignored.column_names[i].size() + ignored.column_types[i].size();
+            ++skipped_blocks;
+
+            if (skipped_bytes > limit) {
+                LOG("Resetting the native session, " << skipped_bytes << " bytes in " << skipped_blocks << " blocks of the results have been drained, which is more than the limit of " << limit << " bytes");
+                return false;
+            }
+        }
+    }
+    catch (const NativeServerException & ex) {
+        // The cancellation of the query may be reported as an exception, which ends the results too.
+        LOG("Query ended with an exception, while draining its results: " << ex.what());
+    }
+    catch (const std::exception & ex) {
+        LOG("Failed to drain the results: " << ex.what());
+        return false;
+    }
+
+    ++connection.drained_response_count;
+    LOG("Drained " << skipped_bytes << " bytes in " << skipped_blocks << " blocks of the results, keeping the native session");
+
+    return true;
+}
+
+std::string Statement::prepareQueryRequest(Poco::URI & uri, Poco::Net::HTTPRequest & request, bool keep_alive) {
+    auto & connection = getParent();
+
+    // The query is identified, so that it can be killed on the server, when the statement is canceled.
+    auto query_id = generateQueryId();
+    uri.addQueryParameter("query_id", query_id);
 
-    Poco::Net::HTTPRequest request;
     request.setMethod(Poco::Net::HTTPRequest::HTTP_POST);
     request.setVersion(Poco::Net::HTTPRequest::HTTP_1_1);
-    request.setKeepAlive(true);
-    request.setChunkedTransferEncoding(true);
+    request.setKeepAlive(keep_alive);
     request.setCredentials("Basic", connection.buildCredentialsString());
     request.setURI(uri.getPathEtc());
     request.set("User-Agent", connection.buildUserAgentString());
 
-    LOG(request.getMethod() << " " << connection.session->getHost() << request.getURI() << " body=" << prepared_query
-                            << " UA=" << request.get("User-Agent"));
+    return query_id;
+}
 
-    // LOG("curl 'http://" << connection.session->getHost() << ":" << connection.session->getPort() << request.getURI() << "' -d '" << prepared_query << "'");
+std::optional<Statement::RunningQuery> Statement::setRunningQuery(const std::string & query_id, const std::string & host, std::uint16_t port) {
+    RunningQuery query;
+    query.id = query_id;
+    query.endpoint.host = host;
+    query.endpoint.port = port;
 
-    int redirect_count = 0;
-    // Send request to server with finite count of retries.
-    for (int i = 1;; ++i) {
-        try {
-            for (; redirect_count < connection.redirect_limit; ++redirect_count) {
-                connection.session->sendRequest(request) << prepared_query;
-                response = std::make_unique<Poco::Net::HTTPResponse>();
-                in = &connection.session->receiveResponse(*response);
-                auto status = response->getStatus();
-                if (status != Poco::Net::HTTPResponse::HTTP_PERMANENT_REDIRECT && status != Poco::Net::HTTPResponse::HTTP_TEMPORARY_REDIRECT) {
-                    break;
-                }
-                connection.session->reset(); // reset keepalived connection
-                auto newLocation = response->get("Location");
-                LOG("Redirected to " << newLocation << ", redirect index=" << redirect_count + 1 << "/" << connection.redirect_limit);
-                uri = newLocation;
-                connection.session->setHost(uri.getHost());
-                connection.session->setPort(uri.getPort());
-                request.setURI(uri.getPathEtc());
-            }
-            break;
-        } catch (const Poco::IOException & e) {
-            connection.session->reset(); // reset keepalived connection
-            LOG("Http request try=" << i << "/" << connection.retry_count << " failed: " << e.what() << ": " << e.message());
-            if (i > connection.retry_count)
-                throw;
-        }
+    std::lock_guard<std::mutex> lock(running_query_mutex);
+
+    auto previous_query = std::move(running_query);
+    running_query = std::move(query);
+    return previous_query;
+}
+
+void Statement::setRunningQuery(std::optional<RunningQuery> && query) {
+    std::lock_guard<std::mutex> lock(running_query_mutex);
+    running_query = std::move(query);
+}
+
+bool Statement::killRunningQuery() {
+    std::optional<RunningQuery> query;
+
+    {
+        std::lock_guard<std::mutex> lock(running_query_mutex);
+        query.swap(running_query);
     }
 
-    Poco::Net::HTTPResponse::HTTPStatus status = response->getStatus();
-    if (status != Poco::Net::HTTPResponse::HTTP_OK) {
-        std::stringstream error_message;
-        if (status == Poco::Net::HTTPResponse::HTTP_TEMPORARY_REDIRECT || status == Poco::Net::HTTPResponse::HTTP_PERMANENT_REDIRECT) {
-            error_message << "Redirect count exceeded" << std::endl << "Redirect limit: " << connection.redirect_limit << std::endl;
-        } else {
-            error_message << "HTTP status code: " << status << std::endl << "Received error:" << std::endl << in->rdbuf() << std::endl;
+    if (!query)
+        return false;
+
+    getParent().killQuery(query->id, query->endpoint);
+    return true;
+}
+
+void Statement::cancel() {
+    is_canceled = true;
+
+    // The query is killed on the server, so that the executing thread, if any, gets an error instead of the results, and fails.
+    killRunningQuery();
+
+    {
+        std::lock_guard<std::mutex> lock(async_mutex);
+
+        // The cursor may still be used by the asynchronously executed function, so it is closed once its outcome is taken.
+        if (async_operation) {
+            if (!async_operation->complete)
+                async_operation->canceled = true;
+            return;
         }
-        LOG(error_message.str());
-        throw std::runtime_error(error_message.str());
     }
 
-    result_reader = make_result_reader(response->get("X-ClickHouse-Format", connection.default_format), *in, std::move(mutator));
-    ++next_param_set;
+    if (!is_executing)
+        closeCursor();
 }
 
-void Statement::processEscapeSequences() {
-    if (getAttrAs<SQLULEN>(SQL_ATTR_NOSCAN, SQL_NOSCAN_OFF) != SQL_NOSCAN_ON)
-        query = replaceEscapeSequences(query);
-}
+SQLRETURN Statement::callAsync(SQLUSMALLINT function_id, std::function<SQLRETURN ()> && function) {
+    std::unique_lock<std::mutex> lock(async_mutex);
 
-void Statement::extractParametersinfo() {
-    auto & apd_desc = getEffectiveDescriptor(SQL_ATTR_APP_PARAM_DESC);
-    auto & ipd_desc = getEffectiveDescriptor(SQL_ATTR_IMP_PARAM_DESC);
+    if (async_operation) {
+        if (async_operation->function_id != function_id)
+            throw SqlException("Function sequence error", "HY010");
 
-    const auto apd_record_count = apd_desc.getRecordCount();
-    auto ipd_record_count = ipd_desc.getRecordCount();
+        if (!async_operation->complete)
+            return SQL_STILL_EXECUTING;
 
-    // Reset IPD records but preserve possible info set by SQLBindParameter.
-    ipd_record_count = std::min(ipd_record_count, apd_record_count);
-    ipd_desc.setAttr(SQL_DESC_COUNT, ipd_record_count);
+        return takeAsyncOutcome(lock);
+    }
 
-    parameters.clear();
+    const auto async_enable = getAttrAs<SQLULEN>(SQL_ATTR_ASYNC_ENABLE, getParent().getAttrAs<SQLULEN>(SQL_ATTR_ASYNC_ENABLE, SQL_ASYNC_ENABLE_OFF));
+    if (async_enable != SQL_ASYNC_ENABLE_ON) {
+        lock.unlock();
+        return function();
+    }
 
-    // TODO: implement this all in an upgraded Lexer.
+    // Set by the Driver Manager, when the application is to be notified of the completion, instead of polling for it.
+    using NotificationCallback = SQLRETURN (SQL_API *)(SQLPOINTER context, BOOL last);
+    const auto callback = getAttrAs<NotificationCallback>(SQL_ATTR_ASYNC_STMT_PCALLBACK, nullptr);
+    const auto context = getAttrAs<SQLPOINTER>(SQL_ATTR_ASYNC_STMT_PCONTEXT, nullptr);
 
-    Poco::UUIDGenerator uuid_gen;
-    auto generate_placeholder = [&] () {
-        std::string placeholder;
-        do {
-            const auto uuid = uuid_gen.createOne();
-            placeholder = '@' + uuid.toString();
-        } while (query.find(placeholder) != std::string::npos);
-        return placeholder;
-    };
+    async_operation.emplace();
+    async_operation->function_id = function_id;
 
-    // Replace all unquoted ? characters with a placeholder and populate 'parameters' array.
-    char quoted_by = '\0';
-    for (std::size_t i = 0; i < query.size(); ++i) {
-        const char curr = query[i];
-        const char next = (i < query.size() ? query[i + 1] : '\0');
-
-        switch (curr) {
-            case '\\': {
-                ++i; // Skip the next char unconditionally.
-                break;
-            }
+    try {
+        ThreadPool::getInstance().schedule([this, function = std::move(function), callback, context] () {
+            SQLRETURN rc = SQL_ERROR;
+            std::exception_ptr exception;
 
-            case '"':
-            case '\'': {
-                if (quoted_by == curr) {
-                    if (next == curr) {
-                        ++i; // Skip the next char unconditionally: '' or "" SQL escaping.
-                        break;
-                    }
-                    else {
-                        quoted_by = '\0';
-                    }
-                }
-                else {
-                    quoted_by = curr;
-                }
-                break;
+            try {
+                rc = function();
+            }
+            catch (...) {
+                exception = std::current_exception();
             }
 
-            case '?': {
-                if (quoted_by == '\0') {
-                    ParamInfo param_info;
-                    param_info.tmp_placeholder = generate_placeholder();
-                    query.replace(i, 1, param_info.tmp_placeholder);
-                    i += param_info.tmp_placeholder.size() - 1; // - 1 to compensate for's next ++i
-                    parameters.emplace_back(param_info);
-                }
-                break;
+            {
+                std::lock_guard<std::mutex> lock(async_mutex);
+                async_operation->complete = true;
+                async_operation->rc = rc;
+                async_operation->exception = exception;
+                async_cv.notify_all();
             }
 
-            case '@': {
-                if (quoted_by == '\0') {
-                    ParamInfo param_info;
-
-                    param_info.name = '@';
-                    for (std::size_t j = i + 1; j < query.size(); ++j) {
-                        const char jcurr = query[j];
-                        if (
-                            jcurr == '_' ||
-                            std::isalpha(jcurr) ||
-                            (std::isdigit(jcurr) && j > i + 1)
-                        ) {
-                            param_info.name += jcurr;
-                        }
-                        else {
-                            break;
-                        }
-                    }
-
-                    if (param_info.name.size() == 1)
-                        throw SqlException("Syntax error or access violation", "42000");
-
-                    param_info.tmp_placeholder = generate_placeholder();
-                    query.replace(i, param_info.name.size(), param_info.tmp_placeholder);
-                    i += param_info.tmp_placeholder.size() - 1; // - 1 to compensate for's next ++i
-                    parameters.emplace_back(param_info);
+            // The notification is sent last, so that the outcome can be taken right in the callback, e.g., by SQLCompleteAsync().
+            // The statement may be freed by then, so nothing but the copies of its attributes is used here.
+            if (callback) {
+                try {
+                    callback(context, SQL_FALSE);
+                }
+                catch (...) {
                 }
-                break;
             }
-        }
+        });
+    }
+    catch (...) {
+        async_operation.reset();
+        throw;
     }
 
-    ipd_record_count = std::max(ipd_record_count, parameters.size());
-    ipd_desc.setAttr(SQL_DESC_COUNT, ipd_record_count);
+    return SQL_STILL_EXECUTING;
 }
 
-std::string Statement::buildFinalQuery(const std::vector<ParamBindingInfo>& param_bindings) {
-    auto prepared_query = query;
+bool Statement::hasAsyncOperation() {
+    std::lock_guard<std::mutex> lock(async_mutex);
+    return async_operation.has_value();
+}
 
-    for (std::size_t i = 0; i < parameters.size(); ++i) {
-        const auto & param_info = parameters[i];
-        std::string param_type;
+SQLRETURN Statement::completeAsync() {
+    std::unique_lock<std::mutex> lock(async_mutex);
 
-        if (param_bindings.size() <= i) {
-            param_type = "Nullable(Nothing)";
-        }
-        else {
-            const auto & binding_info = param_bindings[i];
+    if (!async_operation)
+        throw SqlException("Function sequence error", "HY010");
 
-            BoundTypeInfo type_info;
-            type_info.c_type = binding_info.c_type;
-            type_info.sql_type = binding_info.sql_type;
-            type_info.value_max_size = binding_info.value_max_size;
-            type_info.precision = binding_info.precision;
-            type_info.scale = binding_info.scale;
-            type_info.is_nullable = (binding_info.is_nullable || binding_info.value == nullptr);
+    return takeAsyncOutcome(lock);
+}
 
-            param_type = convertSQLOrCTypeToDataSourceType(type_info);
-        }
+SQLRETURN Statement::takeAsyncOutcome(std::unique_lock<std::mutex> & lock) {
+    async_cv.wait(lock, [&] () { return async_operation->complete; });
 
-        const auto pos = prepared_query.find(param_info.tmp_placeholder);
-        if (pos == std::string::npos)
-            throw SqlException("COUNT field incorrect", "07002");
+    const auto operation = std::move(*async_operation);
+    async_operation.reset();
+    lock.unlock();
 
-        const auto param_name = getParamFinalName(i);
-        const std::string param_placeholder = "{" + param_name + ":" + param_type + "}";
-        prepared_query.replace(pos, param_info.tmp_placeholder.size(), param_placeholder);
-    }
+    if (operation.row_count)
+        getDiagHeader().setAttr(SQL_DIAG_ROW_COUNT, *operation.row_count);
 
-    return prepared_query;
-}
+    if (operation.exception)
+        std::rethrow_exception(operation.exception);
 
-void Statement::executeQuery(const std::string & q, std::unique_ptr<ResultMutator> && mutator) {
-    prepareQuery(q);
-    executeQuery(std::move(mutator));
+    if (operation.canceled) {
+        closeCursor();
+        throw SqlException("Operation canceled", "HY008");
+    }
+
+    return operation.rc;
 }
 
-void Statement::forwardExecuteQuery(std::unique_ptr<ResultMutator> && mutator) {
-    if (!is_prepared)
-        throw std::runtime_error("statement not prepared");
+void Statement::abandonAsyncOperation() {
+    std::unique_lock<std::mutex> lock(async_mutex);
 
-    if (is_executed)
+    if (!async_operation)
         return;
 
-    executeQuery(std::move(mutator));
-    is_forward_executed = true;
-}
-
-bool Statement::hasResultSet() const {
-    return (result_reader && result_reader->hasResultSet());
-}
+    if (!async_operation->complete) {
+        lock.unlock();
+        cancel();
+        lock.lock();
+    }
 
-ResultSet & Statement::getResultSet() {
-    return result_reader->getResultSet();
+    async_cv.wait(lock, [&] () { return async_operation->complete; });
+    async_operation.reset();
 }
 
-bool Statement::advanceToNextResultSet() {
-    if (!is_executed)
-        return false;
-
-    getDiagHeader().setAttr(SQL_DIAG_ROW_COUNT, 0);
-
-    std::unique_ptr<ResultMutator> mutator;
-
-    if (result_reader) {
-        if (result_reader->advanceToNextResultSet())
-            return true;
+void Statement::setRowCount(SQLLEN row_count) {
+    {
+        std::lock_guard<std::mutex> lock(async_mutex);
 
-        mutator = result_reader->releaseMutator();
+        if (async_operation && !async_operation->complete) {
+            async_operation->row_count = row_count;
+            return;
+        }
     }
 
-    requestNextPackOfResultSets(std::move(mutator));
-    return hasResultSet();
+    getDiagHeader().setAttr(SQL_DIAG_ROW_COUNT, row_count);
 }
 
 void Statement::closeCursor() {
-    auto & connection = getParent();
-    if (connection.session && response && in) {
-        if (!*in || in->peek() != EOF)
-            connection.session->reset();
-    }
-
-    result_reader.reset();
-    in = nullptr;
-    response.reset();
+    resetDataAtExecState();
+    releaseSession();
 
     parameters.clear();
     query.clear();
@@ -455,9 +2333,16 @@ std::vector<ParamBindingInfo> Statement::getParamsBindingInfo(std::size_t param_
         binding_info.c_type = apd_record.getAttrAs<SQLSMALLINT>(SQL_DESC_CONCISE_TYPE, SQL_C_DEFAULT);
         binding_info.sql_type = ipd_record.getAttrAs<SQLSMALLINT>(SQL_DESC_CONCISE_TYPE, SQL_UNKNOWN_TYPE);
         binding_info.value_max_size = ipd_record.getAttrAs<SQLULEN>(SQL_DESC_LENGTH, 0); // TODO: or SQL_DESC_OCTET_LENGTH ?
-        binding_info.value = (void *)(data_ptr ? ((char *)(data_ptr) + param_set_idx * single_set_struct_size + bind_offset) : 0);
-        binding_info.value_size = (SQLLEN *)(sz_ptr ? ((char *)(sz_ptr) + param_set_idx * sizeof(SQLLEN) + bind_offset) : 0);
-        binding_info.indicator = (SQLLEN *)(ind_ptr ? ((char *)(ind_ptr) + param_set_idx * sizeof(SQLLEN) + bind_offset) : 0);
+
+        // In column-wise binding, the elements of the value arrays are of the size of the C type, or of the buffer length for character and binary types.
+        const auto octet_length = getCTypeOctetLength(binding_info.c_type);
+        const auto value_stride = (single_set_struct_size != SQL_PARAM_BIND_BY_COLUMN ? single_set_struct_size :
+            octet_length > 0 ? octet_length : apd_record.getAttrAs<SQLULEN>(SQL_DESC_OCTET_LENGTH, 0));
+        const auto indicator_stride = (single_set_struct_size != SQL_PARAM_BIND_BY_COLUMN ? single_set_struct_size : sizeof(SQLLEN));
+
+        binding_info.value = (void *)(data_ptr ? ((char *)(data_ptr) + param_set_idx * value_stride + bind_offset) : 0);
+        binding_info.value_size = (SQLLEN *)(sz_ptr ? ((char *)(sz_ptr) + param_set_idx * indicator_stride + bind_offset) : 0);
+        binding_info.indicator = (SQLLEN *)(ind_ptr ? ((char *)(ind_ptr) + param_set_idx * indicator_stride + bind_offset) : 0);
 
         // TODO: always use SQL_NULLABLE as a default when https://github.com/ClickHouse/ClickHouse/issues/7488 is fixed.
         binding_info.is_nullable = (
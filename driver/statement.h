@@ -4,10 +4,20 @@
 #include "driver/connection.h"
 #include "driver/descriptor.h"
 #include "driver/result_set.h"
+#include "driver/format/RowBinaryWriter.h"
 
 #include <Poco/Net/HTTPResponse.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -25,6 +35,9 @@ public:
     /// Lookup TypeInfo for given name of type.
     const TypeInfo & getTypeInfo(const std::string & type_name, const std::string & type_name_without_parameters = "") const;
 
+    /// Lookup TypeInfo for the type of given column, unless the column describes itself.
+    const TypeInfo & getTypeInfo(const ColumnInfo & column_info) const;
+
     bool isPrepared() const;
 
     bool isExecuted() const;
@@ -41,6 +54,16 @@ public:
     /// Execute previously prepared query.
     void forwardExecuteQuery(std::unique_ptr<ResultMutator> && mutator = std::unique_ptr<ResultMutator> {});
 
+    /// Indicates whether the execution is pending until the data of data-at-execution parameters is supplied.
+    bool needData() const;
+
+    /// Finish supplying the data of the current data-at-execution parameter, and advance to the next one, if any.
+    /// Returns true and the token of the next parameter, if there is one, otherwise completes the pending execution.
+    bool advanceDataAtExecParam(SQLPOINTER & token);
+
+    /// Supply the next piece of the data of the current data-at-execution parameter.
+    void putDataAtExecParamData(SQLPOINTER data, SQLLEN data_size);
+
     /// Indicates whether there is an result set available for reading.
     bool hasResultSet() const;
 
@@ -50,9 +73,37 @@ public:
     /// Make the next result set current, if any.
     bool advanceToNextResultSet();
 
+    /// Get the binding info adjusted to point to the buffers of the specified row of the row set, according to ARD.
+    BindingInfo getRowBindingInfo(const BindingInfo & binding_info, std::size_t row_idx);
+
+    /// Insert the rows from the bound row set buffers into the table the current result set is selected from.
+    void bulkAdd();
+
+    /// Send the rows of single-row executions of a prepared INSERT query, that are still buffered, if any.
+    void flushInsertBatch();
+
     /// Reset statement to initial state.
     void closeCursor();
 
+    /// Kill the query, that is executed by the server for the statement, if any. May be called from another thread, while the statement
+    /// is executing the query, in which case the execution fails with HY008, otherwise the cursor is closed too.
+    void cancel();
+
+    /// Call the function right away, unless the asynchronous execution is enabled for the statement, in which case it is run by
+    /// the thread pool, and SQL_STILL_EXECUTING is returned, until a repeated call of the same function, whose arguments are ignored,
+    /// finds it complete, and returns its outcome.
+    SQLRETURN callAsync(SQLUSMALLINT function_id, std::function<SQLRETURN ()> && function);
+
+    /// Indicates whether a function is being executed asynchronously, or its outcome has not been returned yet.
+    bool hasAsyncOperation();
+
+    /// Wait for the asynchronously executed function to complete, and return its outcome.
+    SQLRETURN completeAsync();
+
+    /// Set the number of rows, that is reported by SQLRowCount(). The diagnostics of the statement are touched by the polling calls
+    /// of the application, so, while a function is being executed asynchronously, the count is kept with its outcome until it is taken.
+    void setRowCount(SQLLEN row_count);
+
     /// Reset/release row/column buffer bindings.
     void resetColBindings();
 
@@ -69,11 +120,72 @@ public:
     void setImplicitDescriptor(SQLINTEGER type);
 
 private:
+    // A query, that has been sent to the server, and can be killed there.
+    struct RunningQuery {
+        std::string id;
+        Endpoint endpoint;
+    };
+
     void requestNextPackOfResultSets(std::unique_ptr<ResultMutator> && mutator);
 
+    // Send the query of the next pack of result sets over the native protocol, instead of HTTP(S), if Proto=native.
+    void sendNativeQuery(const std::string & insert_values_prefix, std::size_t param_set_count, std::unique_ptr<ResultMutator> && mutator);
+
+    // Abandon the response, if any, and return the session to the connection, resetting it, unless the rest of the response is drained.
+    void releaseSession();
+
+    // Read and discard the rest of the response, if it is small enough, or has already arrived, killing the query otherwise, so that
+    // its end comes soon. Return false, if the session has to be reset instead.
+    bool drainResponse();
+
+    // The same as drainResponse(), but for the results of the query, that have been sent over the native protocol.
+    bool drainNativeResults();
+
+    // Build the request, that sends a query to the server, identifying the query by a newly generated id, that is added to the URI,
+    // and returned, so that the query can be remembered as running with setRunningQuery(), once the server to send it to is known.
+    std::string prepareQueryRequest(Poco::URI & uri, Poco::Net::HTTPRequest & request, bool keep_alive);
+
+    // Remember the query, that is being sent to the server, so that it can be killed there. Return the previously remembered one.
+    std::optional<RunningQuery> setRunningQuery(const std::string & query_id, const std::string & host, std::uint16_t port);
+    void setRunningQuery(std::optional<RunningQuery> && query);
+
+    // Kill the remembered query, if any, and forget it. Return false, if there was no query to kill.
+    bool killRunningQuery();
+
+    // Take the outcome of the asynchronously executed function, waiting for it to complete, if needed, rethrowing its exception, if any.
+    SQLRETURN takeAsyncOutcome(std::unique_lock<std::mutex> & lock);
+
+    // Cancel the asynchronously executed function, if any, and wait for it to complete, dropping its outcome.
+    void abandonAsyncOperation();
+
+    void processResponse(std::unique_ptr<ResultMutator> && mutator);
+    void addParamsToURI(Poco::URI & uri, const std::vector<ParamBindingInfo> & param_bindings);
+    void writeParamsAsMultipart(std::ostream & stream, const std::string & boundary, const std::vector<ParamBindingInfo> & param_bindings);
+    std::size_t estimateParamsSize(const std::vector<ParamBindingInfo> & param_bindings) const;
+    void readParamValue(const std::vector<ParamBindingInfo> & param_bindings, std::size_t param_idx, std::string & value);
+
+    std::vector<std::size_t> findDataAtExecParams(const std::vector<ParamBindingInfo> & param_bindings) const;
+    void startStreamedDataAtExecRequest();
+    void finishStreamedDataAtExecRequest(std::unique_ptr<ResultMutator> && mutator);
+    void resetDataAtExecState();
+
+    bool tryAddToInsertBatch();
+
     void processEscapeSequences();
     void extractParametersinfo();
+    void prepareInListTables(const std::vector<ParamBindingInfo>& param_bindings);
     std::string buildFinalQuery(const std::vector<ParamBindingInfo>& param_bindings);
+    void writeFinalQuery(std::ostream & stream, const std::vector<ParamBindingInfo>& param_bindings);
+    std::size_t renderParamPlaceholder(const std::vector<ParamBindingInfo>& param_bindings, std::size_t param_idx, std::size_t & next_in_list_table, std::string & dest);
+    std::string buildNativeFinalQuery(const std::vector<ParamBindingInfo>& param_bindings);
+    void findInLists(const std::vector<ParamBindingInfo>& param_bindings, std::size_t min_param_count);
+    void writeInListTable(std::ostream & stream, const std::vector<ParamBindingInfo>& param_bindings, std::size_t table_idx);
+    std::string getParamType(const std::vector<ParamBindingInfo>& param_bindings, std::size_t param_idx);
+    bool extractInsertValuesPrefix(std::string & prefix) const;
+    std::string extractSelectTableName() const;
+    std::string buildBatchInsertQuery(const std::string & prefix, std::size_t param_set_count);
+    std::string buildNativeInsertBody(const std::string & prefix, std::size_t param_set_count, std::string & insert_query);
+    void setParamSetStatuses(std::size_t first_param_set, std::size_t param_set_count, SQLUSMALLINT status);
     std::string getParamFinalName(std::size_t param_idx);
     std::vector<ParamBindingInfo> getParamsBindingInfo(std::size_t param_set_idx);
 
@@ -86,6 +198,14 @@ private:
     void deallocateDescriptor(std::shared_ptr<Descriptor> & desc);
 
 private:
+    // A list of consecutive parameters of an IN predicate, whose values are sent as an external table.
+    struct InListTable {
+        std::string name;
+        std::string type;
+        std::size_t first_param = 0;
+        std::size_t param_count = 0;
+    };
+
     std::shared_ptr<Descriptor> implicit_ard;
     std::shared_ptr<Descriptor> implicit_apd;
     std::shared_ptr<Descriptor> implicit_ird;
@@ -101,11 +221,59 @@ private:
     bool is_executed = false;
     std::string query;
     std::vector<ParamInfo> parameters;
+    QueryKind query_kind = QueryKind::Other; // Chooses the servers, that the query is sent to.
 
+    std::unique_ptr<Poco::Net::HTTPClientSession> session; // Borrowed from the connection for the current request and the reading of its response.
     std::unique_ptr<Poco::Net::HTTPResponse> response;
     std::istream* in = nullptr;
+    std::unique_ptr<std::istream> direct_in; // Reads the body of the response directly from the session, 'in' points to it then.
+    std::unique_ptr<std::istream> decompressed_in; // Decompresses the data of 'in', if the response is compressed.
     std::unique_ptr<ResultReader> result_reader;
+    std::unique_ptr<NativeSession> native_session; // Borrowed instead of 'session', if Proto=native.
+    std::unique_ptr<std::istream> native_in; // Reads the results of the query from 'native_session'.
     std::size_t next_param_set = 0;
+    std::vector<InListTable> in_list_tables;
+    std::vector<bool> param_in_in_list_table;
+
+    // The query of the current request, while its response is not fully read, guarded by the mutex, since cancel() may access it.
+    std::mutex running_query_mutex;
+    std::optional<RunningQuery> running_query;
+    std::atomic<bool> is_executing{false}; // Set while the request is being sent and its response is being received.
+    std::atomic<bool> is_canceled{false};
+
+    // The function, that is being executed asynchronously, and its outcome, once it is complete, guarded by the mutex.
+    struct AsyncOperation {
+        SQLUSMALLINT function_id = 0;
+        bool complete = false;
+        bool canceled = false;
+        SQLRETURN rc = SQL_ERROR;
+        std::exception_ptr exception;
+        std::optional<SQLLEN> row_count;
+    };
+
+    std::mutex async_mutex;
+    std::condition_variable async_cv; // Notified when the function completes.
+    std::optional<AsyncOperation> async_operation;
+
+    // Data-at-execution parameters of the pending execution, in the order their data is requested.
+    bool need_data = false;
+    std::vector<std::size_t> data_at_exec_params;
+    std::size_t data_at_exec_params_requested = 0;
+    std::map<std::size_t, std::optional<std::string>> data_at_exec_values; // std::nullopt means NULL.
+    std::size_t streamed_param = std::numeric_limits<std::size_t>::max();
+    std::ostream * request_body = nullptr;
+    std::string streamed_wchar_tail; // Bytes of the streamed SQL_C_WCHAR value, that are not converted yet.
+    std::unique_ptr<ResultMutator> data_at_exec_mutator;
+
+    // Rows of single-row executions of a prepared INSERT ... VALUES (?, ...) query, buffered until any of the batch limits is reached.
+    std::unique_ptr<RowBinaryWriter> insert_batch_writer;
+    std::string insert_batch_query;
+    std::string insert_batch;
+    std::size_t insert_batch_row_count = 0;
+    std::chrono::steady_clock::time_point insert_batch_start_time;
+
+    // Path of the local file, whose contents are sent as the data of the current INSERT execution, if any.
+    std::string insert_file;
 
 public:
     // TODO: switch to using the corresponding descriptor attributes.
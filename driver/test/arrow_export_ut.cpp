@@ -0,0 +1,171 @@
+#include "driver/result_set.h"
+#include "driver/test/common_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    // RowBinaryWithNamesAndTypes-encoded equivalent of
+    //     SELECT toInt32(number) AS i, if(number % 2 = 0, NULL, toString(number)) AS s, toDate(number) AS d, toDecimal64(number - 1, 2) AS n
+    //     FROM system.numbers LIMIT 3
+    std::string makeRowBinaryData() {
+        std::string data;
+
+        writeRowBinaryHeader(data, { "i", "s", "d", "n" }, { "Int32", "Nullable(String)", "Date", "Decimal(18, 2)" });
+
+        for (std::int32_t number = 0; number < 3; ++number) {
+            writePOD(data, number);
+
+            if (number % 2 == 0) {
+                data += static_cast<char>(1);
+            }
+            else {
+                data += static_cast<char>(0);
+                writeRowBinaryString(data, std::to_string(number));
+            }
+
+            writePOD(data, static_cast<std::uint16_t>(number));
+            writePOD(data, static_cast<std::int64_t>((number - 1) * 100));
+        }
+
+        return data;
+    }
+
+    bool isValid(const ArrowArray & array, std::size_t idx) {
+        const auto * validity = static_cast<const std::uint8_t *>(array.buffers[0]);
+        return (!validity || (validity[idx / 8] & (1u << (idx % 8))) != 0);
+    }
+
+} // namespace
+
+TEST(ArrowExport, SchemaAndArray) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "RowBinaryWithNamesAndTypes format is supported only on little-endian platforms";
+
+    std::istringstream stream(makeRowBinaryData());
+    auto reader = make_result_reader("RowBinaryWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{});
+    ASSERT_TRUE(reader->hasResultSet());
+
+    auto & result_set = reader->getResultSet();
+
+    ArrowSchema schema;
+    result_set.exportArrowSchema(schema);
+
+    ASSERT_STREQ(schema.format, "+s");
+    ASSERT_EQ(schema.n_children, 4);
+    EXPECT_STREQ(schema.children[0]->name, "i");
+    EXPECT_STREQ(schema.children[0]->format, "i");
+    EXPECT_STREQ(schema.children[1]->format, "u");
+    EXPECT_EQ(schema.children[1]->flags & ARROW_FLAG_NULLABLE, ARROW_FLAG_NULLABLE);
+    EXPECT_STREQ(schema.children[2]->format, "tdD");
+    EXPECT_STREQ(schema.children[3]->format, "d:18,2");
+
+    schema.release(&schema);
+    EXPECT_EQ(schema.release, nullptr);
+
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 10), 3);
+
+    ArrowArray array;
+    result_set.exportArrowArray(array);
+
+    ASSERT_EQ(array.length, 3);
+    ASSERT_EQ(array.n_children, 4);
+
+    const auto & ints = *array.children[0];
+    EXPECT_EQ(ints.null_count, 0);
+    EXPECT_EQ(static_cast<const std::int32_t *>(ints.buffers[1])[2], 2);
+
+    const auto & strings = *array.children[1];
+    ASSERT_EQ(strings.n_buffers, 3);
+    EXPECT_EQ(strings.null_count, 2);
+    EXPECT_FALSE(isValid(strings, 0));
+    EXPECT_TRUE(isValid(strings, 1));
+    EXPECT_FALSE(isValid(strings, 2));
+
+    const auto * offsets = static_cast<const std::int32_t *>(strings.buffers[1]);
+    const auto * chars = static_cast<const char *>(strings.buffers[2]);
+    EXPECT_EQ(std::string(chars + offsets[1], offsets[2] - offsets[1]), "1");
+
+    const auto & dates = *array.children[2];
+    EXPECT_EQ(static_cast<const std::int32_t *>(dates.buffers[1])[1], 1);
+
+    const auto & decimals = *array.children[3];
+    const auto * decimal_bytes = static_cast<const std::uint8_t *>(decimals.buffers[1]);
+
+    std::int64_t first_decimal_low = 0;
+    std::memcpy(&first_decimal_low, decimal_bytes, sizeof(first_decimal_low));
+    EXPECT_EQ(first_decimal_low, -100);
+    EXPECT_EQ(decimal_bytes[15], 0xFF); // Sign extension of a negative value.
+
+    array.release(&array);
+    EXPECT_EQ(array.release, nullptr);
+}
+
+TEST(ArrowExport, StringFormats) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "RowBinaryWithNamesAndTypes format is supported only on little-endian platforms";
+
+    std::string data;
+    writeRowBinaryHeader(data, { "s", "b", "f", "nf" }, { "String", "String", "FixedString(3)", "Nullable(FixedString(3))" });
+
+    writeRowBinaryString(data, "text");
+    writeRowBinaryString(data, std::string("\xFF\0\x01", 3));
+    data += std::string("a\0b", 3);
+    data += static_cast<char>(1);
+
+    writeRowBinaryString(data, "");
+    writeRowBinaryString(data, "");
+    data += std::string("\0\0\0", 3);
+    data += static_cast<char>(0);
+    data += "xyz";
+
+    std::istringstream stream(data);
+    auto reader = make_result_reader("RowBinaryWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{});
+    auto & result_set = reader->getResultSet();
+
+    // The formats do not depend on how the columns are bound, or read otherwise.
+    ArrowSchema schema;
+    result_set.exportArrowSchema(schema);
+
+    ASSERT_EQ(schema.n_children, 4);
+    EXPECT_STREQ(schema.children[0]->format, "u");
+    EXPECT_STREQ(schema.children[1]->format, "u");
+    EXPECT_STREQ(schema.children[2]->format, "z");
+    EXPECT_STREQ(schema.children[3]->format, "z");
+
+    schema.release(&schema);
+
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 10), 2);
+
+    ArrowArray array;
+    result_set.exportArrowArray(array);
+
+    // The values are exported as they are, without any conversion, even when they are not valid UTF-8.
+    const auto & strings = *array.children[1];
+    ASSERT_EQ(strings.n_buffers, 3);
+    const auto * offsets = static_cast<const std::int32_t *>(strings.buffers[1]);
+    const auto * bytes = static_cast<const char *>(strings.buffers[2]);
+    EXPECT_EQ(std::string(bytes + offsets[0], offsets[1] - offsets[0]), std::string("\xFF\0\x01", 3));
+    EXPECT_EQ(offsets[2], offsets[1]);
+
+    // The zero bytes of FixedString values are kept.
+    const auto & fixed_strings = *array.children[2];
+    ASSERT_EQ(fixed_strings.n_buffers, 3);
+    EXPECT_EQ(fixed_strings.null_count, 0);
+    EXPECT_EQ(std::string(static_cast<const char *>(fixed_strings.buffers[2]), 6), std::string("a\0b\0\0\0", 6));
+
+    const auto & nullable_fixed_strings = *array.children[3];
+    ASSERT_EQ(nullable_fixed_strings.n_buffers, 3);
+    EXPECT_EQ(nullable_fixed_strings.null_count, 1);
+    EXPECT_FALSE(isValid(nullable_fixed_strings, 0));
+    EXPECT_TRUE(isValid(nullable_fixed_strings, 1));
+    const auto * nullable_offsets = static_cast<const std::int32_t *>(nullable_fixed_strings.buffers[1]);
+    EXPECT_EQ(nullable_offsets[1], 0);
+    EXPECT_EQ(std::string(static_cast<const char *>(nullable_fixed_strings.buffers[2]), nullable_offsets[2]), "xyz");
+
+    array.release(&array);
+}
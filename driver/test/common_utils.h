@@ -6,6 +6,9 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
+
+#include <cstdint>
 
 #if defined(BUILD_TYPE_RELEASE)
 #   define ENABLE_FOR_OPTIMIZED_BUILDS_ONLY(test) test
@@ -39,3 +42,38 @@
             std::cout << "\tLatency:          " << str.str() << " milliseconds per iteration" << std::endl; \
         } \
     }
+
+// Helpers for building the test data in RowBinary and RowBinaryWithNamesAndTypes formats.
+
+template <typename T>
+inline void writePOD(std::string & dest, const T & value) {
+    dest.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+inline void writeULEB128(std::string & dest, std::uint64_t value) {
+    do {
+        std::uint8_t byte = value & 0b01111111;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0b10000000;
+        dest += static_cast<char>(byte);
+    } while (value != 0);
+}
+
+inline void writeRowBinaryString(std::string & dest, const std::string & value) {
+    writeULEB128(dest, value.size());
+    dest += value;
+}
+
+// Write the header of RowBinaryWithNamesAndTypes format, i.e., the number of columns, followed by their names and types.
+inline void writeRowBinaryHeader(std::string & dest, const std::vector<std::string> & names, const std::vector<std::string> & types) {
+    writeULEB128(dest, names.size());
+
+    for (const auto & name : names) {
+        writeRowBinaryString(dest, name);
+    }
+
+    for (const auto & type : types) {
+        writeRowBinaryString(dest, type);
+    }
+}
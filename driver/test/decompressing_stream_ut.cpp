@@ -0,0 +1,91 @@
+#include "driver/utils/decompressing_stream.h"
+
+#include <Poco/DeflatingStream.h>
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+    std::string makeData() {
+        std::string data;
+        for (std::size_t i = 0; i < 1000000; ++i) {
+            data += std::to_string(i);
+            data += '\n';
+        }
+        return data;
+    }
+
+    std::string compress(const std::string & data, Poco::DeflatingStreamBuf::StreamType type) {
+        std::ostringstream compressed;
+        Poco::DeflatingOutputStream deflating(compressed, type);
+        deflating << data;
+        deflating.close();
+        return compressed.str();
+    }
+
+    std::string readAll(std::istream & stream) {
+        std::string data;
+        char buffer[4096];
+
+        while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0) {
+            data.append(buffer, stream.gcount());
+        }
+
+        return data;
+    }
+
+} // namespace
+
+TEST(DecompressingStream, NotEncoded) {
+    std::istringstream source("data");
+    EXPECT_EQ(makeDecompressingStream(source, "", false), nullptr);
+    EXPECT_EQ(makeDecompressingStream(source, "identity", true), nullptr);
+    EXPECT_THROW(makeDecompressingStream(source, "br", false), std::runtime_error);
+}
+
+TEST(DecompressingStream, RoundTrip) {
+    const auto data = makeData();
+
+    for (const auto & [encoding, type] : {
+        std::make_pair("gzip", Poco::DeflatingStreamBuf::STREAM_GZIP),
+        std::make_pair("deflate", Poco::DeflatingStreamBuf::STREAM_ZLIB)
+    }) {
+        for (const bool use_thread : { false, true }) {
+            SCOPED_TRACE(std::string(encoding) + (use_thread ? " on a helper thread" : ""));
+
+            std::istringstream source(compress(data, type));
+            auto stream = makeDecompressingStream(source, encoding, use_thread);
+            ASSERT_NE(stream, nullptr);
+
+            EXPECT_EQ(readAll(*stream), data);
+        }
+    }
+}
+
+TEST(DecompressingStream, AbandonedOnHelperThread) {
+    const auto data = makeData();
+    std::istringstream source(compress(data, Poco::DeflatingStreamBuf::STREAM_GZIP));
+
+    auto stream = makeDecompressingStream(source, "gzip", true);
+    ASSERT_NE(stream, nullptr);
+
+    std::string line;
+    ASSERT_TRUE(std::getline(*stream, line));
+    EXPECT_EQ(line, "0");
+
+    // The helper thread must stop, even though the rest of the data is never consumed.
+    stream.reset();
+}
+
+TEST(DecompressingStream, CorruptedData) {
+    for (const bool use_thread : { false, true }) {
+        std::istringstream source("definitely not gzip data");
+        auto stream = makeDecompressingStream(source, "gzip", use_thread);
+        ASSERT_NE(stream, nullptr);
+
+        EXPECT_ANY_THROW(readAll(*stream)) << (use_thread ? "on a helper thread" : "");
+    }
+}
@@ -0,0 +1,240 @@
+#include "driver/utils/utils.h"
+#include "driver/utils/http_response_body.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+
+#include <cstring>
+
+namespace {
+
+    // Gives out the data in pieces of at most max_piece_size bytes, like a socket would do.
+    // Only the first arrived_size bytes are available, reading any further would block.
+    class StringBodySource
+        : public ResponseBodySource
+    {
+    public:
+        explicit StringBodySource(std::string data, std::size_t max_piece_size, std::size_t arrived_size = std::string::npos)
+            : data_(std::move(data))
+            , max_piece_size_(max_piece_size)
+            , arrived_size_(std::min(arrived_size, data_.size()))
+        {
+        }
+
+        virtual std::streamsize readSome(char * buffer, std::streamsize size) override {
+            if (pos_ >= arrived_size_ && arrived_size_ < data_.size()) {
+                ADD_FAILURE() << "Reading the data, that has not arrived yet, would block";
+                return 0;
+            }
+
+            const auto piece_size = std::min<std::size_t>({ static_cast<std::size_t>(size), max_piece_size_, arrived_size_ - pos_ });
+            std::memcpy(buffer, data_.data() + pos_, piece_size);
+            pos_ += piece_size;
+            largest_request_ = std::max<std::size_t>(largest_request_, size);
+            return piece_size;
+        }
+
+        virtual std::streamsize available() override {
+            return std::min(max_piece_size_, arrived_size_ - std::min(pos_, arrived_size_));
+        }
+
+        std::size_t unread() const {
+            return data_.size() - pos_;
+        }
+
+        std::size_t largestRequest() const {
+            return largest_request_;
+        }
+
+    private:
+        const std::string data_;
+        const std::size_t max_piece_size_;
+        const std::size_t arrived_size_;
+        std::size_t pos_ = 0;
+        std::size_t largest_request_ = 0;
+    };
+
+    std::string makePayload(std::size_t size) {
+        std::string payload;
+        payload.reserve(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            payload += static_cast<char>('a' + (i * 7) % 26);
+        }
+        return payload;
+    }
+
+    std::string makeChunked(const std::string & payload, std::size_t chunk_size) {
+        std::string data;
+        for (std::size_t pos = 0; pos < payload.size(); pos += chunk_size) {
+            const auto size = std::min(chunk_size, payload.size() - pos);
+            char header[32];
+            std::snprintf(header, sizeof(header), "%zx%s\r\n", size, (pos == 0 ? ";ext=1" : ""));
+            data += header;
+            data.append(payload, pos, size);
+            data += "\r\n";
+        }
+        data += "0\r\nX-Trailer: 1\r\n\r\n";
+        return data;
+    }
+
+    // Reads the stream the way the result set parsers do.
+    std::string readAll(std::istream & stream, std::size_t step) {
+        AmortizedIStreamReader reader(stream);
+        std::string data;
+
+        while (!reader.eof()) {
+            const auto [ptr, size] = reader.peek(step);
+            const auto count = std::min(size, step);
+            data.append(ptr, count);
+            reader.read(nullptr, count);
+        }
+
+        return data;
+    }
+
+} // namespace
+
+TEST(HTTPResponseBody, Chunked) {
+    const auto payload = makePayload(1000000);
+
+    for (const std::size_t chunk_size : { 1, 100, 65536, 1000000 }) {
+        for (const std::size_t max_piece_size : { 7, 4096, 1 << 20 }) {
+            for (const std::size_t step : { 1, 1000, 100000 }) {
+                if (chunk_size == 1 && step > 1)
+                    continue;
+
+                SCOPED_TRACE("chunk size: " + std::to_string(chunk_size) + ", piece size: " + std::to_string(max_piece_size) + ", step: " + std::to_string(step));
+
+                StringBodySource source(makeChunked(payload, chunk_size), max_piece_size);
+                HTTPResponseBodyStreamBuf buf(source, true, 0);
+                std::istream stream(&buf);
+
+                ASSERT_EQ(readAll(stream, step), payload);
+                EXPECT_EQ(source.unread(), 0);
+            }
+        }
+    }
+}
+
+TEST(HTTPResponseBody, ContentLength) {
+    const auto payload = makePayload(100000);
+
+    StringBodySource source(payload + "next response", 4096);
+    HTTPResponseBodyStreamBuf buf(source, false, payload.size());
+    std::istream stream(&buf);
+
+    ASSERT_EQ(readAll(stream, 1000), payload);
+    EXPECT_EQ(source.unread(), std::strlen("next response"));
+}
+
+TEST(HTTPResponseBody, UntilEndOfData) {
+    const auto payload = makePayload(100000);
+
+    StringBodySource source(payload, 4096);
+    HTTPResponseBodyStreamBuf buf(source, false, HTTPResponseBodyStreamBuf::until_end_of_data);
+    std::istream stream(&buf);
+
+    ASSERT_EQ(readAll(stream, 1000), payload);
+}
+
+TEST(HTTPResponseBody, LargeReadsBypassBuffer) {
+    const auto payload = makePayload(1 << 20);
+
+    StringBodySource source(makeChunked(payload, payload.size()), payload.size());
+    HTTPResponseBodyStreamBuf buf(source, true, 0);
+    std::istream stream(&buf);
+
+    std::string data(payload.size(), '\0');
+    ASSERT_TRUE(stream.read(&data[0], 100));
+    ASSERT_TRUE(stream.read(&data[100], data.size() - 100));
+    ASSERT_EQ(data, payload);
+
+    // The payload is received right into the destination, rather than through the internal buffer.
+    EXPECT_GE(source.largestRequest(), payload.size() / 2);
+}
+
+TEST(HTTPResponseBody, Malformed) {
+    for (const auto & data : {
+        std::string("zz\r\nabc\r\n0\r\n\r\n"), // Invalid chunk size.
+        std::string("3\r\nabcd\r\n0\r\n\r\n"), // Chunk longer than declared.
+        std::string("10\r\nabc"),              // Premature end of the data.
+        std::string("3\r\nabc\r\n")            // No terminating chunk.
+    }) {
+        SCOPED_TRACE(data);
+
+        StringBodySource source(data, 4096);
+        HTTPResponseBodyStreamBuf buf(source, true, 0);
+        std::istream stream(&buf);
+        stream.exceptions(std::ios::badbit);
+
+        EXPECT_ANY_THROW(readAll(stream, 1));
+    }
+}
+
+TEST(HTTPResponseBody, RemainingSize) {
+    const auto payload = makePayload(1000);
+
+    {
+        StringBodySource source(payload, 4096);
+        HTTPResponseBodyStreamBuf buf(source, false, payload.size());
+        std::istream stream(&buf);
+
+        EXPECT_EQ(buf.getRemainingSize(), 1000);
+        ASSERT_TRUE(stream.ignore(400));
+        EXPECT_EQ(buf.getRemainingSize(), 600);
+        ASSERT_TRUE(stream.ignore(600));
+        EXPECT_EQ(buf.getRemainingSize(), 0);
+    }
+
+    {
+        StringBodySource source(makeChunked(payload, 100), 4096);
+        HTTPResponseBodyStreamBuf buf(source, true, 0);
+        std::istream stream(&buf);
+
+        EXPECT_EQ(buf.getRemainingSize(), -1);
+        ASSERT_EQ(readAll(stream, 1000), payload);
+        EXPECT_EQ(buf.getRemainingSize(), 0);
+    }
+}
+
+TEST(HTTPResponseBody, SkipAvailable) {
+    const auto payload = makePayload(100000);
+    const auto data = makeChunked(payload, 1000);
+
+    {
+        StringBodySource source(data, 4096);
+        HTTPResponseBodyStreamBuf buf(source, true, 0);
+        std::istream stream(&buf);
+
+        ASSERT_TRUE(stream.ignore(100));
+
+        std::streamsize skipped = 0;
+        EXPECT_TRUE(buf.skipAvailable(1 << 20, skipped));
+        EXPECT_EQ(skipped, payload.size() - 100);
+        EXPECT_EQ(source.unread(), 0);
+    }
+
+    // The rest of the body is larger than allowed to skip.
+    {
+        StringBodySource source(data, 4096);
+        HTTPResponseBodyStreamBuf buf(source, true, 0);
+
+        std::streamsize skipped = 0;
+        EXPECT_FALSE(buf.skipAvailable(50000, skipped));
+        EXPECT_GT(skipped, 50000);
+        EXPECT_GT(source.unread(), 0);
+    }
+
+    // The rest of the body has not arrived yet, so it is not waited for.
+    {
+        StringBodySource source(data, 4096, data.size() / 2);
+        HTTPResponseBodyStreamBuf buf(source, true, 0);
+
+        std::streamsize skipped = 0;
+        EXPECT_FALSE(buf.skipAvailable(1 << 20, skipped));
+        EXPECT_GT(skipped, 0);
+        EXPECT_LT(skipped, payload.size());
+    }
+}
@@ -0,0 +1,177 @@
+#include "driver/utils/load_balancer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::vector<Endpoint> makeEndpoints(std::size_t count) {
+        std::vector<Endpoint> endpoints(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            endpoints[i].host = "host" + std::to_string(i);
+            endpoints[i].port = 8123;
+        }
+        return endpoints;
+    }
+
+    // Waits for the condition to become true, for up to 10 seconds.
+    template <typename Condition>
+    bool waitFor(Condition && condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+} // namespace
+
+TEST(LoadBalancer, ParseEndpoints) {
+    const auto endpoints = parseEndpoints(" host1 ,host2:9000,127.0.0.1:8124,[::1]:8125,::1,, [fe80::1] ", 8123);
+    ASSERT_EQ(endpoints.size(), 6);
+
+    const std::vector<std::pair<std::string, std::uint16_t>> expected = {
+        { "host1", 8123 },
+        { "host2", 9000 },
+        { "127.0.0.1", 8124 },
+        { "::1", 8125 },
+        { "::1", 8123 },
+        { "fe80::1", 8123 },
+    };
+
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(endpoints[i].host, expected[i].first) << "i = " << i;
+        EXPECT_EQ(endpoints[i].port, expected[i].second) << "i = " << i;
+        EXPECT_EQ(endpoints[i].weight, 1) << "i = " << i;
+    }
+
+    EXPECT_TRUE(parseEndpoints("", 8123).empty());
+    EXPECT_THROW(parseEndpoints("host:", 8123), std::runtime_error);
+    EXPECT_THROW(parseEndpoints("host:port", 8123), std::runtime_error);
+    EXPECT_THROW(parseEndpoints("host:65536", 8123), std::runtime_error);
+    EXPECT_THROW(parseEndpoints(":8123", 8123), std::runtime_error);
+    EXPECT_THROW(parseEndpoints("[::1", 8123), std::runtime_error);
+}
+
+TEST(LoadBalancer, RoundRobin) {
+    LoadBalancer balancer(makeEndpoints(3), LoadBalancer::Policy::RoundRobin, std::chrono::hours(1), {});
+
+    for (std::size_t i = 0; i < 9; ++i) {
+        const auto idx = balancer.start();
+        EXPECT_EQ(idx, i % 3);
+        balancer.finish(idx);
+    }
+}
+
+TEST(LoadBalancer, LeastOutstanding) {
+    LoadBalancer balancer(makeEndpoints(3), LoadBalancer::Policy::LeastOutstanding, std::chrono::hours(1), {});
+
+    const auto first = balancer.start();
+    const auto second = balancer.start();
+    const auto third = balancer.start();
+    EXPECT_NE(first, second);
+    EXPECT_NE(second, third);
+    EXPECT_NE(first, third);
+
+    // Only the endpoint of the finished request has less outstanding requests than the others.
+    balancer.finish(second);
+    EXPECT_EQ(balancer.start(), second);
+    EXPECT_EQ(balancer.start(), (second + 1) % 3); // The ties are resolved in a round-robin manner.
+}
+
+TEST(LoadBalancer, WeightedRandom) {
+    auto endpoints = makeEndpoints(3);
+    endpoints[0].weight = 1;
+    endpoints[1].weight = 3;
+    endpoints[2].weight = 6;
+
+    LoadBalancer balancer(endpoints, LoadBalancer::Policy::Random, std::chrono::hours(1), {});
+
+    constexpr std::size_t request_count = 10000;
+    std::map<std::size_t, std::size_t> counts;
+
+    for (std::size_t i = 0; i < request_count; ++i) {
+        const auto idx = balancer.start();
+        ++counts[idx];
+        balancer.finish(idx);
+    }
+
+    EXPECT_NEAR(counts[0], request_count * 0.1, request_count * 0.03);
+    EXPECT_NEAR(counts[1], request_count * 0.3, request_count * 0.03);
+    EXPECT_NEAR(counts[2], request_count * 0.6, request_count * 0.03);
+}
+
+TEST(LoadBalancer, EjectAndRecover) {
+    std::atomic<bool> healthy{false};
+    std::atomic<std::size_t> checks{0};
+
+    LoadBalancer balancer(makeEndpoints(2), LoadBalancer::Policy::RoundRobin, std::chrono::milliseconds(10),
+        [&] (const Endpoint & endpoint) {
+            EXPECT_EQ(endpoint.host, "host0");
+            ++checks;
+            return healthy.load();
+        }
+    );
+
+    balancer.eject(0);
+    EXPECT_TRUE(balancer.isEjected(0));
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        const auto idx = balancer.start();
+        EXPECT_EQ(idx, 1);
+        balancer.finish(idx);
+    }
+
+    // The endpoint stays ejected, while the health checks fail.
+    ASSERT_TRUE(waitFor([&] () { return checks >= 2; }));
+    EXPECT_TRUE(balancer.isEjected(0));
+
+    healthy = true;
+    ASSERT_TRUE(waitFor([&] () { return !balancer.isEjected(0); }));
+
+    std::map<std::size_t, std::size_t> counts;
+    for (std::size_t i = 0; i < 4; ++i) {
+        const auto idx = balancer.start();
+        ++counts[idx];
+        balancer.finish(idx);
+    }
+
+    EXPECT_EQ(counts[0], 2);
+    EXPECT_EQ(counts[1], 2);
+}
+
+TEST(LoadBalancer, AllEjected) {
+    LoadBalancer balancer(makeEndpoints(2), LoadBalancer::Policy::LeastOutstanding, std::chrono::hours(1), [] (const Endpoint &) { return false; });
+
+    balancer.eject(0);
+    balancer.eject(1);
+
+    // The requests are still sent somewhere, so that they either succeed, or report the actual errors.
+    const auto first = balancer.start();
+    const auto second = balancer.start();
+    EXPECT_NE(first, second);
+}
+
+TEST(LoadBalancer, Shared) {
+    const auto create = [] () {
+        return std::make_shared<LoadBalancer>(makeEndpoints(1), LoadBalancer::Policy::RoundRobin, std::chrono::hours(1), LoadBalancer::HealthCheck{});
+    };
+
+    auto balancer = LoadBalancer::getShared("key", create);
+    EXPECT_EQ(LoadBalancer::getShared("key", create), balancer);
+    EXPECT_NE(LoadBalancer::getShared("other key", create), balancer);
+
+    // The registry does not keep the balancers alive.
+    std::weak_ptr<LoadBalancer> weak_balancer = balancer;
+    balancer.reset();
+    EXPECT_TRUE(weak_balancer.expired());
+}
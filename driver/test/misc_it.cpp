@@ -1,9 +1,23 @@
 #include "driver/platform/platform.h"
 #include "driver/test/client_utils.h"
 #include "driver/test/client_test_base.h"
+#include "driver/test/mock_http_server.h"
+#include "driver/test/mock_native_server.h"
+#include "driver/test/native_packets.h"
 
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdio>
+#include <cstring>
+
 class MiscellaneousTest
     : public ClientTestBase
 {
@@ -34,13 +48,632 @@ TEST_F(MiscellaneousTest, RowArraySizeAttribute) {
     {
         size = 1234;
         rc = ODBC_CALL_ON_DBC_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)size, 0));
-        ASSERT_EQ(rc, SQL_SUCCESS_WITH_INFO); // TODO: remove this when row arrays bigger than 1 are allowed.
+        ASSERT_EQ(rc, SQL_SUCCESS);
     }
 
     {
         size = 0;
         rc = ODBC_CALL_ON_DBC_THROW(hstmt, SQLGetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, &size, sizeof(size), 0));
-        ASSERT_EQ(size, 1); // TODO: remove this when row arrays bigger than 1 are allowed.
-//      ASSERT_EQ(size, 1234); // TODO: uncomment this, when row arrays bigger than 1 are allowed.
+        ASSERT_EQ(size, 1234);
+    }
+}
+
+TEST_F(MiscellaneousTest, BulkOperationsAdd) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TABLE IF NOT EXISTS default.bulk_operations_add (n Int32, s String) ENGINE = Memory");
+    const auto truncate_query = fromUTF8<SQLTCHAR>("TRUNCATE TABLE default.bulk_operations_add");
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT n, s FROM default.bulk_operations_add");
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(truncate_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    constexpr std::size_t row_count = 100;
+
+    SQLINTEGER numbers[row_count] = {};
+    SQLLEN number_inds[row_count] = {};
+    SQLCHAR strings[row_count][16] = {};
+    SQLLEN string_inds[row_count] = {};
+    SQLUSMALLINT statuses[row_count] = {};
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(row_count), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_STATUS_PTR, statuses, 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLBindCol(hstmt, 1, SQL_C_SLONG, numbers, sizeof(numbers[0]), number_inds));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLBindCol(hstmt, 2, SQL_C_CHAR, strings, sizeof(strings[0]), string_inds));
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        numbers[i] = static_cast<SQLINTEGER>(i);
+        number_inds[i] = sizeof(numbers[i]);
+        const auto str = std::to_string(i * i);
+        std::memcpy(strings[i], str.c_str(), str.size());
+        string_inds[i] = str.size();
     }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLBulkOperations(hstmt, SQL_ADD));
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        ASSERT_EQ(statuses[i], SQL_ROW_ADDED);
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+
+    SQLULEN fetched = 0;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+    ASSERT_EQ(fetched, row_count);
+
+    std::int64_t sum = 0;
+    for (std::size_t i = 0; i < row_count; ++i) {
+        ASSERT_EQ(statuses[i], SQL_ROW_SUCCESS);
+        ASSERT_EQ(std::to_string(numbers[i] * numbers[i]), std::string(reinterpret_cast<char *>(strings[i]), string_inds[i]));
+        sum += numbers[i];
+    }
+
+    ASSERT_EQ(sum, row_count * (row_count - 1) / 2);
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(MiscellaneousTest, ColumnWiseBindingOfFixedSizeTypes) {
+    const auto query = fromUTF8<SQLTCHAR>("SELECT toInt32(number * 10) FROM system.numbers LIMIT 3");
+
+    constexpr std::size_t row_count = 3;
+
+    // The buffer length is ignored for fixed-size types, the elements of the array are of the size of the C type.
+    SQLINTEGER numbers[row_count + 1] = {};
+    SQLLEN inds[row_count] = {};
+    numbers[row_count] = -1;
+
+    SQLULEN fetched = 0;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROW_ARRAY_SIZE, reinterpret_cast<SQLPOINTER>(row_count), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLBindCol(hstmt, 1, SQL_C_SLONG, numbers, 100, inds));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+    ASSERT_EQ(fetched, row_count);
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        ASSERT_EQ(inds[i], sizeof(SQLINTEGER));
+        ASSERT_EQ(numbers[i], static_cast<SQLINTEGER>(i * 10));
+    }
+
+    // Nothing is written past the end of the array.
+    ASSERT_EQ(numbers[row_count], -1);
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(MiscellaneousTest, InsertFromFile) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TABLE IF NOT EXISTS default.insert_from_file (n Int32, s String) ENGINE = Memory");
+    const auto truncate_query = fromUTF8<SQLTCHAR>("TRUNCATE TABLE default.insert_from_file");
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO default.insert_from_file");
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT count(), sum(n), countIf(s = 'it''s 9') FROM default.insert_from_file");
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(truncate_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    constexpr std::size_t row_count = 1000;
+    const std::string file_path = "insert_from_file.csv";
+
+    {
+        std::ofstream file(file_path, std::ios::binary);
+        for (std::size_t i = 0; i < row_count; ++i) {
+            file << i << ",\"it's " << i % 10 << "\"\n";
+        }
+    }
+
+    const auto file_path_str = fromUTF8<SQLTCHAR>(file_path);
+    const auto format_str = fromUTF8<SQLTCHAR>("CSV");
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, CH_SQL_ATTR_INSERT_FILE, const_cast<SQLTCHAR *>(file_path_str.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, CH_SQL_ATTR_INSERT_FILE_FORMAT, const_cast<SQLTCHAR *>(format_str.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    std::remove(file_path.c_str());
+
+    // The file is sent only once.
+    SQLTCHAR file_path_after[256] = {};
+    SQLINTEGER file_path_after_length = 0;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetStmtAttr(hstmt, CH_SQL_ATTR_INSERT_FILE, file_path_after, sizeof(file_path_after), &file_path_after_length));
+    ASSERT_EQ(file_path_after_length, 0);
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    SQLBIGINT count = 0;
+    SQLBIGINT sum = 0;
+    SQLBIGINT last_count = 0;
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &count, sizeof(count), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 2, SQL_C_SBIGINT, &sum, sizeof(sum), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 3, SQL_C_SBIGINT, &last_count, sizeof(last_count), nullptr));
+
+    ASSERT_EQ(count, row_count);
+    ASSERT_EQ(sum, row_count * (row_count - 1) / 2);
+    ASSERT_EQ(last_count, row_count / 10);
+
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(MiscellaneousTest, CompressedResponse) {
+    constexpr SQLBIGINT row_count = 1000000;
+    const auto query = fromUTF8<SQLTCHAR>("SELECT number, toString(number) FROM system.numbers LIMIT " + std::to_string(row_count));
+
+    for (const std::string compression : { "gzip", "deflate" }) {
+        for (const std::string decompress_thread : { "0", "1" }) {
+            SCOPED_TRACE("Compression=" + compression + ";DecompressThread=" + decompress_thread);
+
+            SQLHDBC compressed_hdbc = nullptr;
+            SQLHSTMT compressed_hstmt = nullptr;
+
+            ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &compressed_hdbc));
+
+            const auto connection_string = fromUTF8<SQLTCHAR>(
+                "DSN={" + TestEnvironment::getInstance().getDSN() + "};Compression=" + compression + ";DecompressThread=" + decompress_thread
+            );
+            ODBC_CALL_ON_DBC_THROW(compressed_hdbc,
+                SQLDriverConnect(compressed_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+            );
+            ODBC_CALL_ON_DBC_THROW(compressed_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, compressed_hdbc, &compressed_hstmt));
+
+            // The statement is executed twice, so that the reuse of the connection after a compressed response is checked too.
+            for (int execution = 0; execution < 2; ++execution) {
+                ODBC_CALL_ON_STMT_THROW(compressed_hstmt, SQLExecDirect(compressed_hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+
+                SQLBIGINT rows = 0;
+                SQLBIGINT sum = 0;
+
+                while (true) {
+                    const auto rc = SQLFetch(compressed_hstmt);
+                    if (rc == SQL_NO_DATA)
+                        break;
+
+                    ODBC_CALL_ON_STMT_THROW(compressed_hstmt, rc);
+
+                    SQLBIGINT number = 0;
+                    ODBC_CALL_ON_STMT_THROW(compressed_hstmt, SQLGetData(compressed_hstmt, 1, SQL_C_SBIGINT, &number, sizeof(number), nullptr));
+
+                    sum += number;
+                    ++rows;
+                }
+
+                ODBC_CALL_ON_STMT_THROW(compressed_hstmt, SQLFreeStmt(compressed_hstmt, SQL_CLOSE));
+
+                ASSERT_EQ(rows, row_count);
+                ASSERT_EQ(sum, row_count * (row_count - 1) / 2);
+            }
+
+            ODBC_CALL_ON_STMT_THROW(compressed_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, compressed_hstmt));
+            ODBC_CALL_ON_DBC_LOG(compressed_hdbc, SQLDisconnect(compressed_hdbc));
+            ODBC_CALL_ON_DBC_THROW(compressed_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, compressed_hdbc));
+        }
+    }
+}
+
+TEST_F(MiscellaneousTest, SessionPool) {
+    const auto connection_string = fromUTF8<SQLTCHAR>("DSN={" + TestEnvironment::getInstance().getDSN() + "};PoolSize=4");
+    const auto query = fromUTF8<SQLTCHAR>("SELECT 1");
+
+    SQLUBIGINT initial_hits = 0;
+    SQLUBIGINT hits = 0;
+    SQLUBIGINT misses = 0;
+
+    for (int cycle = 0; cycle < 5; ++cycle) {
+        SQLHDBC pooled_hdbc = nullptr;
+        SQLHSTMT pooled_hstmt = nullptr;
+
+        ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &pooled_hdbc));
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc,
+            SQLDriverConnect(pooled_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+        );
+
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, pooled_hdbc, &pooled_hstmt));
+        ODBC_CALL_ON_STMT_THROW(pooled_hstmt, SQLExecDirect(pooled_hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+        ODBC_CALL_ON_STMT_THROW(pooled_hstmt, SQLFetch(pooled_hstmt));
+
+        SQLINTEGER value = 0;
+        ODBC_CALL_ON_STMT_THROW(pooled_hstmt, SQLGetData(pooled_hstmt, 1, SQL_C_SLONG, &value, sizeof(value), nullptr));
+        ASSERT_EQ(value, 1);
+
+        // The session is taken from the pool by the first request of the connection.
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc, SQLGetConnectAttr(pooled_hdbc, CH_SQL_ATTR_SESSION_POOL_HITS, &hits, sizeof(hits), nullptr));
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc, SQLGetConnectAttr(pooled_hdbc, CH_SQL_ATTR_SESSION_POOL_MISSES, &misses, sizeof(misses), nullptr));
+
+        if (cycle == 0)
+            initial_hits = hits;
+        else
+            ASSERT_EQ(hits, initial_hits + cycle); // The session released by the previous cycle is reused.
+
+        ODBC_CALL_ON_STMT_THROW(pooled_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, pooled_hstmt));
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc, SQLDisconnect(pooled_hdbc));
+        ODBC_CALL_ON_DBC_THROW(pooled_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, pooled_hdbc));
+    }
+
+    ASSERT_GT(misses, 0);
+}
+
+TEST_F(MiscellaneousTest, ConcurrentCursors) {
+    constexpr SQLBIGINT master_row_count = 100000;
+    const auto master_query = fromUTF8<SQLTCHAR>("SELECT number FROM system.numbers LIMIT " + std::to_string(master_row_count));
+    const auto detail_query = fromUTF8<SQLTCHAR>("SELECT count() FROM system.numbers LIMIT 10");
+
+    SQLHSTMT detail_hstmt = nullptr;
+    ODBC_CALL_ON_DBC_THROW(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &detail_hstmt));
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(master_query.c_str()), SQL_NTS));
+
+    SQLBIGINT rows = 0;
+    SQLBIGINT sum = 0;
+
+    while (true) {
+        const auto rc = SQLFetch(hstmt);
+        if (rc == SQL_NO_DATA)
+            break;
+
+        ODBC_CALL_ON_STMT_THROW(hstmt, rc);
+
+        SQLBIGINT number = 0;
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &number, sizeof(number), nullptr));
+
+        sum += number;
+        ++rows;
+
+        // Another query is executed on the same connection, while the result set of the first one is still being read.
+        if (number % 25000 == 0) {
+            ODBC_CALL_ON_STMT_THROW(detail_hstmt, SQLExecDirect(detail_hstmt, const_cast<SQLTCHAR *>(detail_query.c_str()), SQL_NTS));
+            ODBC_CALL_ON_STMT_THROW(detail_hstmt, SQLFetch(detail_hstmt));
+            ODBC_CALL_ON_STMT_THROW(detail_hstmt, SQLFreeStmt(detail_hstmt, SQL_CLOSE));
+        }
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(detail_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, detail_hstmt));
+
+    ASSERT_EQ(rows, master_row_count);
+    ASSERT_EQ(sum, master_row_count * (master_row_count - 1) / 2);
+}
+
+TEST_F(MiscellaneousTest, DrainAbandonedResponse) {
+    const auto query = fromUTF8<SQLTCHAR>("SELECT number FROM system.numbers LIMIT 1000");
+
+    SQLUBIGINT initial_drained = 0;
+    SQLUBIGINT drained = 0;
+    ODBC_CALL_ON_DBC_THROW(hdbc, SQLGetConnectAttr(hdbc, CH_SQL_ATTR_DRAINED_RESPONSES, &initial_drained, sizeof(initial_drained), nullptr));
+
+    // Only the first row is fetched, the rest of the response is small, so it is drained, and the connection to the server is kept.
+    for (int i = 1; i <= 3; ++i) {
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+        ODBC_CALL_ON_DBC_THROW(hdbc, SQLGetConnectAttr(hdbc, CH_SQL_ATTR_DRAINED_RESPONSES, &drained, sizeof(drained), nullptr));
+        ASSERT_EQ(drained, initial_drained + i);
+    }
+}
+
+TEST_F(MiscellaneousTest, ReadWriteSplitting) {
+    // Nothing listens on port 1, so only the reads, that are sent to the main servers, can succeed.
+    const auto connection_string = fromUTF8<SQLTCHAR>("DSN={" + TestEnvironment::getInstance().getDSN() + "};WriteServers=127.0.0.1:1;FailoverCooldown=3600");
+    const auto read_query = fromUTF8<SQLTCHAR>("SELECT 1");
+    const auto write_query = fromUTF8<SQLTCHAR>("DROP TABLE IF EXISTS odbc_read_write_splitting_nonexistent");
+
+    SQLHDBC split_hdbc = nullptr;
+    SQLHSTMT split_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &split_hdbc));
+    ODBC_CALL_ON_DBC_THROW(split_hdbc,
+        SQLDriverConnect(split_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+
+    ODBC_CALL_ON_DBC_THROW(split_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, split_hdbc, &split_hstmt));
+
+    ODBC_CALL_ON_STMT_THROW(split_hstmt, SQLExecDirect(split_hstmt, const_cast<SQLTCHAR *>(read_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(split_hstmt, SQLFetch(split_hstmt));
+    ODBC_CALL_ON_STMT_THROW(split_hstmt, SQLFreeStmt(split_hstmt, SQL_CLOSE));
+
+    ASSERT_EQ(SQLExecDirect(split_hstmt, const_cast<SQLTCHAR *>(write_query.c_str()), SQL_NTS), SQL_ERROR);
+
+    ODBC_CALL_ON_STMT_THROW(split_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, split_hstmt));
+    ODBC_CALL_ON_DBC_THROW(split_hdbc, SQLDisconnect(split_hdbc));
+    ODBC_CALL_ON_DBC_THROW(split_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, split_hdbc));
+}
+
+TEST_F(MiscellaneousTest, CancelKillsQuery) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::string running_query_id;
+    std::string kill_query;
+
+    // The mock server holds the query, until it is killed, and then fails it, as the real server does.
+    MockHTTPServer server([&] (Poco::Net::HTTPServerRequest & request, Poco::Net::HTTPServerResponse & response) {
+        const auto body = MockHTTPServer::readBody(request);
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (body.find("KILL QUERY") != std::string::npos) {
+            kill_query = body;
+            cv.notify_all();
+
+            response.setContentLength(0);
+            response.send();
+            return;
+        }
+
+        running_query_id = MockHTTPServer::getQueryParameter(request, "query_id");
+        cv.notify_all();
+        cv.wait_for(lock, std::chrono::seconds(10), [&] () { return !kill_query.empty(); });
+
+        response.setStatusAndReason(Poco::Net::HTTPResponse::HTTP_INTERNAL_SERVER_ERROR);
+        response.send() << "Code: 394. DB::Exception: Query was cancelled.";
+    });
+
+    const auto connection_string = fromUTF8<SQLTCHAR>(
+        "DSN={" + TestEnvironment::getInstance().getDSN() + "};Url=;Proto=http;Server=127.0.0.1;Port=" + std::to_string(server.getPort())
+    );
+    const auto query = fromUTF8<SQLTCHAR>("SELECT sleep(3)");
+
+    SQLHDBC mock_hdbc = nullptr;
+    SQLHSTMT mock_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc,
+        SQLDriverConnect(mock_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, mock_hdbc, &mock_hstmt));
+
+    SQLRETURN execute_rc = SQL_SUCCESS;
+    std::thread executor([&] () {
+        execute_rc = SQLExecDirect(mock_hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS);
+    });
+
+    bool started = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        started = cv.wait_for(lock, std::chrono::seconds(10), [&] () { return !running_query_id.empty(); });
+    }
+
+    // The statement is canceled from another thread, while it is executing.
+    const auto cancel_rc = SQLCancel(mock_hstmt);
+    executor.join();
+
+    ASSERT_TRUE(started);
+    ASSERT_EQ(cancel_rc, SQL_SUCCESS);
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        EXPECT_NE(kill_query.find("query_id = '" + running_query_id + "'"), std::string::npos) << kill_query;
+    }
+
+    ASSERT_EQ(execute_rc, SQL_ERROR);
+    EXPECT_NE(extract_diagnostics(mock_hstmt, SQL_HANDLE_STMT).find("[HY008]"), std::string::npos);
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, mock_hstmt));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLDisconnect(mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, mock_hdbc));
+}
+
+TEST_F(MiscellaneousTest, InsertsHaveQueryId) {
+    std::mutex mutex;
+    std::vector<std::pair<std::string, std::string>> queries; // The queries with their ids, in the order they are received.
+
+    MockHTTPServer server([&] (Poco::Net::HTTPServerRequest & request, Poco::Net::HTTPServerResponse & response) {
+        MockHTTPServer::readBody(request);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queries.emplace_back(MockHTTPServer::getQueryParameter(request, "query"), MockHTTPServer::getQueryParameter(request, "query_id"));
+        }
+
+        response.setContentLength(0);
+        response.send();
+    });
+
+    const auto connection_string = fromUTF8<SQLTCHAR>(
+        "DSN={" + TestEnvironment::getInstance().getDSN() + "};Url=;Proto=http;Server=127.0.0.1;Port=" + std::to_string(server.getPort()) +
+        ";InsertBatchRows=10"
+    );
+    const auto streamed_query = fromUTF8<SQLTCHAR>("INSERT INTO t (s) VALUES (?)");
+    const auto batched_query = fromUTF8<SQLTCHAR>("INSERT INTO t (n) VALUES (?)");
+
+    SQLHDBC mock_hdbc = nullptr;
+    SQLHSTMT mock_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc,
+        SQLDriverConnect(mock_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, mock_hdbc, &mock_hstmt));
+
+    // The data-at-execution parameter is streamed into the request body.
+    SQLLEN string_ind = SQL_LEN_DATA_AT_EXEC(0);
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt,
+        SQLBindParameter(mock_hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, 16, 0, reinterpret_cast<SQLPOINTER>(1), 0, &string_ind)
+    );
+
+    SQLPOINTER param_token = nullptr;
+    char value[] = "abc";
+
+    ASSERT_EQ(SQLExecDirect(mock_hstmt, const_cast<SQLTCHAR *>(streamed_query.c_str()), SQL_NTS), SQL_NEED_DATA);
+    ASSERT_EQ(SQLParamData(mock_hstmt, &param_token), SQL_NEED_DATA);
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLPutData(mock_hstmt, value, std::strlen(value)));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLParamData(mock_hstmt, &param_token));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeStmt(mock_hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeStmt(mock_hstmt, SQL_RESET_PARAMS));
+
+    // The rows are buffered, and sent in a batch, once the connection is closed.
+    SQLINTEGER number = 0;
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt,
+        SQLBindParameter(mock_hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &number, 0, nullptr)
+    );
+
+    for (number = 0; number < 3; ++number) {
+        ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLExecDirect(mock_hstmt, const_cast<SQLTCHAR *>(batched_query.c_str()), SQL_NTS));
+        ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeStmt(mock_hstmt, SQL_CLOSE));
+    }
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, mock_hstmt));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLDisconnect(mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, mock_hdbc));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(queries.size(), 2);
+
+    EXPECT_NE(queries[0].first.find("INSERT INTO t (s)"), std::string::npos) << queries[0].first;
+    EXPECT_NE(queries[1].first.find("INSERT INTO t (n)"), std::string::npos) << queries[1].first;
+
+    // Each query is identified, so that it can be killed on the server, and the ids are not reused.
+    EXPECT_FALSE(queries[0].second.empty());
+    EXPECT_FALSE(queries[1].second.empty());
+    EXPECT_NE(queries[0].second, queries[1].second);
+}
+
+TEST_F(MiscellaneousTest, AsyncExecution) {
+    constexpr std::size_t statement_count = 16;
+
+    std::vector<SQLHSTMT> statements(statement_count, nullptr);
+    std::vector<std::basic_string<SQLTCHAR>> queries;
+
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        ODBC_CALL_ON_DBC_THROW(hdbc, SQLAllocHandle(SQL_HANDLE_STMT, hdbc, &statements[i]));
+        ODBC_CALL_ON_STMT_THROW(statements[i], SQLSetStmtAttr(statements[i], SQL_ATTR_ASYNC_ENABLE, reinterpret_cast<SQLPOINTER>(SQL_ASYNC_ENABLE_ON), 0));
+        queries.emplace_back(fromUTF8<SQLTCHAR>("SELECT sleep(0.5), " + std::to_string(i)));
+    }
+
+    // All queries are in flight at once, while this thread just starts them, and then polls for their completion.
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        ASSERT_EQ(SQLExecDirect(statements[i], const_cast<SQLTCHAR *>(queries[i].c_str()), SQL_NTS), SQL_STILL_EXECUTING);
+    }
+
+    // Repeat the call, until the function is complete.
+    const auto poll = [] (auto && call) {
+        SQLRETURN rc = SQL_STILL_EXECUTING;
+        while ((rc = call()) == SQL_STILL_EXECUTING) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return rc;
+    };
+
+    for (std::size_t i = 0; i < statement_count; ++i) {
+        ODBC_CALL_ON_STMT_THROW(statements[i], poll([&] () { return SQLExecDirect(statements[i], const_cast<SQLTCHAR *>(queries[i].c_str()), SQL_NTS); }));
+        ODBC_CALL_ON_STMT_THROW(statements[i], poll([&] () { return SQLFetch(statements[i]); }));
+
+        SQLBIGINT value = -1;
+        ODBC_CALL_ON_STMT_THROW(statements[i], SQLGetData(statements[i], 2, SQL_C_SBIGINT, &value, sizeof(value), nullptr));
+        ASSERT_EQ(value, static_cast<SQLBIGINT>(i));
+
+        ASSERT_EQ(poll([&] () { return SQLFetch(statements[i]); }), SQL_NO_DATA);
+
+        // The row count, that is set by the asynchronously executed function, is reported, once its outcome is taken.
+        SQLLEN row_count = -1;
+        ODBC_CALL_ON_STMT_THROW(statements[i], SQLRowCount(statements[i], &row_count));
+        ASSERT_EQ(row_count, 1);
+    }
+
+    for (auto & statement : statements) {
+        ODBC_CALL_ON_STMT_THROW(statement, SQLFreeHandle(SQL_HANDLE_STMT, statement));
+    }
+}
+
+TEST_F(MiscellaneousTest, NativeProtocol) {
+    std::mutex mutex;
+    std::vector<std::string> queries;
+
+    // The mock server replays the recorded results of the first query, and fails the rest, as the real server does for a missing table.
+    MockNativeServer server([&] (Poco::Net::StreamSocket & socket) {
+        MockNativeServer::receiveUntil(socket, NativePackets::string("native_password"));
+        MockNativeServer::send(socket, NativePackets::hello("ClickHouse", 21, 8, 54449, "UTC"));
+
+        while (true) {
+            const auto query = MockNativeServer::receiveUntil(socket, NativePackets::clientEmptyData());
+            std::size_t query_count = 0;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                queries.push_back(query);
+                query_count = queries.size();
+            }
+
+            if (query_count > 1) {
+                MockNativeServer::send(socket, NativePackets::exception(60, "DB::Exception", "DB::Exception: Table default.missing doesn't exist"));
+                continue;
+            }
+
+            const auto header = NativePackets::block({{"x", "UInt32", ""}, {"s", "Nullable(String)", ""}}, 0);
+            const auto rows = NativePackets::block({
+                {"x", "UInt32", NativePackets::fixed<std::uint32_t>(1) + NativePackets::fixed<std::uint32_t>(2)},
+                {"s", "Nullable(String)", std::string("\0\1", 2) + NativePackets::string("a") + NativePackets::string("")}
+            }, 2);
+
+            MockNativeServer::send(socket,
+                NativePackets::data(header) + NativePackets::progress(2, 10, 2) + NativePackets::data(rows) +
+                NativePackets::profileInfo(2, 1, 10) + NativePackets::endOfStream()
+            );
+        }
+    });
+
+    const auto connection_string = fromUTF8<SQLTCHAR>(
+        "DSN={" + TestEnvironment::getInstance().getDSN() + "};Url=;Proto=native;Server=127.0.0.1;Port=" + std::to_string(server.getPort()) +
+        ";UID=native_user;PWD=native_password;Compression=none"
+    );
+    const auto query = fromUTF8<SQLTCHAR>("SELECT x, s FROM t WHERE s != ?");
+    const auto failing_query = fromUTF8<SQLTCHAR>("SELECT * FROM missing");
+
+    SQLHDBC mock_hdbc = nullptr;
+    SQLHSTMT mock_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc,
+        SQLDriverConnect(mock_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, mock_hdbc, &mock_hstmt));
+
+    SQLCHAR param[] = "it's";
+    SQLLEN param_ind = SQL_NTS;
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt,
+        SQLBindParameter(mock_hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, sizeof(param), 0, param, sizeof(param), &param_ind)
+    );
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLExecDirect(mock_hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ASSERT_EQ(queries.size(), 1);
+
+        // The values of the parameters are a part of the query, the protocol has no query parameters.
+        EXPECT_NE(queries[0].find("SELECT x, s FROM t WHERE s != CAST('it\\'s' AS "), std::string::npos) << queries[0];
+    }
+
+    SQLUINTEGER x = 0;
+    char s[16] = {};
+    SQLLEN s_ind = 0;
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFetch(mock_hstmt));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLGetData(mock_hstmt, 1, SQL_C_ULONG, &x, sizeof(x), nullptr));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLGetData(mock_hstmt, 2, SQL_C_CHAR, s, sizeof(s), &s_ind));
+    EXPECT_EQ(x, 1);
+    EXPECT_EQ(s_ind, 1);
+    EXPECT_STREQ(s, "a");
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFetch(mock_hstmt));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLGetData(mock_hstmt, 1, SQL_C_ULONG, &x, sizeof(x), nullptr));
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLGetData(mock_hstmt, 2, SQL_C_CHAR, s, sizeof(s), &s_ind));
+    EXPECT_EQ(x, 2);
+    EXPECT_EQ(s_ind, SQL_NULL_DATA);
+
+    ASSERT_EQ(SQLFetch(mock_hstmt), SQL_NO_DATA);
+
+    // The exception, that the server sends instead of the results, fails the execution, and the session is still reused.
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeStmt(mock_hstmt, SQL_RESET_PARAMS));
+    ASSERT_EQ(SQLExecDirect(mock_hstmt, const_cast<SQLTCHAR *>(failing_query.c_str()), SQL_NTS), SQL_ERROR);
+    EXPECT_NE(extract_diagnostics(mock_hstmt, SQL_HANDLE_STMT).find("Table default.missing doesn't exist"), std::string::npos);
+
+    ODBC_CALL_ON_STMT_THROW(mock_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, mock_hstmt));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLDisconnect(mock_hdbc));
+    ODBC_CALL_ON_DBC_THROW(mock_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, mock_hdbc));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(queries.size(), 2);
 }
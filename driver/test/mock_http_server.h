@@ -0,0 +1,99 @@
+#pragma once
+
+#include <Poco/Net/HTTPRequestHandler.h>
+#include <Poco/Net/HTTPRequestHandlerFactory.h>
+#include <Poco/Net/HTTPServer.h>
+#include <Poco/Net/HTTPServerParams.h>
+#include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerResponse.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/StreamCopier.h>
+#include <Poco/URI.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <cstdint>
+
+// A local HTTP server, that answers the requests of the driver by calling the handler, to test the interaction with the server.
+// The handler is called concurrently, for the requests of different sessions.
+class MockHTTPServer {
+public:
+    using Handler = std::function<void (Poco::Net::HTTPServerRequest & request, Poco::Net::HTTPServerResponse & response)>;
+
+    explicit MockHTTPServer(Handler handler)
+        : socket_(Poco::Net::SocketAddress("127.0.0.1", 0))
+    {
+        auto params = Poco::Net::HTTPServerParams::Ptr(new Poco::Net::HTTPServerParams);
+        params->setMaxThreads(8);
+
+        server_ = std::make_unique<Poco::Net::HTTPServer>(new HandlerFactory(std::move(handler)), socket_, params);
+        server_->start();
+    }
+
+    ~MockHTTPServer() {
+        server_->stopAll(true);
+    }
+
+    std::uint16_t getPort() const {
+        return socket_.address().port();
+    }
+
+    // Return the body of the request, e.g., the text of the query.
+    static std::string readBody(Poco::Net::HTTPServerRequest & request) {
+        std::string body;
+        Poco::StreamCopier::copyToString(request.stream(), body);
+        return body;
+    }
+
+    // Return the value of the parameter in the URI of the request, or an empty string, if there is none.
+    static std::string getQueryParameter(const Poco::Net::HTTPServerRequest & request, const std::string & name) {
+        for (const auto & parameter : Poco::URI(request.getURI()).getQueryParameters()) {
+            if (parameter.first == name)
+                return parameter.second;
+        }
+
+        return {};
+    }
+
+private:
+    class RequestHandler
+        : public Poco::Net::HTTPRequestHandler
+    {
+    public:
+        explicit RequestHandler(const Handler & handler)
+            : handler_(handler)
+        {
+        }
+
+        virtual void handleRequest(Poco::Net::HTTPServerRequest & request, Poco::Net::HTTPServerResponse & response) override {
+            handler_(request, response);
+        }
+
+    private:
+        const Handler & handler_;
+    };
+
+    class HandlerFactory
+        : public Poco::Net::HTTPRequestHandlerFactory
+    {
+    public:
+        explicit HandlerFactory(Handler handler)
+            : handler_(std::move(handler))
+        {
+        }
+
+        virtual Poco::Net::HTTPRequestHandler * createRequestHandler(const Poco::Net::HTTPServerRequest &) override {
+            return new RequestHandler(handler_);
+        }
+
+    private:
+        const Handler handler_;
+    };
+
+private:
+    Poco::Net::ServerSocket socket_;
+    std::unique_ptr<Poco::Net::HTTPServer> server_;
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Poco/Net/NetException.h>
+#include <Poco/Net/ServerSocket.h>
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Timespan.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+
+// A local server, that speaks the native TCP protocol to the driver by calling the handler for each accepted connection, which replays
+// the recorded packets of the server, to test the interaction with the server. The handler is called concurrently, for different connections.
+class MockNativeServer {
+public:
+    using Handler = std::function<void (Poco::Net::StreamSocket & socket)>;
+
+    explicit MockNativeServer(Handler handler)
+        : socket_(Poco::Net::SocketAddress("127.0.0.1", 0))
+        , handler_(std::move(handler))
+        , accept_thread_([this] () { acceptConnections(); })
+    {
+    }
+
+    ~MockNativeServer() {
+        stopped_ = true;
+        accept_thread_.join();
+
+        // The handlers, that still wait for the data from the driver, get the end of it.
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto & connection : connections_) {
+                try {
+                    connection.shutdown();
+                }
+                catch (...) {
+                }
+            }
+        }
+
+        for (auto & thread : connection_threads_) {
+            thread.join();
+        }
+    }
+
+    std::uint16_t getPort() const {
+        return socket_.address().port();
+    }
+
+    // Return the data, that the driver sends, up to and including the tail, e.g., the end of the Hello or the Query packet.
+    // The Ping packets, that the driver sends before reusing the connection, are answered, and are not returned.
+    static std::string receiveUntil(Poco::Net::StreamSocket & socket, const std::string & tail) {
+        static const std::string ping = "\x04";
+        static const std::string pong = "\x04";
+
+        std::string data;
+        char buffer[4096];
+
+        while (data.size() < tail.size() || data.compare(data.size() - tail.size(), tail.size(), tail) != 0) {
+            const auto size = socket.receiveBytes(buffer, sizeof(buffer));
+            if (size <= 0)
+                throw Poco::Net::ConnectionResetException("Connection closed by the driver");
+
+            data.append(buffer, size);
+
+            if (data == ping) {
+                send(socket, pong);
+                data.clear();
+            }
+        }
+
+        return data;
+    }
+
+    static void send(Poco::Net::StreamSocket & socket, const std::string & packets) {
+        for (std::size_t sent = 0; sent < packets.size(); ) {
+            sent += socket.sendBytes(packets.data() + sent, static_cast<int>(packets.size() - sent));
+        }
+    }
+
+private:
+    void acceptConnections() {
+        while (!stopped_) {
+            if (!socket_.poll(Poco::Timespan(0, 10000), Poco::Net::Socket::SELECT_READ))
+                continue;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.emplace_back(socket_.acceptConnection());
+
+            auto & connection = connections_.back();
+            connection_threads_.emplace_back([this, connection] () mutable {
+                // The connection is closed by the driver, when the handler is waiting for more data from it, which ends the handler.
+                try {
+                    handler_(connection);
+                }
+                catch (const Poco::Exception &) {
+                }
+            });
+        }
+    }
+
+private:
+    Poco::Net::ServerSocket socket_;
+    const Handler handler_;
+    std::atomic<bool> stopped_{false};
+    std::mutex mutex_;
+    std::vector<Poco::Net::StreamSocket> connections_;
+    std::vector<std::thread> connection_threads_;
+    std::thread accept_thread_; // Started last, once the rest is initialized.
+};
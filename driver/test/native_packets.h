@@ -0,0 +1,83 @@
+#pragma once
+
+#include "driver/utils/native_protocol.h"
+
+#include <string>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// Builders of the packets of the native protocol, as they are sent by the server, or by the client, to replay them in the tests.
+namespace NativePackets {
+
+    inline std::string varUInt(std::uint64_t value) {
+        std::string res;
+        do {
+            std::uint8_t byte = value & 0b01111111;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0b10000000;
+            res.push_back(static_cast<char>(byte));
+        } while (value != 0);
+        return res;
+    }
+
+    inline std::string string(const std::string & value) {
+        return varUInt(value.size()) + value;
+    }
+
+    template <typename T>
+    inline std::string fixed(T value) {
+        return std::string(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    // A column of a block, with its values already encoded in Native format.
+    struct Column {
+        std::string name;
+        std::string type;
+        std::string data;
+    };
+
+    inline std::string block(const std::vector<Column> & columns, std::size_t row_count) {
+        std::string res = varUInt(1) + fixed<std::uint8_t>(0) + varUInt(2) + fixed<std::int32_t>(-1) + varUInt(0);
+        res += varUInt(columns.size()) + varUInt(row_count);
+
+        for (const auto & column : columns) {
+            res += string(column.name) + string(column.type) + column.data;
+        }
+
+        return res;
+    }
+
+    inline std::string hello(const std::string & name, std::uint64_t major, std::uint64_t minor, std::uint64_t revision, const std::string & timezone) {
+        return varUInt(0) + string(name) + varUInt(major) + varUInt(minor) + varUInt(revision) + string(timezone);
+    }
+
+    // The block of a Data packet of the server, or of the client, is compressed, if the compression is enabled for the query.
+    inline std::string data(const std::string & block_or_frames) {
+        return varUInt(1) + string("") + block_or_frames;
+    }
+
+    // The Data packet of the client with an empty block, that ends the external tables of each query.
+    inline std::string clientEmptyData(bool compression = false) {
+        return varUInt(2) + string("") + (compression ? compressNativeFrame(block({}, 0)) : block({}, 0));
+    }
+
+    inline std::string exception(std::int32_t code, const std::string & name, const std::string & message) {
+        return varUInt(2) + fixed<std::int32_t>(code) + string(name) + string(message) + string("stack trace") + fixed<std::uint8_t>(0);
+    }
+
+    inline std::string progress(std::uint64_t rows, std::uint64_t bytes, std::uint64_t total_rows) {
+        return varUInt(3) + varUInt(rows) + varUInt(bytes) + varUInt(total_rows);
+    }
+
+    inline std::string endOfStream() {
+        return varUInt(5);
+    }
+
+    inline std::string profileInfo(std::uint64_t rows, std::uint64_t blocks, std::uint64_t bytes) {
+        return varUInt(6) + varUInt(rows) + varUInt(blocks) + varUInt(bytes) + fixed<std::uint8_t>(0) + varUInt(0) + fixed<std::uint8_t>(0);
+    }
+
+} // namespace NativePackets
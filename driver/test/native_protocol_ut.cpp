@@ -0,0 +1,304 @@
+#include "driver/utils/native_protocol.h"
+#include "driver/exception.h"
+#include "driver/test/native_packets.h"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstring>
+
+using namespace NativePackets;
+
+namespace {
+
+    // Replays the recorded packets of the server to the client, and records the packets sent by the client.
+    class ReplayedSession {
+    public:
+        explicit ReplayedSession(const std::string & server_packets, bool compression = false)
+            : in(server_packets)
+            , client(in, out, compression)
+        {
+        }
+
+        std::string takeSent() {
+            auto sent = out.str();
+            out.str("");
+            return sent;
+        }
+
+    public:
+        std::istringstream in;
+        std::ostringstream out;
+        NativeProtocolClient client;
+    };
+
+    const NativeProtocolClient::ClientInfo client_info{"test-client", 1, 2};
+
+    std::string serverHello() {
+        return hello("ClickHouse", 21, 8, 54449, "Europe/Berlin");
+    }
+
+    std::string clientHello() {
+        return varUInt(0) + string("test-client") + varUInt(1) + varUInt(2) + varUInt(NativeProtocolClient::revision)
+            + string("db") + string("user") + string("password");
+    }
+
+    std::string clientQuery(const std::string & query_id, const std::string & query, bool compression = false) {
+        return varUInt(1) + string(query_id)
+            + fixed<std::uint8_t>(1) + string("") + string("") + string("0.0.0.0:0") + fixed<std::uint8_t>(1) + string("") + string("")
+            + string("test-client") + varUInt(1) + varUInt(2) + varUInt(NativeProtocolClient::revision) + string("")
+            + string("") + varUInt(2) + varUInt(compression ? 1 : 0) + string(query)
+            + clientEmptyData(compression);
+    }
+
+    // Prepend the checksum, that covers the header and the compressed data of the frame.
+    std::string withChecksum(const std::string & frame) {
+        const auto checksum = cityHash128(frame.data(), frame.size());
+        return fixed<std::uint64_t>(checksum.first) + fixed<std::uint64_t>(checksum.second) + frame;
+    }
+
+    // A frame of the data, that is stored uncompressed.
+    std::string uncompressedFrame(const std::string & data) {
+        return withChecksum(fixed<std::uint8_t>(0x02) + fixed<std::uint32_t>(9 + data.size()) + fixed<std::uint32_t>(data.size()) + data);
+    }
+
+    std::string readAll(std::istream & in) {
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    // Decompress the only frame, skipping its checksum and header.
+    std::string decompress(const std::string & frame) {
+        std::uint32_t size = 0;
+        std::memcpy(&size, frame.data() + 21, sizeof(size));
+
+        std::string data(size, '\0');
+        decompressLZ4Block(frame.data() + 25, frame.size() - 25, &data[0], data.size());
+        return data;
+    }
+
+} // namespace
+
+TEST(NativeProtocol, Handshake) {
+    ReplayedSession session(serverHello());
+    session.client.handshake(client_info, "db", "user", "password");
+
+    EXPECT_EQ(session.takeSent(), clientHello());
+
+    const auto & server_info = session.client.getServerInfo();
+    EXPECT_EQ(server_info.name, "ClickHouse");
+    EXPECT_EQ(server_info.version_major, 21);
+    EXPECT_EQ(server_info.version_minor, 8);
+    EXPECT_EQ(server_info.revision, 54449);
+    EXPECT_EQ(server_info.timezone, "Europe/Berlin");
+}
+
+TEST(NativeProtocol, HandshakeRejected) {
+    ReplayedSession session(exception(516, "DB::Exception", "DB::Exception: default: Authentication failed"));
+
+    try {
+        session.client.handshake(client_info, "db", "user", "password");
+        FAIL() << "Handshake succeeded";
+    }
+    catch (const NativeServerException & ex) {
+        EXPECT_EQ(ex.getCode(), 516);
+        EXPECT_EQ(ex.getName(), "DB::Exception");
+        EXPECT_STREQ(ex.what(), "Code: 516. DB::Exception: default: Authentication failed");
+    }
+}
+
+TEST(NativeProtocol, ResultsAreReadAsRowBinary) {
+    const auto header = block({{"x", "UInt32", ""}, {"s", "Nullable(String)", ""}}, 0);
+    const auto rows = block({
+        {"x", "UInt32", fixed<std::uint32_t>(1) + fixed<std::uint32_t>(2)},
+        {"s", "Nullable(String)", std::string("\0\1", 2) + string("a") + string("")}
+    }, 2);
+
+    ReplayedSession session(serverHello() + data(header) + progress(2, 10, 2) + data(rows) + profileInfo(2, 1, 10) + endOfStream());
+    session.client.handshake(client_info, "db", "user", "password");
+    session.takeSent();
+
+    session.client.sendQuery("query-1", "SELECT x, s FROM t");
+    EXPECT_EQ(session.takeSent(), clientQuery("query-1", "SELECT x, s FROM t"));
+    EXPECT_TRUE(session.client.isQueryRunning());
+
+    auto results = makeNativeResultStream(session.client);
+    EXPECT_EQ(readAll(*results),
+        varUInt(2) + string("x") + string("s") + string("UInt32") + string("Nullable(String)")
+        + fixed<std::uint32_t>(1) + fixed<std::uint8_t>(0) + string("a")
+        + fixed<std::uint32_t>(2) + fixed<std::uint8_t>(1)
+    );
+
+    EXPECT_FALSE(session.client.isQueryRunning());
+    EXPECT_EQ(session.client.getProgress().rows, 2);
+    EXPECT_EQ(session.client.getProgress().bytes, 10);
+
+    // Nothing is sent in reply to the results of a SELECT query.
+    EXPECT_EQ(session.takeSent(), "");
+}
+
+TEST(NativeProtocol, ExceptionEndsResults) {
+    const auto header = block({{"x", "UInt32", ""}}, 0);
+    ReplayedSession session(data(header) + exception(60, "DB::Exception", "DB::Exception: Table default.t doesn't exist"));
+
+    session.client.sendQuery("query-1", "SELECT x FROM t");
+
+    NativeProtocolClient::Block block;
+    EXPECT_TRUE(session.client.receiveBlock(block));
+    EXPECT_EQ(block.row_count, 0);
+    EXPECT_THROW(session.client.receiveBlock(block), NativeServerException);
+    EXPECT_FALSE(session.client.isQueryRunning());
+    EXPECT_FALSE(session.client.receiveBlock(block));
+}
+
+TEST(NativeProtocol, TypesAreReencoded) {
+    const auto rows = block({
+        {"dt", "DateTime('Europe/Berlin')", fixed<std::uint32_t>(1600000000)},
+        {"b", "Bool", fixed<std::uint8_t>(1)},
+        {"n", "Nullable(Nothing)", fixed<std::uint8_t>(1) + fixed<std::uint8_t>(0)},
+        {"d", "Decimal(10, 2)", fixed<std::int64_t>(12345)},
+        {"fs", "FixedString(3)", "abc"},
+        {"d9", "Decimal(9, 2)", fixed<std::int32_t>(-1)}
+    }, 1);
+
+    ReplayedSession session(data(rows) + endOfStream());
+    session.client.sendQuery("query-1", "SELECT ...");
+
+    NativeProtocolClient::Block block;
+    ASSERT_TRUE(session.client.receiveBlock(block));
+
+    EXPECT_EQ(block.column_names, (std::vector<std::string>{"dt", "b", "n", "d", "fs", "d9"}));
+    EXPECT_EQ(block.column_types, (std::vector<std::string>{
+        "DateTime", "UInt8", "Nullable(Nothing)", "Decimal(10, 2)", "FixedString(3)", "Decimal(9, 2)"
+    }));
+    EXPECT_EQ(block.row_count, 1);
+    EXPECT_EQ(block.rows,
+        fixed<std::uint32_t>(1600000000) + fixed<std::uint8_t>(1) + fixed<std::uint8_t>(1) + fixed<std::int64_t>(12345) + "abc" + fixed<std::int32_t>(-1)
+    );
+
+    EXPECT_FALSE(session.client.receiveBlock(block));
+}
+
+TEST(NativeProtocol, UnsupportedTypeFails) {
+    const auto rows = block({{"a", "Array(UInt8)", varUInt(0)}}, 1);
+    ReplayedSession session(data(rows) + endOfStream());
+    session.client.sendQuery("query-1", "SELECT []");
+
+    NativeProtocolClient::Block block;
+    EXPECT_THROW(session.client.receiveBlock(block), std::runtime_error);
+}
+
+TEST(NativeProtocol, InsertDataIsEnded) {
+    const auto table_structure = block({{"x", "UInt32", ""}}, 0);
+    ReplayedSession session(serverHello() + data(table_structure) + endOfStream());
+    session.client.handshake(client_info, "db", "user", "password");
+    session.takeSent();
+
+    const std::string query = " /* comment */ insert into t (x) format RowBinary";
+    session.client.sendQuery("query-1", query);
+
+    NativeProtocolClient::Block block;
+    EXPECT_FALSE(session.client.receiveBlock(block));
+
+    // The structure of the table is answered with the empty data.
+    EXPECT_EQ(session.takeSent(), clientQuery("query-1", query) + clientEmptyData());
+}
+
+TEST(NativeProtocol, CompressedBlocksAreRead) {
+    const auto rows = block({{"s", "String", string("abcabcabcabc") + string("xyzzz")}}, 2);
+
+    // A frame of the data, that is compressed with a match, and another one, that is not compressed at all.
+    const auto split_pos = rows.size() - 19;
+    const auto head = rows.substr(0, split_pos);
+    const auto tail = rows.substr(split_pos);
+    ASSERT_EQ(tail, string("abcabcabcabc") + string("xyzzz"));
+
+    const std::string lz4_tail("\x45" "\x0c" "abc" "\x03\x00" "\x60" "\x05" "xyzzz", 14);
+    const auto lz4_frame = withChecksum(fixed<std::uint8_t>(0x82) + fixed<std::uint32_t>(9 + lz4_tail.size()) + fixed<std::uint32_t>(tail.size()) + lz4_tail);
+
+    ReplayedSession session(serverHello() + data(compressNativeFrame(head) + lz4_frame) + data(uncompressedFrame(rows)) + endOfStream(), true);
+    session.client.handshake(client_info, "db", "user", "password");
+    session.takeSent();
+
+    session.client.sendQuery("query-1", "SELECT s FROM t");
+    EXPECT_EQ(session.takeSent(), clientQuery("query-1", "SELECT s FROM t", true));
+
+    NativeProtocolClient::Block block;
+    ASSERT_TRUE(session.client.receiveBlock(block));
+    EXPECT_EQ(block.row_count, 2);
+    EXPECT_EQ(block.rows, string("abcabcabcabc") + string("xyzzz"));
+
+    ASSERT_TRUE(session.client.receiveBlock(block));
+    EXPECT_EQ(block.rows, string("abcabcabcabc") + string("xyzzz"));
+
+    EXPECT_FALSE(session.client.receiveBlock(block));
+}
+
+TEST(NativeProtocol, ChecksumMismatchFails) {
+    const auto rows = block({{"s", "String", string("abc")}}, 1);
+
+    // A single flipped bit of the data.
+    const auto frame = uncompressedFrame(rows);
+    const auto corrupted_frame = frame.substr(0, frame.size() - 1) + static_cast<char>(frame.back() ^ 0x01);
+
+    ReplayedSession session(serverHello() + data(corrupted_frame) + endOfStream(), true);
+    session.client.handshake(client_info, "db", "user", "password");
+    session.client.sendQuery("query-1", "SELECT s FROM t");
+
+    NativeProtocolClient::Block block;
+
+    try {
+        session.client.receiveBlock(block);
+        FAIL() << "The corrupted frame is accepted";
+    }
+    catch (const SqlException & ex) {
+        EXPECT_EQ(ex.getSQLState(), "08S01");
+    }
+}
+
+TEST(NativeProtocol, LZ4Decompression) {
+    // A match, that overlaps with its own output.
+    const std::string overlapping = std::string("\x13" "a" "\x01\x00", 4) + "\x10" "b";
+    std::string data(9, '\0');
+    decompressLZ4Block(overlapping.data(), overlapping.size(), &data[0], data.size());
+    EXPECT_EQ(data, "aaaaaaaab");
+
+    // The lengths of the literals, that are extended beyond 14 bytes.
+    for (const std::size_t size : {0, 14, 15, 16, 269, 270, 1000}) {
+        std::string original(size, '\0');
+        for (std::size_t i = 0; i < size; ++i) {
+            original[i] = static_cast<char>(i * 7);
+        }
+
+        EXPECT_EQ(decompress(compressNativeFrame(original)), original);
+    }
+}
+
+TEST(NativeProtocol, MalformedLZ4Fails) {
+    std::string data(8, '\0');
+
+    // The offset points before the beginning of the data.
+    const std::string too_far = std::string("\x10" "a" "\x02\x00", 4) + "\x10" "b";
+    EXPECT_THROW(decompressLZ4Block(too_far.data(), too_far.size(), &data[0], 6), std::runtime_error);
+
+    // The literals are truncated.
+    const std::string truncated = "\x50" "ab";
+    EXPECT_THROW(decompressLZ4Block(truncated.data(), truncated.size(), &data[0], 5), std::runtime_error);
+
+    // The data is shorter than expected.
+    const std::string short_data = "\x20" "ab";
+    EXPECT_THROW(decompressLZ4Block(short_data.data(), short_data.size(), &data[0], 3), std::runtime_error);
+
+    // The match does not fit the expected size.
+    const std::string long_match = std::string("\x1f" "a" "\x01\x00" "\x00", 5) + "\x10" "b";
+    EXPECT_THROW(decompressLZ4Block(long_match.data(), long_match.size(), &data[0], data.size()), std::runtime_error);
+}
+
+TEST(NativeProtocol, CityHash128) {
+    EXPECT_EQ(cityHash128("", 0), (std::pair<std::uint64_t, std::uint64_t>(0x3df09dfc64c09a2bULL, 0x3cb540c392e51e29ULL)));
+}
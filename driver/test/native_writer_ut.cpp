@@ -0,0 +1,153 @@
+#include "driver/format/NativeWriter.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+
+namespace {
+
+    ColumnInfo makeColumnInfo(const std::string & name, const std::string & type) {
+        ColumnInfo column_info;
+        column_info.name = name;
+        column_info.type = type;
+
+        TypeParser parser{type};
+        TypeAst ast;
+
+        if (parser.parse(&ast))
+            column_info.assignTypeInfo(ast);
+
+        column_info.updateTypeInfo();
+        return column_info;
+    }
+
+    // Minimal reader of the parts of Native format, that are produced by the writer.
+    class NativeReader {
+    public:
+        explicit NativeReader(const std::string & data)
+            : data_(data)
+        {
+        }
+
+        std::uint64_t readULEB128() {
+            std::uint64_t value = 0;
+            for (unsigned shift = 0;; shift += 7) {
+                const auto byte = static_cast<std::uint8_t>(data_.at(pos_++));
+                value |= static_cast<std::uint64_t>(byte & 0b01111111) << shift;
+                if ((byte & 0b10000000) == 0)
+                    break;
+            }
+            return value;
+        }
+
+        std::string readString() {
+            const auto size = readULEB128();
+            const auto value = data_.substr(pos_, size);
+            pos_ += size;
+            return value;
+        }
+
+        template <typename T>
+        T readPOD() {
+            T value;
+            std::memcpy(&value, &data_.at(pos_), sizeof(value));
+            pos_ += sizeof(value);
+            return value;
+        }
+
+        bool eof() const {
+            return (pos_ == data_.size());
+        }
+
+    private:
+        const std::string & data_;
+        std::size_t pos_ = 0;
+    };
+
+} // namespace
+
+TEST(NativeWriter, ColumnWiseArrays) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "Native format is supported only on little-endian platforms";
+
+    std::vector<ColumnInfo> columns_info;
+    columns_info.push_back(makeColumnInfo("i", "Int32"));
+    columns_info.push_back(makeColumnInfo("u", "Nullable(UInt16)"));
+    columns_info.push_back(makeColumnInfo("s", "String"));
+    columns_info.push_back(makeColumnInfo("d", "Date"));
+
+    NativeWriter writer(columns_info);
+    EXPECT_EQ(writer.getStructure(), "`i` Nullable(Int32), `u` Nullable(UInt16), `s` Nullable(String), `d` Nullable(String)");
+
+    constexpr std::size_t row_count = 3;
+    constexpr std::size_t str_size = 8;
+
+    SQLINTEGER i[row_count] = { -1, 0, 1 };
+    char u[row_count][str_size] = { "1", "65535", "7" };
+    char s[row_count][str_size] = { "it's", "", "abc" };
+    SQL_DATE_STRUCT d[row_count] = { { 2020, 2, 29 }, { 1970, 1, 1 }, { 2000, 12, 31 } };
+
+    SQLLEN i_ind[row_count] = { 0, SQL_NULL_DATA, 0 };
+    SQLLEN u_ind[row_count] = { SQL_NTS, SQL_NTS, SQL_NULL_DATA };
+    SQLLEN s_ind[row_count] = { 4, SQL_NTS, SQL_NTS };
+    SQLLEN d_ind[row_count] = { 0, 0, 0 };
+
+    std::vector<BindingInfo> bindings(4);
+
+    bindings[0].c_type = SQL_C_SLONG;
+    bindings[0].value = i;
+    bindings[0].value_size = bindings[0].indicator = i_ind;
+
+    bindings[1].c_type = SQL_C_CHAR;
+    bindings[1].value = u;
+    bindings[1].value_max_size = str_size;
+    bindings[1].value_size = bindings[1].indicator = u_ind;
+
+    bindings[2].c_type = SQL_C_CHAR;
+    bindings[2].value = s;
+    bindings[2].value_max_size = str_size;
+    bindings[2].value_size = bindings[2].indicator = s_ind;
+
+    bindings[3].c_type = SQL_C_TYPE_DATE;
+    bindings[3].value = d;
+    bindings[3].value_size = bindings[3].indicator = d_ind;
+
+    // The rows after the first one only.
+    std::string data;
+    writer.writeBlock(bindings, 1, 2, data);
+
+    NativeReader reader(data);
+    ASSERT_EQ(reader.readULEB128(), 4);
+    ASSERT_EQ(reader.readULEB128(), 2);
+
+    EXPECT_EQ(reader.readString(), "i");
+    EXPECT_EQ(reader.readString(), "Nullable(Int32)");
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 1);
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    reader.readPOD<std::int32_t>(); // The value of a NULL element is irrelevant.
+    EXPECT_EQ(reader.readPOD<std::int32_t>(), 1);
+
+    EXPECT_EQ(reader.readString(), "u");
+    EXPECT_EQ(reader.readString(), "Nullable(UInt16)");
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 1);
+    EXPECT_EQ(reader.readPOD<std::uint16_t>(), 65535);
+    reader.readPOD<std::uint16_t>();
+
+    EXPECT_EQ(reader.readString(), "s");
+    EXPECT_EQ(reader.readString(), "Nullable(String)");
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    EXPECT_EQ(reader.readString(), "");
+    EXPECT_EQ(reader.readString(), "abc");
+
+    EXPECT_EQ(reader.readString(), "d");
+    EXPECT_EQ(reader.readString(), "Nullable(String)");
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    EXPECT_EQ(reader.readPOD<std::uint8_t>(), 0);
+    EXPECT_EQ(reader.readString(), "1970-01-01");
+    EXPECT_EQ(reader.readString(), "2000-12-31");
+
+    EXPECT_TRUE(reader.eof());
+}
@@ -4,10 +4,16 @@
 #include "driver/environment.h"
 #include "driver/connection.h"
 #include "driver/statement.h"
+#include "driver/result_set.h"
+#include "driver/utils/query_template.h"
 #include "driver/test/common_utils.h"
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <cstring>
 
 class PerformanceTest
@@ -124,3 +130,220 @@ TEST_F(PerformanceTest, ENABLE_FOR_OPTIMIZED_BUILDS_ONLY(DispatchWith_CALL_WITH_
 
     STOP_MEASURING_TIME_AND_REPORT(call_count);
 }
+
+namespace {
+
+    // Produces the same data set, equivalent to
+    //     SELECT CAST('some not very long text', 'String') AS col1, CAST(number, 'Int32') AS col2,
+    //            CAST('-123.456789012345678', 'Float64') AS col3, if(number % 3 = 0, NULL, 'text\twith\\escapes') AS col4
+    // encoded in all the formats supported by the driver.
+    class MultiTypeDataGenerator {
+    public:
+        static inline const std::vector<std::string> names = { "col1", "col2", "col3", "col4" };
+        static inline const std::vector<std::string> types = { "String", "Int32", "Float64", "Nullable(String)" };
+
+        static inline const std::string col1 = "some not very long text";
+        static inline const std::string col3_text = "-123.456789012345678";
+        static inline const std::string col4 = "text\twith\\escapes";
+        static inline const std::string col4_tsv = "text\\twith\\\\escapes";
+        static constexpr double col3 = -123.456789012345678;
+
+        static std::string generate(const std::string & format, const std::size_t rows) {
+            std::string data;
+
+            if (format == "ODBCDriver2") {
+                writeInt32(data, 2);
+
+                for (const auto * header : { &names, &types }) {
+                    writeInt32(data, static_cast<std::int32_t>(header->size() + 1));
+                    writeSizedString(data, (header == &names ? "name" : "type"));
+                    for (const auto & value : *header) {
+                        writeSizedString(data, value);
+                    }
+                }
+
+                for (std::size_t i = 0; i < rows; ++i) {
+                    writeSizedString(data, col1);
+                    writeSizedString(data, std::to_string(static_cast<std::int32_t>(i)));
+                    writeSizedString(data, col3_text);
+                    if (i % 3 == 0)
+                        writeInt32(data, -1);
+                    else
+                        writeSizedString(data, col4);
+                }
+            }
+            else if (format == "RowBinaryWithNamesAndTypes") {
+                writeRowBinaryHeader(data, names, types);
+
+                for (std::size_t i = 0; i < rows; ++i) {
+                    writeRowBinaryString(data, col1);
+                    writePOD(data, static_cast<std::int32_t>(i));
+                    writePOD(data, col3);
+                    if (i % 3 == 0) {
+                        data += '\1';
+                    }
+                    else {
+                        data += '\0';
+                        writeRowBinaryString(data, col4);
+                    }
+                }
+            }
+            else if (format == "TabSeparatedWithNamesAndTypes") {
+                for (const auto * header : { &names, &types }) {
+                    for (std::size_t j = 0; j < header->size(); ++j) {
+                        data += (*header)[j];
+                        data += (j + 1 < header->size() ? '\t' : '\n');
+                    }
+                }
+
+                for (std::size_t i = 0; i < rows; ++i) {
+                    data += col1;
+                    data += '\t';
+                    data += std::to_string(static_cast<std::int32_t>(i));
+                    data += '\t';
+                    data += col3_text;
+                    data += '\t';
+                    data += (i % 3 == 0 ? "\\N" : col4_tsv);
+                    data += '\n';
+                }
+            }
+            else {
+                throw std::runtime_error("'" + format + "' format is not supported by the generator");
+            }
+
+            return data;
+        }
+
+    private:
+        static void writeInt32(std::string & dest, const std::int32_t value) {
+            writePOD(dest, value);
+        }
+
+        static void writeSizedString(std::string & dest, const std::string & value) {
+            writeInt32(dest, static_cast<std::int32_t>(value.size()));
+            dest += value;
+        }
+
+    };
+
+} // namespace
+
+TEST_F(PerformanceTest, ENABLE_FOR_OPTIMIZED_BUILDS_ONLY(DecodeMultiTypeInAllFormats)) {
+    constexpr std::size_t total_rows_expected = 5'000'000;
+
+    for (const std::string format : { "ODBCDriver2", "RowBinaryWithNamesAndTypes", "TabSeparatedWithNamesAndTypes" }) {
+        const auto data = MultiTypeDataGenerator::generate(format, total_rows_expected);
+
+        std::cout << "Decoding " << total_rows_expected << " rows (" << data.size() << " bytes) in " << format << " format:" << std::endl;
+
+        std::istringstream stream(data);
+        std::size_t total_rows = 0;
+
+        START_MEASURING_TIME();
+
+        auto reader = make_result_reader(format, stream, std::unique_ptr<ResultMutator>{});
+        ASSERT_TRUE(reader->hasResultSet());
+
+        auto & result_set = reader->getResultSet();
+        ASSERT_EQ(result_set.getColumnCount(), MultiTypeDataGenerator::names.size());
+
+        while (true) {
+            const auto rows = result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 1000);
+            if (rows == 0)
+                break;
+            total_rows += rows;
+        }
+
+        STOP_MEASURING_TIME_AND_REPORT(total_rows);
+
+        ASSERT_EQ(total_rows, total_rows_expected);
+    }
+}
+
+TEST_F(PerformanceTest, ENABLE_FOR_OPTIMIZED_BUILDS_ONLY(DecodeRowBinaryInParallel)) {
+    constexpr std::size_t total_rows_expected = 5'000'000;
+    const std::string format = "RowBinaryWithNamesAndTypes";
+    const auto data = MultiTypeDataGenerator::generate(format, total_rows_expected);
+
+    for (const std::size_t decode_threads : { 1, 2, 4, 8 }) {
+        std::cout << "Decoding " << total_rows_expected << " rows (" << data.size() << " bytes) in " << format << " format using " << decode_threads << " thread(s):" << std::endl;
+
+        std::istringstream stream(data);
+        std::size_t total_rows = 0;
+
+        START_MEASURING_TIME();
+
+        auto reader = make_result_reader(format, stream, std::unique_ptr<ResultMutator>{}, decode_threads);
+        ASSERT_TRUE(reader->hasResultSet());
+
+        auto & result_set = reader->getResultSet();
+        ASSERT_EQ(result_set.getColumnCount(), MultiTypeDataGenerator::names.size());
+
+        while (true) {
+            const auto rows = result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 1000);
+            if (rows == 0)
+                break;
+            total_rows += rows;
+        }
+
+        STOP_MEASURING_TIME_AND_REPORT(total_rows);
+
+        ASSERT_EQ(total_rows, total_rows_expected);
+    }
+}
+
+TEST_F(PerformanceTest, ENABLE_FOR_OPTIMIZED_BUILDS_ONLY(RenderQueryWithManyParameters)) {
+    constexpr std::size_t param_count = 5'000;
+    constexpr std::size_t query_size = 1'000'000;
+    constexpr std::size_t render_count = 1'000;
+
+    // A ~1 MB query with the parameters evenly spread over it.
+    std::string source_query = "SELECT * FROM t WHERE 1";
+    const std::string filler((query_size / param_count) - std::strlen(" AND c = ?"), ' ');
+    for (std::size_t i = 0; i < param_count; ++i) {
+        source_query += filler;
+        source_query += " AND c = ?";
+    }
+
+    std::cout << "Extracting " << param_count << " parameters from " << source_query.size() << " bytes query:" << std::endl;
+
+    std::vector<ParamInfo> parameters;
+    std::string query;
+
+    {
+        START_MEASURING_TIME();
+
+        query = source_query;
+        parameters = extractQueryParameters(query);
+
+        STOP_MEASURING_TIME_AND_REPORT(1);
+    }
+
+    ASSERT_EQ(parameters.size(), param_count);
+
+    std::cout << "Rendering the query " << render_count << " times:" << std::endl;
+
+    std::size_t total_size = 0;
+
+    {
+        START_MEASURING_TIME();
+
+        for (std::size_t i = 0; i < render_count; ++i) {
+            std::string rendered;
+            rendered.reserve(query.size() + parameters.size() * 32);
+
+            renderQuery(rendered, query, parameters, [] (std::size_t param_idx, std::string & dest) -> std::size_t {
+                dest += "{odbc_positional_";
+                dest += std::to_string(param_idx + 1);
+                dest += ":Nullable(Int32)}";
+                return 1;
+            });
+
+            total_size += rendered.size();
+        }
+
+        STOP_MEASURING_TIME_AND_REPORT(render_count);
+    }
+
+    ASSERT_GT(total_size, source_query.size() * render_count);
+}
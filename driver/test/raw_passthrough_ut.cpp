@@ -0,0 +1,78 @@
+#include "driver/format/RawPassthrough.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+TEST(RawPassthrough, ReadInPieces) {
+    std::string body;
+    for (int i = 0; i < 1000; ++i) {
+        body += std::to_string(i) + "\t" + std::to_string(i * i) + "\n";
+    }
+
+    std::istringstream stream(body);
+    RawPassthroughResultReader reader(stream, std::unique_ptr<ResultMutator>{});
+    ASSERT_TRUE(reader.hasResultSet());
+
+    auto & result_set = reader.getResultSet();
+    ASSERT_EQ(result_set.getColumnCount(), 1);
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 1), 1);
+
+    std::string received;
+    char buffer[1000];
+    SQLLEN indicator = 0;
+
+    BindingInfo binding_info;
+    binding_info.c_type = SQL_C_BINARY;
+    binding_info.value = buffer;
+    binding_info.value_max_size = sizeof(buffer);
+    binding_info.value_size = &indicator;
+    binding_info.indicator = &indicator;
+
+    while (true) {
+        try {
+            const auto rc = result_set.extractField(0, 0, binding_info);
+            if (rc == SQL_NO_DATA)
+                break;
+
+            ASSERT_EQ(rc, SQL_SUCCESS);
+            ASSERT_GE(indicator, 0);
+            received.append(buffer, indicator);
+        }
+        catch (const SqlException & ex) {
+            ASSERT_EQ(ex.getSQLState(), "01004");
+            ASSERT_EQ(indicator, SQL_NO_TOTAL);
+            received.append(buffer, sizeof(buffer));
+        }
+    }
+
+    EXPECT_EQ(received, body);
+    EXPECT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 1), 0);
+}
+
+TEST(RawPassthrough, RestrictedTargetType) {
+    std::istringstream stream("abc");
+    RawPassthroughResultReader reader(stream, std::unique_ptr<ResultMutator>{});
+
+    auto & result_set = reader.getResultSet();
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 1), 1);
+
+    char buffer[16];
+    BindingInfo binding_info;
+    binding_info.c_type = SQL_C_LONG;
+    binding_info.value = buffer;
+    binding_info.value_max_size = sizeof(buffer);
+
+    EXPECT_THROW(result_set.extractField(0, 0, binding_info), SqlException);
+}
+
+TEST(RawPassthrough, BinaryColumnForGetDataOnly) {
+    std::istringstream stream("abc");
+    RawPassthroughResultReader reader(stream, std::unique_ptr<ResultMutator>{});
+
+    auto & result_set = reader.getResultSet();
+    ASSERT_NE(result_set.getColumnInfo(0).type_info, nullptr);
+    EXPECT_EQ(result_set.getColumnInfo(0).type_info->sql_type, SQL_LONGVARBINARY);
+    EXPECT_FALSE(result_set.supportsBoundColumns());
+}
@@ -0,0 +1,126 @@
+#include "driver/result_set.h"
+#include "driver/test/common_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(RowBinaryReader, FixedStringBinaryRoundTrip) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "RowBinaryWithNamesAndTypes format is supported only on little-endian platforms";
+
+    // The values, including their zero bytes, must be read back exactly as they were sent.
+    const std::string values[] = {
+        std::string("ab\0\0", 4),
+        std::string("\0\0\0\0", 4),
+        std::string("a\0b\0", 4),
+        std::string("\0abc", 4)
+    };
+
+    std::string data;
+    writeRowBinaryHeader(data, { "f" }, { "FixedString(4)" });
+
+    for (const auto & value : values) {
+        data += value;
+    }
+
+    std::istringstream stream(data);
+    auto reader = make_result_reader("RowBinaryWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{});
+    auto & result_set = reader->getResultSet();
+
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 10), lengthof(values));
+
+    for (std::size_t i = 0; i < lengthof(values); ++i) {
+        char buffer[16] = {};
+        SQLLEN ind = 0;
+
+        BindingInfo binding_info;
+        binding_info.c_type = SQL_C_BINARY;
+        binding_info.value = buffer;
+        binding_info.value_max_size = sizeof(buffer);
+        binding_info.value_size = binding_info.indicator = &ind;
+
+        ASSERT_EQ(result_set.extractField(i, 0, binding_info), SQL_SUCCESS);
+        ASSERT_EQ(ind, 4);
+        EXPECT_EQ(std::string(buffer, ind), values[i]) << "row: " << i;
+    }
+}
+
+TEST(RowBinaryReader, ParallelDecodingMatchesSerial) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "RowBinaryWithNamesAndTypes format is supported only on little-endian platforms";
+
+    // Enough rows for many chunks, with values of different sizes, so that the chunks are cut at different positions.
+    constexpr std::size_t row_count = 10000;
+
+    std::string data;
+    writeRowBinaryHeader(data,
+        { "i", "s", "ns", "lc", "ni" },
+        { "Int32", "String", "Nullable(String)", "LowCardinality(String)", "Nullable(Int64)" }
+    );
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        writePOD(data, static_cast<std::int32_t>(i) - 5000);
+        writeRowBinaryString(data, std::string(i % 300, 'a' + i % 26));
+
+        if (i % 3 == 0) {
+            data += '\1';
+        }
+        else {
+            data += '\0';
+            writeRowBinaryString(data, "value " + std::to_string(i));
+        }
+
+        writeRowBinaryString(data, "category " + std::to_string(i % 7));
+
+        if (i % 5 == 0) {
+            data += '\1';
+        }
+        else {
+            data += '\0';
+            writePOD(data, static_cast<std::int64_t>(i) * 1000000007);
+        }
+    }
+
+    // Read all values of the result set as text, with NULLs as "NULL".
+    const auto read_all = [&] (std::size_t decode_threads) {
+        std::istringstream stream(data);
+        auto reader = make_result_reader("RowBinaryWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{}, decode_threads);
+        auto & result_set = reader->getResultSet();
+
+        std::vector<std::string> values;
+
+        while (true) {
+            const auto rows = result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 100);
+            if (rows == 0)
+                break;
+
+            for (std::size_t row_idx = 0; row_idx < rows; ++row_idx) {
+                for (std::size_t column_idx = 0; column_idx < result_set.getColumnCount(); ++column_idx) {
+                    char buffer[512] = {};
+                    SQLLEN ind = 0;
+
+                    BindingInfo binding_info;
+                    binding_info.c_type = SQL_C_CHAR;
+                    binding_info.value = buffer;
+                    binding_info.value_max_size = sizeof(buffer);
+                    binding_info.value_size = binding_info.indicator = &ind;
+
+                    EXPECT_EQ(result_set.extractField(row_idx, column_idx, binding_info), SQL_SUCCESS);
+                    values.emplace_back(ind == SQL_NULL_DATA ? "NULL" : std::string(buffer, ind));
+                }
+            }
+        }
+
+        return values;
+    };
+
+    const auto serial_values = read_all(1);
+    ASSERT_EQ(serial_values.size(), row_count * 5);
+
+    for (const std::size_t decode_threads : { 2, 4, 8 }) {
+        EXPECT_EQ(read_all(decode_threads), serial_values) << "decode threads: " << decode_threads;
+    }
+}
@@ -0,0 +1,120 @@
+#include "driver/format/RowBinaryWriter.h"
+#include "driver/test/common_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+namespace {
+
+    ColumnInfo makeColumnInfo(const std::string & name, const std::string & type) {
+        ColumnInfo column_info;
+        column_info.name = name;
+        column_info.type = type;
+
+        TypeParser parser{type};
+        TypeAst ast;
+
+        if (parser.parse(&ast))
+            column_info.assignTypeInfo(ast);
+
+        column_info.updateTypeInfo();
+        return column_info;
+    }
+
+} // namespace
+
+TEST(RowBinaryWriter, RoundTrip) {
+    if (!is_little_endian())
+        GTEST_SKIP() << "RowBinary format is supported only on little-endian platforms";
+
+    std::vector<ColumnInfo> columns_info;
+    columns_info.push_back(makeColumnInfo("i", "Int32"));
+    columns_info.push_back(makeColumnInfo("u", "UInt16"));
+    columns_info.push_back(makeColumnInfo("s", "Nullable(String)"));
+    columns_info.push_back(makeColumnInfo("d", "Date"));
+
+    RowBinaryWriter writer(columns_info);
+    EXPECT_EQ(writer.getStructure(), "`i` Int32, `u` UInt16, `s` Nullable(String), `d` String");
+
+    SQLINTEGER i = -42;
+    char u[] = "65535";
+    char s[] = "it's";
+    SQL_DATE_STRUCT d = { 2020, 2, 29 };
+
+    SQLLEN i_ind = 0;
+    SQLLEN u_ind = SQL_NTS;
+    SQLLEN s_ind = SQL_NULL_DATA;
+    SQLLEN d_ind = 0;
+
+    std::vector<BindingInfo> bindings(4);
+
+    bindings[0].c_type = SQL_C_SLONG;
+    bindings[0].value = &i;
+    bindings[0].value_size = bindings[0].indicator = &i_ind;
+
+    bindings[1].c_type = SQL_C_CHAR;
+    bindings[1].value = u;
+    bindings[1].value_max_size = sizeof(u);
+    bindings[1].value_size = bindings[1].indicator = &u_ind;
+
+    bindings[2].c_type = SQL_C_CHAR;
+    bindings[2].value = s;
+    bindings[2].value_max_size = sizeof(s);
+    bindings[2].value_size = bindings[2].indicator = &s_ind;
+
+    bindings[3].c_type = SQL_C_TYPE_DATE;
+    bindings[3].value = &d;
+    bindings[3].value_size = bindings[3].indicator = &d_ind;
+
+    // Prepend the header, so that the result can be read back by RowBinaryWithNamesAndTypes reader.
+    std::string data;
+    writeRowBinaryHeader(data, { "i", "u", "s", "d" }, { "Int32", "UInt16", "Nullable(String)", "String" });
+
+    writer.writeRow(bindings, data);
+
+    s_ind = SQL_NTS;
+    writer.writeRow(bindings, data);
+
+    std::istringstream stream(data);
+    auto reader = make_result_reader("RowBinaryWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{});
+    auto & result_set = reader->getResultSet();
+
+    ASSERT_EQ(result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 10), 2);
+
+    SQLBIGINT number = 0;
+    char str[32] = {};
+    SQLLEN ind = 0;
+
+    BindingInfo number_binding;
+    number_binding.c_type = SQL_C_SBIGINT;
+    number_binding.value = &number;
+    number_binding.value_size = number_binding.indicator = &ind;
+
+    BindingInfo str_binding;
+    str_binding.c_type = SQL_C_CHAR;
+    str_binding.value = str;
+    str_binding.value_max_size = sizeof(str);
+    str_binding.value_size = str_binding.indicator = &ind;
+
+    ASSERT_EQ(result_set.extractField(0, 0, number_binding), SQL_SUCCESS);
+    EXPECT_EQ(number, -42);
+
+    ASSERT_EQ(result_set.extractField(0, 1, number_binding), SQL_SUCCESS);
+    EXPECT_EQ(number, 65535);
+
+    ASSERT_EQ(result_set.extractField(0, 2, str_binding), SQL_SUCCESS);
+    EXPECT_EQ(ind, SQL_NULL_DATA);
+
+    ASSERT_EQ(result_set.extractField(0, 3, str_binding), SQL_SUCCESS);
+    EXPECT_EQ(std::string(str), "2020-02-29");
+
+    ASSERT_EQ(result_set.extractField(1, 2, str_binding), SQL_SUCCESS);
+    EXPECT_EQ(std::string(str), "it's");
+
+    s_ind = SQL_NULL_DATA;
+    bindings[0].value = nullptr;
+    std::string dummy;
+    EXPECT_THROW(writer.writeRow(bindings, dummy), SqlException);
+}
@@ -6,6 +6,8 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <cstring>
 
@@ -265,6 +267,489 @@ TEST_F(StatementParametersTest, BindingNullStringValueForString) {
     ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
 }
 
+TEST_F(StatementParametersTest, InsertParameterArray) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TEMPORARY TABLE insert_parameter_array (n Int32, s String)");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    constexpr std::size_t param_set_count = 1000;
+
+    std::vector<SQLINTEGER> numbers(param_set_count);
+    std::vector<SQLCHAR> strings(param_set_count * 16);
+    std::vector<SQLLEN> string_inds(param_set_count);
+    std::vector<SQLUSMALLINT> statuses(param_set_count, SQL_PARAM_UNUSED);
+    SQLULEN processed = 0;
+
+    for (std::size_t i = 0; i < param_set_count; ++i) {
+        numbers[i] = static_cast<SQLINTEGER>(i);
+        const auto str = "it's " + std::to_string(i);
+        std::memcpy(&strings[i * 16], str.c_str(), str.size());
+        string_inds[i] = (i % 10 == 0 ? SQL_NULL_DATA : static_cast<SQLLEN>(str.size()));
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(param_set_count), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, statuses.data(), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, &processed, 0));
+
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, numbers.data(), 0, nullptr)
+    );
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, 16, 0, strings.data(), 16, string_inds.data())
+    );
+
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO insert_parameter_array (n, s) VALUES (?, ?)");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS));
+
+    ASSERT_EQ(processed, param_set_count);
+    for (std::size_t i = 0; i < param_set_count; ++i) {
+        ASSERT_EQ(statuses[i], SQL_PARAM_SUCCESS);
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(1), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAM_STATUS_PTR, nullptr, 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMS_PROCESSED_PTR, nullptr, 0));
+
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT count(), sum(n), countIf(s = ''), countIf(s = 'it''s 999') FROM insert_parameter_array");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    SQLBIGINT count = 0;
+    SQLBIGINT sum = 0;
+    SQLBIGINT empty_count = 0;
+    SQLBIGINT last_count = 0;
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &count, sizeof(count), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 2, SQL_C_SBIGINT, &sum, sizeof(sum), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 3, SQL_C_SBIGINT, &empty_count, sizeof(empty_count), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 4, SQL_C_SBIGINT, &last_count, sizeof(last_count), nullptr));
+
+    ASSERT_EQ(count, param_set_count);
+    ASSERT_EQ(sum, param_set_count * (param_set_count - 1) / 2);
+    ASSERT_EQ(empty_count, param_set_count / 10); // NULLs are inserted as default values of a non-nullable column.
+    ASSERT_EQ(last_count, 1);
+
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(StatementParametersTest, InsertParameterArrayQuotesValues) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TEMPORARY TABLE insert_parameter_array_quoting (n Int32)");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    constexpr std::size_t param_set_count = 2;
+
+    // The text of a value, that closes the tuple and opens another one, must not change the query.
+    std::vector<SQLCHAR> numbers(param_set_count * 16);
+    std::vector<SQLLEN> number_inds(param_set_count);
+
+    const std::string values[param_set_count] = { "1", "2), (3" };
+    for (std::size_t i = 0; i < param_set_count; ++i) {
+        std::memcpy(&numbers[i * 16], values[i].c_str(), values[i].size());
+        number_inds[i] = static_cast<SQLLEN>(values[i].size());
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(param_set_count), 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_INTEGER, 0, 0, numbers.data(), 16, number_inds.data())
+    );
+
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO insert_parameter_array_quoting (n) VALUES (?)");
+    ASSERT_EQ(SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS), SQL_ERROR);
+    EXPECT_NE(extract_diagnostics(hstmt, SQL_HANDLE_STMT).find("[22018]"), std::string::npos);
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    // An empty text is not a number.
+    number_inds[1] = 0;
+    ASSERT_EQ(SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS), SQL_ERROR);
+    EXPECT_NE(extract_diagnostics(hstmt, SQL_HANDLE_STMT).find("[22018]"), std::string::npos);
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    // Numbers are inlined as is.
+    number_inds[1] = 1;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLSetStmtAttr(hstmt, SQL_ATTR_PARAMSET_SIZE, reinterpret_cast<SQLPOINTER>(1), 0));
+
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT count(), sum(n) FROM insert_parameter_array_quoting");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    SQLBIGINT count = 0;
+    SQLBIGINT sum = 0;
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &count, sizeof(count), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 2, SQL_C_SBIGINT, &sum, sizeof(sum), nullptr));
+
+    ASSERT_EQ(count, 2);
+    ASSERT_EQ(sum, 3);
+
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(StatementParametersTest, DataAtExecutionParameters) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TEMPORARY TABLE data_at_execution_parameters (n Int32, s String)");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    constexpr std::size_t chunk_count = 1000;
+    const std::string chunk(1024, 'x');
+
+    SQLLEN number_ind = SQL_DATA_AT_EXEC;
+    SQLLEN string_ind = SQL_LEN_DATA_AT_EXEC(0);
+
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, reinterpret_cast<SQLPOINTER>(1), 0, &number_ind)
+    );
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_LONGVARCHAR, 0, 0, reinterpret_cast<SQLPOINTER>(2), 0, &string_ind)
+    );
+
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO data_at_execution_parameters (n, s) VALUES (?, ?)");
+    ASSERT_EQ(SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS), SQL_NEED_DATA);
+
+    // The parameter, that is streamed into the request body, is requested last.
+    SQLPOINTER token = nullptr;
+    ASSERT_EQ(SQLParamData(hstmt, &token), SQL_NEED_DATA);
+    ASSERT_EQ(token, reinterpret_cast<SQLPOINTER>(1));
+
+    SQLINTEGER number = 42;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLPutData(hstmt, &number, 0));
+
+    ASSERT_EQ(SQLParamData(hstmt, &token), SQL_NEED_DATA);
+    ASSERT_EQ(token, reinterpret_cast<SQLPOINTER>(2));
+
+    for (std::size_t i = 0; i < chunk_count; ++i) {
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLPutData(hstmt, const_cast<char *>(chunk.data()), chunk.size()));
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLParamData(hstmt, &token));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+    // Parameters of other queries are buffered and sent as usual.
+    number_ind = SQL_DATA_AT_EXEC;
+
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, reinterpret_cast<SQLPOINTER>(1), 0, &number_ind)
+    );
+
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT length(s) FROM data_at_execution_parameters WHERE n = ?");
+    ASSERT_EQ(SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS), SQL_NEED_DATA);
+    ASSERT_EQ(SQLParamData(hstmt, &token), SQL_NEED_DATA);
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLPutData(hstmt, &number, 0));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLParamData(hstmt, &token));
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    SQLBIGINT length = 0;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &length, sizeof(length), nullptr));
+    ASSERT_EQ(length, chunk_count * chunk.size());
+
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(StatementParametersTest, DataAtExecutionWideCharactersSplitAcrossPieces) {
+    const auto create_query = fromUTF8<SQLTCHAR>("CREATE TEMPORARY TABLE data_at_execution_wide_characters (n Int32, s String)");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(create_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    const std::string expected = "a\xF0\x9F\x98\x80" "b";
+    const auto value = fromUTF8<SQLWCHAR>(expected);
+    const auto * bytes = reinterpret_cast<const char *>(value.data());
+    const auto size = value.size() * sizeof(SQLWCHAR);
+
+    SQLINTEGER number = 1;
+    SQLLEN string_ind = SQL_LEN_DATA_AT_EXEC(0);
+
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &number, 0, nullptr)
+    );
+    ODBC_CALL_ON_STMT_THROW(hstmt,
+        SQLBindParameter(hstmt, 2, SQL_PARAM_INPUT, SQL_C_WCHAR, SQL_WLONGVARCHAR, 0, 0, reinterpret_cast<SQLPOINTER>(2), 0, &string_ind)
+    );
+
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO data_at_execution_wide_characters (n, s) VALUES (?, ?)");
+    ASSERT_EQ(SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS), SQL_NEED_DATA);
+
+    SQLPOINTER token = nullptr;
+    ASSERT_EQ(SQLParamData(hstmt, &token), SQL_NEED_DATA);
+    ASSERT_EQ(token, reinterpret_cast<SQLPOINTER>(2));
+
+    // The first piece ends with the high surrogate of the emoji, when SQLWCHAR is UTF-16, and the second one is a single byte,
+    // so that the rest of the characters is split across the pieces.
+    const std::size_t split_points[] = { 0, 2 * sizeof(SQLWCHAR), 2 * sizeof(SQLWCHAR) + 1, size };
+    for (std::size_t i = 1; i < sizeof(split_points) / sizeof(split_points[0]); ++i) {
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLPutData(hstmt, const_cast<char *>(bytes + split_points[i - 1]), split_points[i] - split_points[i - 1]));
+    }
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLParamData(hstmt, &token));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+    const auto select_query = fromUTF8<SQLTCHAR>("SELECT hex(s) FROM data_at_execution_wide_characters WHERE n = 1");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(select_query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    char hex[64] = {};
+    SQLLEN hex_ind = 0;
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_CHAR, hex, sizeof(hex), &hex_ind));
+    ASSERT_EQ(std::string(hex, hex_ind), "61F09F988062");
+
+    ASSERT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+}
+
+TEST_F(StatementParametersTest, InListAsExternalTable) {
+    constexpr std::size_t in_list_size = 100;
+
+    std::string query = "SELECT count(), sum(number) FROM numbers(1000) WHERE number >= ? AND number IN (";
+    for (std::size_t i = 0; i < in_list_size; ++i) {
+        query += (i == 0 ? "?" : ", ?");
+    }
+    query += ")";
+
+    SQLBIGINT min_number = 10;
+    std::vector<SQLBIGINT> numbers(in_list_size);
+
+    for (std::size_t i = 0; i < in_list_size; ++i) {
+        numbers[i] = static_cast<SQLBIGINT>(i * 3);
+    }
+
+    auto execute = [&] (SQLHSTMT stmt) {
+        ODBC_CALL_ON_STMT_THROW(stmt,
+            SQLBindParameter(stmt, 1, SQL_PARAM_INPUT, SQL_C_SBIGINT, SQL_BIGINT, 0, 0, &min_number, 0, nullptr)
+        );
+
+        for (std::size_t i = 0; i < in_list_size; ++i) {
+            ODBC_CALL_ON_STMT_THROW(stmt,
+                SQLBindParameter(stmt, i + 2, SQL_PARAM_INPUT, SQL_C_SBIGINT, SQL_BIGINT, 0, 0, &numbers[i], 0, nullptr)
+            );
+        }
+
+        const auto query_str = fromUTF8<SQLTCHAR>(query);
+        ODBC_CALL_ON_STMT_THROW(stmt, SQLExecDirect(stmt, const_cast<SQLTCHAR *>(query_str.c_str()), SQL_NTS));
+        ODBC_CALL_ON_STMT_THROW(stmt, SQLFetch(stmt));
+
+        SQLBIGINT count = 0;
+        SQLBIGINT sum = 0;
+
+        ODBC_CALL_ON_STMT_THROW(stmt, SQLGetData(stmt, 1, SQL_C_SBIGINT, &count, sizeof(count), nullptr));
+        ODBC_CALL_ON_STMT_THROW(stmt, SQLGetData(stmt, 2, SQL_C_SBIGINT, &sum, sizeof(sum), nullptr));
+
+        EXPECT_EQ(SQLFetch(stmt), SQL_NO_DATA);
+        ODBC_CALL_ON_STMT_THROW(stmt, SQLFreeStmt(stmt, SQL_CLOSE));
+
+        return std::make_pair(count, sum);
+    };
+
+    // The same query over a connection, that sends long IN lists as external tables.
+    SQLHDBC rewriting_hdbc = nullptr;
+    SQLHSTMT rewriting_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &rewriting_hdbc));
+
+    const auto connection_string = fromUTF8<SQLTCHAR>("DSN={" + TestEnvironment::getInstance().getDSN() + "};InListThreshold=10");
+    ODBC_CALL_ON_DBC_THROW(rewriting_hdbc,
+        SQLDriverConnect(rewriting_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(rewriting_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, rewriting_hdbc, &rewriting_hstmt));
+
+    const auto expected = execute(hstmt);
+    const auto actual = execute(rewriting_hstmt);
+
+    ODBC_CALL_ON_STMT_THROW(rewriting_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, rewriting_hstmt));
+    ODBC_CALL_ON_DBC_LOG(rewriting_hdbc, SQLDisconnect(rewriting_hdbc));
+    ODBC_CALL_ON_DBC_THROW(rewriting_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, rewriting_hdbc));
+
+    ASSERT_EQ(expected.first, 96);
+    ASSERT_EQ(actual, expected);
+}
+
+TEST_F(StatementParametersTest, InsertBatching) {
+    auto execute_on_hstmt = [&] (const std::string & query) {
+        const auto query_str = fromUTF8<SQLTCHAR>(query);
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(query_str.c_str()), SQL_NTS));
+    };
+
+    auto count_rows = [&] () {
+        execute_on_hstmt("SELECT count() FROM insert_batching");
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+        SQLBIGINT count = 0;
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &count, sizeof(count), nullptr));
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+        return count;
+    };
+
+    // The rows are sent from a separate session, so a temporary table can't be used here.
+    execute_on_hstmt("DROP TABLE IF EXISTS insert_batching");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+    execute_on_hstmt("CREATE TABLE insert_batching (n Int32, s String) ENGINE = Memory");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    // A connection, that buffers the rows of single-row INSERTs and sends them in batches of 100 rows.
+    SQLHDBC batching_hdbc = nullptr;
+    SQLHSTMT batching_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &batching_hdbc));
+
+    const auto connection_string = fromUTF8<SQLTCHAR>("DSN={" + TestEnvironment::getInstance().getDSN() + "};InsertBatchRows=100;InsertBatchTimeout=3600");
+    ODBC_CALL_ON_DBC_THROW(batching_hdbc,
+        SQLDriverConnect(batching_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(batching_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, batching_hdbc, &batching_hstmt));
+
+    constexpr std::size_t row_count = 250;
+
+    SQLINTEGER number = 0;
+    SQLCHAR string[16] = {};
+    SQLLEN string_ind = 0;
+
+    ODBC_CALL_ON_STMT_THROW(batching_hstmt,
+        SQLBindParameter(batching_hstmt, 1, SQL_PARAM_INPUT, SQL_C_SLONG, SQL_INTEGER, 0, 0, &number, 0, nullptr)
+    );
+    ODBC_CALL_ON_STMT_THROW(batching_hstmt,
+        SQLBindParameter(batching_hstmt, 2, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, lengthof(string), 0, string, lengthof(string), &string_ind)
+    );
+
+    const auto insert_query = fromUTF8<SQLTCHAR>("INSERT INTO insert_batching (n, s) VALUES (?, ?)");
+    ODBC_CALL_ON_STMT_THROW(batching_hstmt, SQLPrepare(batching_hstmt, const_cast<SQLTCHAR *>(insert_query.c_str()), SQL_NTS));
+
+    for (std::size_t i = 0; i < row_count; ++i) {
+        number = static_cast<SQLINTEGER>(i);
+        const auto str = "it's " + std::to_string(i);
+        std::memcpy(string, str.c_str(), str.size());
+        string_ind = (i % 10 == 0 ? SQL_NULL_DATA : static_cast<SQLLEN>(str.size()));
+
+        ODBC_CALL_ON_STMT_THROW(batching_hstmt, SQLExecute(batching_hstmt));
+
+        SQLLEN affected_rows = 0;
+        ODBC_CALL_ON_STMT_THROW(batching_hstmt, SQLRowCount(batching_hstmt, &affected_rows));
+        ASSERT_EQ(affected_rows, 1);
+    }
+
+    // Only the full batches are sent so far.
+    ASSERT_EQ(count_rows(), 200);
+
+    ODBC_CALL_ON_STMT_THROW(batching_hstmt, SQLFreeStmt(batching_hstmt, SQL_CLOSE));
+    ASSERT_EQ(count_rows(), row_count);
+
+    ODBC_CALL_ON_STMT_THROW(batching_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, batching_hstmt));
+    ODBC_CALL_ON_DBC_LOG(batching_hdbc, SQLDisconnect(batching_hdbc));
+    ODBC_CALL_ON_DBC_THROW(batching_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, batching_hdbc));
+
+    execute_on_hstmt("SELECT sum(n), countIf(s = '') FROM insert_batching");
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+    SQLBIGINT sum = 0;
+    SQLBIGINT empty_count = 0;
+
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_SBIGINT, &sum, sizeof(sum), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 2, SQL_C_SBIGINT, &empty_count, sizeof(empty_count), nullptr));
+    ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+
+    ASSERT_EQ(sum, row_count * (row_count - 1) / 2);
+    ASSERT_EQ(empty_count, row_count / 10); // NULLs are inserted as default values of a non-nullable column.
+
+    execute_on_hstmt("DROP TABLE insert_batching");
+}
+
+TEST_F(StatementParametersTest, CompressedRequestBody) {
+    // A connection, that compresses all request bodies.
+    SQLHDBC compressing_hdbc = nullptr;
+    SQLHSTMT compressing_hstmt = nullptr;
+
+    ODBC_CALL_ON_ENV_THROW(henv, SQLAllocHandle(SQL_HANDLE_DBC, henv, &compressing_hdbc));
+
+    const auto connection_string = fromUTF8<SQLTCHAR>("DSN={" + TestEnvironment::getInstance().getDSN() + "};RequestCompression=gzip;CompressMinSize=1");
+    ODBC_CALL_ON_DBC_THROW(compressing_hdbc,
+        SQLDriverConnect(compressing_hdbc, NULL, const_cast<SQLTCHAR *>(connection_string.c_str()), SQL_NTS, NULL, 0, NULL, SQL_DRIVER_NOPROMPT)
+    );
+    ODBC_CALL_ON_DBC_THROW(compressing_hdbc, SQLAllocHandle(SQL_HANDLE_STMT, compressing_hdbc, &compressing_hstmt));
+
+    // A parameter value, that is large enough to be sent in the request body.
+    const std::string value(100000, 'x');
+    SQLLEN value_ind = value.size();
+
+    ODBC_CALL_ON_STMT_THROW(compressing_hstmt,
+        SQLBindParameter(compressing_hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, value.size(), 0, const_cast<char *>(value.c_str()), value.size(), &value_ind)
+    );
+
+    const auto query = fromUTF8<SQLTCHAR>("SELECT length(?)");
+    ODBC_CALL_ON_STMT_THROW(compressing_hstmt, SQLExecDirect(compressing_hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+    ODBC_CALL_ON_STMT_THROW(compressing_hstmt, SQLFetch(compressing_hstmt));
+
+    SQLBIGINT length = 0;
+    ODBC_CALL_ON_STMT_THROW(compressing_hstmt, SQLGetData(compressing_hstmt, 1, SQL_C_SBIGINT, &length, sizeof(length), nullptr));
+
+    EXPECT_EQ(SQLFetch(compressing_hstmt), SQL_NO_DATA);
+
+    ODBC_CALL_ON_STMT_THROW(compressing_hstmt, SQLFreeHandle(SQL_HANDLE_STMT, compressing_hstmt));
+    ODBC_CALL_ON_DBC_LOG(compressing_hdbc, SQLDisconnect(compressing_hdbc));
+    ODBC_CALL_ON_DBC_THROW(compressing_hdbc, SQLFreeHandle(SQL_HANDLE_DBC, compressing_hdbc));
+
+    ASSERT_EQ(length, value.size());
+}
+
+TEST_F(StatementParametersTest, ParametersInMultipartBody) {
+    // A value, that contains what looks like a part boundary, line breaks of the multipart format, and a zero byte.
+    const std::string special("a--b\r\n--c\r\n\r\nd\0e--", 18);
+
+    const auto query = fromUTF8<SQLTCHAR>("SELECT hex(?)");
+
+    const auto select_hex = [&] (const std::string & value) {
+        SQLLEN value_ind = value.size();
+
+        ODBC_CALL_ON_STMT_THROW(hstmt,
+            SQLBindParameter(hstmt, 1, SQL_PARAM_INPUT, SQL_C_CHAR, SQL_VARCHAR, value.size(), 0, const_cast<char *>(value.data()), value.size(), &value_ind)
+        );
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLExecDirect(hstmt, const_cast<SQLTCHAR *>(query.c_str()), SQL_NTS));
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFetch(hstmt));
+
+        std::string hex(value.size() * 2 + 1, '\0');
+        SQLLEN hex_ind = 0;
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLGetData(hstmt, 1, SQL_C_CHAR, hex.data(), hex.size(), &hex_ind));
+        hex.resize(hex_ind);
+
+        EXPECT_EQ(SQLFetch(hstmt), SQL_NO_DATA);
+
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_CLOSE));
+        ODBC_CALL_ON_STMT_THROW(hstmt, SQLFreeStmt(hstmt, SQL_RESET_PARAMS));
+
+        return hex;
+    };
+
+    const auto to_hex = [] (const std::string & value) {
+        static const char digits[] = "0123456789ABCDEF";
+
+        std::string hex;
+        for (const auto ch : value) {
+            hex += digits[static_cast<unsigned char>(ch) >> 4];
+            hex += digits[static_cast<unsigned char>(ch) & 0xF];
+        }
+
+        return hex;
+    };
+
+    // The short value is sent in the URL, the long one, that is above the size threshold, in the request body.
+    const auto short_value = special;
+    const auto long_value = special + std::string(20000, 'x') + special;
+
+    const auto short_hex = select_hex(short_value);
+    const auto long_hex = select_hex(long_value);
+
+    ASSERT_EQ(short_hex, to_hex(short_value));
+    ASSERT_EQ(long_hex, to_hex(long_value));
+
+    // The server sees the special value in the request body exactly as it sees it in the URL.
+    ASSERT_EQ(long_hex.substr(0, short_hex.size()), short_hex);
+    ASSERT_EQ(long_hex.substr(long_hex.size() - short_hex.size()), short_hex);
+}
+
 class ParameterColumnRoundTrip
     : public StatementParametersTest
 {
@@ -0,0 +1,190 @@
+#include "driver/result_set.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // Gives the data out in pieces of at most the specified size, so that the reader has to refill its buffer at every piece boundary.
+    class PieceWiseStreamBuf
+        : public std::streambuf
+    {
+    public:
+        explicit PieceWiseStreamBuf(const std::string & data, std::size_t piece_size)
+            : data_(data)
+            , piece_size_(piece_size)
+        {
+        }
+
+    protected:
+        virtual int_type underflow() override {
+            if (pos_ >= data_.size())
+                return traits_type::eof();
+
+            auto * begin = data_.data() + pos_;
+            const auto size = std::min(piece_size_, data_.size() - pos_);
+
+            setg(begin, begin, begin + size);
+            pos_ += size;
+
+            return traits_type::to_int_type(*begin);
+        }
+
+    private:
+        std::string data_;
+        const std::size_t piece_size_;
+        std::size_t pos_ = 0;
+    };
+
+    // Read all values of the result set as text, with NULLs as "NULL", row by row.
+    std::vector<std::vector<std::string>> readAll(std::istream & stream) {
+        auto reader = make_result_reader("TabSeparatedWithNamesAndTypes", stream, std::unique_ptr<ResultMutator>{});
+        auto & result_set = reader->getResultSet();
+
+        std::vector<std::vector<std::string>> rows;
+
+        while (true) {
+            const auto row_count = result_set.fetchRowSet(SQL_FETCH_NEXT, 0, 10);
+            if (row_count == 0)
+                break;
+
+            for (std::size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+                auto & row = rows.emplace_back();
+
+                for (std::size_t column_idx = 0; column_idx < result_set.getColumnCount(); ++column_idx) {
+                    char buffer[256] = {};
+                    SQLLEN ind = 0;
+
+                    BindingInfo binding_info;
+                    binding_info.c_type = SQL_C_CHAR;
+                    binding_info.value = buffer;
+                    binding_info.value_max_size = sizeof(buffer);
+                    binding_info.value_size = binding_info.indicator = &ind;
+
+                    EXPECT_EQ(result_set.extractField(row_idx, column_idx, binding_info), SQL_SUCCESS);
+                    row.emplace_back(ind == SQL_NULL_DATA ? "NULL" : std::string(buffer, ind));
+                }
+            }
+        }
+
+        return rows;
+    }
+
+    std::vector<std::vector<std::string>> readAll(const std::string & data) {
+        std::istringstream stream(data);
+        return readAll(stream);
+    }
+
+    std::vector<std::vector<std::string>> readAllInPieces(const std::string & data, std::size_t piece_size) {
+        PieceWiseStreamBuf buffer(data, piece_size);
+        std::istream stream(&buffer);
+        return readAll(stream);
+    }
+
+} // namespace
+
+TEST(TabSeparatedReader, EscapedCharacters) {
+    const std::string data =
+        "s\tn\n"
+        "String\tInt32\n"
+        "a\\tb\t1\n"
+        "a\\nb\t2\n"
+        "a\\\\b\t3\n"
+        "\\\\\\t\\n\\\\\t4\n"
+        "a\\\\N\t5\n";
+
+    const std::vector<std::vector<std::string>> expected = {
+        { "a\tb", "1" },
+        { "a\nb", "2" },
+        { "a\\b", "3" },
+        { "\\\t\n\\", "4" },
+        { "a\\N", "5" }
+    };
+
+    ASSERT_EQ(readAll(data), expected);
+}
+
+TEST(TabSeparatedReader, Nulls) {
+    const std::string data =
+        "s\tn\n"
+        "Nullable(String)\tNullable(Int32)\n"
+        "\\N\t\\N\n"
+        "x\t-7\n"
+        "\\\\N\t\\N\n";
+
+    const std::vector<std::vector<std::string>> expected = {
+        { "NULL", "NULL" },
+        { "x", "-7" },
+        { "\\N", "NULL" }
+    };
+
+    ASSERT_EQ(readAll(data), expected);
+}
+
+TEST(TabSeparatedReader, EmptyStrings) {
+    const std::string data =
+        "a\tb\tc\n"
+        "String\tNullable(String)\tString\n"
+        "\t\t\n"
+        "x\t\t\n"
+        "\t\ty\n";
+
+    const std::vector<std::vector<std::string>> expected = {
+        { "", "", "" },
+        { "x", "", "" },
+        { "", "", "y" }
+    };
+
+    ASSERT_EQ(readAll(data), expected);
+}
+
+TEST(TabSeparatedReader, RowSplitAcrossBufferRefills) {
+    std::string data =
+        "s\tn\tns\n"
+        "String\tInt64\tNullable(String)\n";
+
+    for (int i = 0; i < 100; ++i) {
+        data += "value\\t" + std::to_string(i) + "\\\\\\n" + "\t" + std::to_string(i * 1000003 - 50000) + "\t" + (i % 3 == 0 ? "\\N" : "") + "\n";
+    }
+
+    const auto expected = readAll(data);
+    ASSERT_EQ(expected.size(), 100);
+    ASSERT_EQ(expected[1], (std::vector<std::string>{ "value\t1\\\n", "950003", "" }));
+    ASSERT_EQ(expected[3], (std::vector<std::string>{ "value\t3\\\n", "2950009", "NULL" }));
+
+    // Every position in a row, including the middle of escape sequences and of integers, ends up at a piece boundary.
+    for (const std::size_t piece_size : { 1, 2, 3, 5, 7, 16, 17 }) {
+        EXPECT_EQ(readAllInPieces(data, piece_size), expected) << "piece size: " << piece_size;
+    }
+}
+
+TEST(TabSeparatedReader, DelimiterAtSIMDBlockBoundary) {
+    std::string data =
+        "s\n"
+        "String\n";
+
+    std::vector<std::vector<std::string>> expected;
+
+    // Each field starts at the beginning of the data the reader looks at, so the delimiters, and the escape sequences,
+    // end up at the last position of a block, at the first position of the next one, and around those.
+    for (const std::size_t length : { 14, 15, 16, 17, 18, 30, 31, 32, 33, 34, 63, 64, 65 }) {
+        const std::string value(length, 'a' + length % 26);
+
+        data += value + "\n";
+        expected.push_back({ value });
+
+        data += value + "\\t" + value + "\n";
+        expected.push_back({ value + "\t" + value });
+    }
+
+    ASSERT_EQ(readAll(data), expected);
+
+    for (const std::size_t piece_size : { 15, 16, 17 }) {
+        EXPECT_EQ(readAllInPieces(data, piece_size), expected) << "piece size: " << piece_size;
+    }
+}
@@ -0,0 +1,128 @@
+#include "driver/utils/thread_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+    // Waits for the condition to become true, for up to 10 seconds.
+    template <typename Condition>
+    bool waitFor(Condition && condition) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // Blocks the tasks, until it is opened.
+    class Gate {
+    public:
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [&] () { return open_; });
+        }
+
+        void open() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_ = true;
+            cv_.notify_all();
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        bool open_ = false;
+    };
+
+} // namespace
+
+TEST(ThreadPool, RunsTasks) {
+    ThreadPool pool(4, std::chrono::seconds(60));
+    std::atomic<std::size_t> done{0};
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        pool.schedule([&] () { ++done; });
+    }
+
+    ASSERT_TRUE(waitFor([&] () { return done == 100; }));
+    EXPECT_LE(pool.getThreadCount(), 4);
+}
+
+TEST(ThreadPool, ExceptionsAreIgnored) {
+    ThreadPool pool(1, std::chrono::seconds(60));
+    std::atomic<bool> done{false};
+
+    pool.schedule([] () { throw std::runtime_error("Task failure"); });
+    pool.schedule([&] () { done = true; });
+
+    ASSERT_TRUE(waitFor([&] () { return done.load(); }));
+}
+
+TEST(ThreadPool, GrowsOnDemand) {
+    ThreadPool pool(3, std::chrono::seconds(60));
+    Gate gate;
+    std::atomic<std::size_t> started{0};
+
+    for (std::size_t i = 0; i < 5; ++i) {
+        pool.schedule([&] () {
+            ++started;
+            gate.wait();
+        });
+    }
+
+    // Each blocked task occupies its thread, the rest wait for one to become free.
+    ASSERT_TRUE(waitFor([&] () { return started == 3; }));
+    EXPECT_EQ(pool.getThreadCount(), 3);
+
+    gate.open();
+    ASSERT_TRUE(waitFor([&] () { return started == 5; }));
+}
+
+TEST(ThreadPool, IdleThreadsStop) {
+    ThreadPool pool(2, std::chrono::milliseconds(10));
+    std::atomic<std::size_t> done{0};
+
+    pool.schedule([&] () { ++done; });
+    pool.schedule([&] () { ++done; });
+
+    ASSERT_TRUE(waitFor([&] () { return done == 2; }));
+    ASSERT_TRUE(waitFor([&] () { return pool.getThreadCount() == 0; }));
+
+    // The threads are started again, when needed.
+    pool.schedule([&] () { ++done; });
+    ASSERT_TRUE(waitFor([&] () { return done == 3; }));
+}
+
+TEST(ThreadPool, DestructorWaitsForRunningTasks) {
+    Gate gate;
+    std::atomic<bool> started{false};
+    std::atomic<bool> finished{false};
+
+    auto pool = std::make_unique<ThreadPool>(1, std::chrono::seconds(60));
+
+    pool->schedule([&] () {
+        started = true;
+        gate.wait();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished = true;
+    });
+
+    ASSERT_TRUE(waitFor([&] () { return started.load(); }));
+
+    // The queued task is dropped, since the only thread is busy.
+    pool->schedule([] () { FAIL() << "Dropped task is run"; });
+
+    gate.open();
+    pool.reset();
+    EXPECT_TRUE(finished);
+}
@@ -45,10 +45,12 @@ protected:
 };
 
 using StringPongGUIDSymmetric     = StringPongSymmetric<SQLGUID>;
+using StringPongGUIDAsymmetric    = StringPongAsymmetric<SQLGUID>;
 using StringPongNumericSymmetric  = StringPongSymmetric<SQL_NUMERIC_STRUCT>;
 using StringPongNumericAsymmetric = StringPongAsymmetric<SQL_NUMERIC_STRUCT>;
 
 TEST_P(StringPongGUIDSymmetric,     Compare) { compare<DataType>(GetParam(), GetParam(), false/* case_sensitive */); }
+TEST_P(StringPongGUIDAsymmetric,    Compare) { compare<DataType>(std::get<0>(GetParam()), std::get<1>(GetParam())); }
 TEST_P(StringPongNumericSymmetric,  Compare) { compare<DataType>(GetParam(), GetParam()); }
 TEST_P(StringPongNumericAsymmetric, Compare) { compare<DataType>(std::get<0>(GetParam()), std::get<1>(GetParam())); }
 
@@ -61,6 +63,48 @@ INSTANTIATE_TEST_SUITE_P(TypeConversion, StringPongGUIDSymmetric,
     )
 );
 
+INSTANTIATE_TEST_SUITE_P(TypeConversion, StringPongGUIDAsymmetric,
+    ::testing::ValuesIn(std::initializer_list<std::tuple<std::string, std::string>>{
+        { "01020304-0506-0708-090A-0B0C0D0E0F00", "01020304-0506-0708-090a-0b0c0d0e0f00" },
+        { "aBcDeF01-AbCd-eFaB-cDeF-0123456789aB", "abcdef01-abcd-efab-cdef-0123456789ab" },
+        { "FFFFFFFF-ffff-FFFF-ffff-FFFFFFFFFFFF", "ffffffff-ffff-ffff-ffff-ffffffffffff" }
+    })
+);
+
+class StringToGUIDMalformed
+    : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(StringToGUIDMalformed, Throw) {
+    SQLGUID obj;
+    value_manip::to_null(obj);
+    EXPECT_THROW(value_manip::from_value<std::string>::template to_value<SQLGUID>::convert(GetParam(), obj), std::runtime_error);
+}
+
+INSTANTIATE_TEST_SUITE_P(TypeConversion, StringToGUIDMalformed,
+    ::testing::Values(
+        "",
+        "0",
+        "01020304-0506-0708-090A-0B0C0D0E0F0",
+        "01020304-0506-0708-090A-0B0C0D0E0F000",
+        "01020304-0506-0708-090A-0B0C0D0E0F00 ",
+        " 01020304-0506-0708-090A-0B0C0D0E0F00",
+        "{01020304-0506-0708-090A-0B0C0D0E0F00}",
+        "0102030405060708090A0B0C0D0E0F00",
+        "01020304_0506_0708_090A_0B0C0D0E0F00",
+        "0102030-40506-0708-090A-0B0C0D0E0F00",
+        "01020304-0506-0708-090G-0B0C0D0E0F00",
+        "01020304-0506-0708-090g-0B0C0D0E0F00",
+        "01020304-0506-0708-090A-0B0C0D0E0F0:",
+        "01020304-0506-0708-090A-0B0C0D0E0F0@",
+        "01020304-0506-0708-090A-0B0C0D0E0F0`",
+        "01020304-0506-0708-090A-0B0C0D0E0F0/",
+        "01020304-0506-0708-090A-0B0C0D0E0F0\xC1",
+        std::string("01020304-0506-0708-090A-0B0C0D0E0F0\0", 36)
+    )
+);
+
 INSTANTIATE_TEST_SUITE_P(TypeConversion, StringPongNumericSymmetric,
     ::testing::Values(
         "0",
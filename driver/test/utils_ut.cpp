@@ -1,7 +1,10 @@
 #include "driver/utils/utils.h"
+#include "driver/utils/query_template.h"
 
 #include <gtest/gtest.h>
 
+#include <sstream>
+
 using values_t = std::set<std::string>;
 
 class ParseToSet
@@ -73,3 +76,93 @@ TEST(CatalogFnPattern, IsMatchAnything) {
         EXPECT_EQ(isMatchAnythingCatalogFnPatternArg(pair.first), pair.second);
     }
 }
+
+TEST(SIMD, UUIDHexRoundTrip) {
+    std::uint8_t bytes[16];
+    for (std::size_t i = 0; i < lengthof(bytes); ++i) {
+        bytes[i] = static_cast<std::uint8_t>(i * 17 + 3);
+    }
+
+    char text[simd::uuid_text_length];
+    simd::encodeUUID(bytes, text);
+    EXPECT_EQ(std::string(text, lengthof(text)), "03142536-4758-697a-8b9c-adbecfe0f102");
+
+    std::uint8_t decoded[16] = { 0 };
+    ASSERT_TRUE(simd::decodeUUID(text, lengthof(text), decoded));
+    EXPECT_EQ(std::memcmp(bytes, decoded, lengthof(bytes)), 0);
+}
+
+TEST(QueryTemplate, ExtractParameters) {
+    std::string query = "SELECT ?, '?', \"@x\", @name_1 FROM t WHERE a IN (?,?) AND b = 'it''s ?'";
+    const auto parameters = extractQueryParameters(query);
+
+    EXPECT_EQ(query, "SELECT , '?', \"@x\",  FROM t WHERE a IN (,) AND b = 'it''s ?'");
+    ASSERT_EQ(parameters.size(), 4);
+
+    EXPECT_EQ(parameters[0].name, "");
+    EXPECT_EQ(parameters[0].position, 7);
+    EXPECT_EQ(parameters[1].name, "@name_1");
+    EXPECT_EQ(parameters[1].position, 20);
+    EXPECT_EQ(parameters[2].position, 40);
+    EXPECT_EQ(parameters[3].position, 41);
+
+    std::string no_params = "SELECT 1";
+    EXPECT_TRUE(extractQueryParameters(no_params).empty());
+    EXPECT_EQ(no_params, "SELECT 1");
+
+    std::string unnamed = "SELECT @";
+    EXPECT_THROW(extractQueryParameters(unnamed), SqlException);
+}
+
+TEST(QueryTemplate, RenderQuery) {
+    std::string query = "SELECT ?, @p FROM t WHERE a IN (?, ?, ?) AND b = ?";
+    const auto parameters = extractQueryParameters(query);
+    ASSERT_EQ(parameters.size(), 6);
+
+    std::string rendered;
+    renderQuery(rendered, query, parameters, [] (std::size_t param_idx, std::string & dest) -> std::size_t {
+        if (param_idx == 2) {
+            dest += "SELECT x FROM list";
+            return 3;
+        }
+
+        dest += "{p" + std::to_string(param_idx) + "}";
+        return 1;
+    });
+
+    EXPECT_EQ(rendered, "SELECT {p0}, {p1} FROM t WHERE a IN (SELECT x FROM list) AND b = {p5}");
+
+    // The query is the same, when it is written to a stream.
+    std::ostringstream stream;
+    renderQuery(stream, query, parameters, [] (std::size_t param_idx, std::ostream & dest) -> std::size_t {
+        if (param_idx == 2) {
+            dest << "SELECT x FROM list";
+            return 3;
+        }
+
+        dest << "{p" << param_idx << "}";
+        return 1;
+    });
+
+    EXPECT_EQ(stream.str(), rendered);
+}
+
+TEST(QueryTemplate, ClassifyQuery) {
+    EXPECT_EQ(classifyQuery("SELECT 1"), QueryKind::Read);
+    EXPECT_EQ(classifyQuery("  select * from t"), QueryKind::Read);
+    EXPECT_EQ(classifyQuery("((SELECT 1) UNION ALL (SELECT 2))"), QueryKind::Read);
+    EXPECT_EQ(classifyQuery("WITH 1 AS x SELECT x"), QueryKind::Read);
+    EXPECT_EQ(classifyQuery("-- comment\n/* another one */ SHOW TABLES"), QueryKind::Read);
+    EXPECT_EQ(classifyQuery("DESC t"), QueryKind::Read);
+
+    EXPECT_EQ(classifyQuery("INSERT INTO t VALUES (1)"), QueryKind::Write);
+    EXPECT_EQ(classifyQuery("insert into t select * from s"), QueryKind::Write);
+    EXPECT_EQ(classifyQuery("CREATE TABLE t (x Int32) ENGINE = Memory"), QueryKind::Write);
+    EXPECT_EQ(classifyQuery("ALTER TABLE t DELETE WHERE 1"), QueryKind::Write);
+
+    EXPECT_EQ(classifyQuery(""), QueryKind::Other);
+    EXPECT_EQ(classifyQuery("/* unterminated"), QueryKind::Other);
+    EXPECT_EQ(classifyQuery("SET max_threads = 1"), QueryKind::Other);
+    EXPECT_EQ(classifyQuery("SELECTED"), QueryKind::Other);
+    EXPECT_EQ(classifyQuery("KILL QUERY WHERE query_id = 'x'"), QueryKind::Other);
+}
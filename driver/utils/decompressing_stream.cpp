@@ -0,0 +1,162 @@
+#include "driver/utils/decompressing_stream.h"
+
+#include <Poco/InflatingStream.h>
+#include <Poco/UTF8String.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <streambuf>
+#include <thread>
+
+namespace {
+
+    // A stream buffer, that reads the source stream on a helper thread, keeping a few pieces of its data ready to be consumed.
+    class ReadAheadStreamBuf
+        : public std::streambuf
+    {
+    public:
+        explicit ReadAheadStreamBuf(std::istream & source)
+            : source_(source)
+        {
+            // Errors of reading the source must be reported to the consumer instead of looking like the end of the data.
+            source_.exceptions(std::ios::badbit);
+            worker_ = std::thread([this] () { run(); });
+        }
+
+        virtual ~ReadAheadStreamBuf() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+
+            cv_.notify_all();
+
+            // The worker may still be blocked in reading the source, in which case this waits until that read is over.
+            worker_.join();
+        }
+
+    protected:
+        virtual int_type underflow() override {
+            if (gptr() < egptr())
+                return traits_type::to_int_type(*gptr());
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] () { return (!ready_.empty() || finished_); });
+
+            if (ready_.empty()) {
+                if (error_)
+                    std::rethrow_exception(error_);
+
+                return traits_type::eof();
+            }
+
+            current_ = std::move(ready_.front());
+            ready_.pop_front();
+
+            lock.unlock();
+            cv_.notify_all();
+
+            setg(&current_[0], &current_[0], &current_[0] + current_.size());
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+        void run() {
+            static constexpr std::size_t piece_size = 1 << 20; // 1 MB
+            static constexpr std::size_t max_ready_pieces = 4;
+
+            try {
+                while (true) {
+                    std::string piece;
+                    piece.resize(piece_size);
+
+                    source_.read(&piece[0], piece.size());
+                    piece.resize(source_.gcount());
+
+                    const bool last = (piece.size() < piece_size);
+
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    cv_.wait(lock, [this] () { return (ready_.size() < max_ready_pieces || stopping_); });
+
+                    if (stopping_)
+                        return;
+
+                    if (!piece.empty())
+                        ready_.emplace_back(std::move(piece));
+
+                    finished_ = last;
+
+                    lock.unlock();
+                    cv_.notify_all();
+
+                    if (last)
+                        return;
+                }
+            }
+            catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    error_ = std::current_exception();
+                    finished_ = true;
+                }
+
+                cv_.notify_all();
+            }
+        }
+
+    private:
+        std::istream & source_;
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::string> ready_;
+        std::string current_;
+        bool finished_ = false;
+        bool stopping_ = false;
+        std::exception_ptr error_;
+        std::thread worker_;
+    };
+
+    // Decompresses the data on a helper thread.
+    class ThreadedInflatingInputStream
+        : public std::istream
+    {
+    public:
+        explicit ThreadedInflatingInputStream(std::istream & source, Poco::InflatingStreamBuf::StreamType type)
+            : std::istream(nullptr)
+            , inflating_(source, type)
+            , read_ahead_(inflating_)
+        {
+            rdbuf(&read_ahead_);
+            exceptions(std::ios::badbit);
+        }
+
+    private:
+        Poco::InflatingInputStream inflating_;
+        ReadAheadStreamBuf read_ahead_;
+    };
+
+} // namespace
+
+std::unique_ptr<std::istream> makeDecompressingStream(std::istream & source, const std::string & content_encoding, bool use_thread) {
+    Poco::InflatingStreamBuf::StreamType type = Poco::InflatingStreamBuf::STREAM_GZIP;
+
+    if (content_encoding.empty() || Poco::UTF8::icompare(content_encoding, "identity") == 0)
+        return {};
+    else if (Poco::UTF8::icompare(content_encoding, "gzip") == 0 || Poco::UTF8::icompare(content_encoding, "x-gzip") == 0)
+        type = Poco::InflatingStreamBuf::STREAM_GZIP;
+    else if (Poco::UTF8::icompare(content_encoding, "deflate") == 0)
+        type = Poco::InflatingStreamBuf::STREAM_ZLIB;
+    else
+        throw std::runtime_error("Unsupported Content-Encoding of the response: " + content_encoding);
+
+    if (use_thread)
+        return std::make_unique<ThreadedInflatingInputStream>(source, type);
+
+    // Errors in the compressed data must not look like a premature end of the data.
+    auto stream = std::make_unique<Poco::InflatingInputStream>(source, type);
+    stream->exceptions(std::ios::badbit);
+    return stream;
+}
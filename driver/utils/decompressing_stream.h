@@ -0,0 +1,10 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <string>
+
+// Creates a stream, that decompresses the data of the source stream encoded according to the HTTP Content-Encoding,
+// or returns nullptr, if the data is not encoded. With use_thread, the data is decompressed on a helper thread,
+// ahead of its consumption. The source stream must outlive the returned stream.
+std::unique_ptr<std::istream> makeDecompressingStream(std::istream & source, const std::string & content_encoding, bool use_thread);
@@ -0,0 +1,39 @@
+#include "driver/utils/dns_cache.h"
+
+#include <Poco/Net/DNS.h>
+#include <Poco/Net/HostEntry.h>
+#include <Poco/Net/NetException.h>
+
+DNSCache & DNSCache::getInstance() {
+    static DNSCache cache;
+    return cache;
+}
+
+std::vector<Poco::Net::IPAddress> DNSCache::resolve(const std::string & host, std::chrono::seconds ttl) {
+    Poco::Net::IPAddress literal;
+    if (Poco::Net::IPAddress::tryParse(host, literal))
+        return { literal };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto it = entries_.find(host);
+
+        if (it != entries_.end() && Clock::now() - it->second.resolved_at < ttl)
+            return it->second.addresses;
+    }
+
+    // The name is resolved without holding the lock, concurrent resolutions of the same name are harmless.
+    auto addresses = Poco::Net::DNS::resolve(host).addresses();
+    if (addresses.empty())
+        throw Poco::Net::NoAddressFoundException(host);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[host] = Entry{addresses, Clock::now()};
+
+    return addresses;
+}
+
+void DNSCache::invalidate(const std::string & host) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(host);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Poco/Net/IPAddress.h>
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A process-wide cache of the addresses of host names. Thread-safe.
+class DNSCache {
+public:
+    static DNSCache & getInstance();
+
+    // Return all addresses of the host, resolving its name, unless that has been done within the last ttl.
+    std::vector<Poco::Net::IPAddress> resolve(const std::string & host, std::chrono::seconds ttl);
+
+    // Forget the addresses of the host, e.g., when none of them is reachable anymore.
+    void invalidate(const std::string & host);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::vector<Poco::Net::IPAddress> addresses;
+        Clock::time_point resolved_at;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+};
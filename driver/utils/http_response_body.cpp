@@ -0,0 +1,313 @@
+#include "driver/utils/http_response_body.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <cstring>
+
+namespace {
+
+    // Enough for the chunk headers and trailers, the payload of large reads bypasses this buffer.
+    constexpr std::size_t buffer_size = 1 << 16; // 64 KB
+    constexpr std::size_t max_line_size = 1 << 12; // 4 KB
+
+    int hexDigitValue(const char ch) {
+        if (ch >= '0' && ch <= '9')
+            return ch - '0';
+
+        if (ch >= 'a' && ch <= 'f')
+            return ch - 'a' + 10;
+
+        if (ch >= 'A' && ch <= 'F')
+            return ch - 'A' + 10;
+
+        return -1;
+    }
+
+    class ResponseBodyStream
+        : public std::istream
+    {
+    public:
+        explicit ResponseBodyStream(ResponseBodySource & source, bool chunked, std::streamsize content_length)
+            : std::istream(nullptr)
+            , buf_(source, chunked, content_length)
+        {
+            rdbuf(&buf_);
+
+            // Errors of reading the response must not look like the end of the data.
+            exceptions(std::ios::badbit);
+        }
+
+    private:
+        HTTPResponseBodyStreamBuf buf_;
+    };
+
+} // namespace
+
+HTTPResponseBodyStreamBuf::HTTPResponseBodyStreamBuf(ResponseBodySource & source, bool chunked, std::streamsize content_length)
+    : source_(source)
+    , chunked_(chunked)
+    , remaining_(chunked ? 0 : content_length)
+    , finished_(!chunked && content_length == 0)
+{
+    buffer_.resize(buffer_size);
+}
+
+HTTPResponseBodyStreamBuf::int_type HTTPResponseBodyStreamBuf::underflow() {
+    commit();
+
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    if (!prepare())
+        return traits_type::eof();
+
+    if (!exposeBuffered()) {
+        fillBuffer();
+
+        if (!exposeBuffered())
+            return traits_type::eof(); // The body ends with the data.
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize HTTPResponseBodyStreamBuf::xsgetn(char_type * dest, std::streamsize count) {
+    std::streamsize copied = 0;
+
+    while (copied < count) {
+        commit();
+
+        if (gptr() < egptr()) {
+            const auto size = std::min<std::streamsize>(egptr() - gptr(), count - copied);
+            std::memcpy(dest + copied, gptr(), size);
+            gbump(static_cast<int>(size));
+            copied += size;
+            continue;
+        }
+
+        if (!prepare())
+            break;
+
+        if (exposeBuffered())
+            continue;
+
+        // Nothing is buffered, so the payload is received right into the destination.
+        const auto received = receive(dest + copied, std::min(count - copied, remaining_));
+        if (received == 0)
+            break;
+
+        copied += received;
+
+        if (remaining_ != until_end_of_data)
+            remaining_ -= received;
+    }
+
+    return copied;
+}
+
+std::streamsize HTTPResponseBodyStreamBuf::showmanyc() {
+    commit();
+
+    if (finished_)
+        return -1;
+
+    // Only the payload of the current chunk can be read without blocking for sure.
+    if (remaining_ == 0)
+        return (chunked_ ? 0 : -1);
+
+    if (exposeBuffered())
+        return egptr() - gptr();
+
+    return std::min(remaining_, source_.available());
+}
+
+std::streamsize HTTPResponseBodyStreamBuf::getRemainingSize() {
+    commit();
+
+    if (finished_)
+        return 0;
+
+    if (chunked_ || remaining_ == until_end_of_data)
+        return -1;
+
+    return remaining_;
+}
+
+bool HTTPResponseBodyStreamBuf::skipAvailable(std::streamsize max_size, std::streamsize & skipped) {
+    std::streamsize skipped_here = 0;
+
+    while (true) {
+        commit();
+
+        if (gptr() < egptr()) {
+            const auto size = std::min<std::streamsize>(egptr() - gptr(), max_size - skipped_here + 1);
+            gbump(static_cast<int>(size));
+            skipped_here += size;
+            skipped += size;
+
+            if (skipped_here > max_size)
+                return false;
+
+            continue;
+        }
+
+        if (finished_)
+            return true;
+
+        if (!chunked_ && remaining_ == 0) {
+            finished_ = true;
+            return true;
+        }
+
+        // Nothing is buffered, and nothing has arrived, so going on would block.
+        if (begin_ == end_ && source_.available() <= 0)
+            return false;
+
+        if (traits_type::eq_int_type(underflow(), traits_type::eof()))
+            return true;
+    }
+}
+
+void HTTPResponseBodyStreamBuf::commit() {
+    if (!eback())
+        return;
+
+    const std::size_t consumed = gptr() - eback();
+    begin_ += consumed;
+
+    if (remaining_ != until_end_of_data)
+        remaining_ -= consumed;
+
+    setg(eback() + consumed, gptr(), egptr());
+}
+
+bool HTTPResponseBodyStreamBuf::prepare() {
+    if (finished_)
+        return false;
+
+    if (remaining_ > 0)
+        return true;
+
+    if (!chunked_) {
+        finished_ = true;
+        return false;
+    }
+
+    // Each chunk is terminated by CRLF.
+    if (in_chunk_ && !readLine().empty())
+        throw std::runtime_error("Malformed chunked HTTP response body: chunk is longer than declared");
+
+    in_chunk_ = false;
+
+    const auto header = readLine();
+    std::streamsize chunk_size = 0;
+    std::size_t digits = 0;
+
+    for (; digits < header.size(); ++digits) {
+        const auto digit = hexDigitValue(header[digits]);
+        if (digit < 0)
+            break;
+
+        if (chunk_size > (std::numeric_limits<std::streamsize>::max() >> 4))
+            throw std::runtime_error("Malformed chunked HTTP response body: chunk size is too large");
+
+        chunk_size = (chunk_size << 4) | digit;
+    }
+
+    if (digits == 0 || (digits < header.size() && header[digits] != ';' && header[digits] != ' ' && header[digits] != '\t'))
+        throw std::runtime_error("Malformed chunked HTTP response body: invalid chunk size");
+
+    if (chunk_size == 0) {
+        // Skip the trailer, that ends with an empty line.
+        while (!readLine().empty()) {
+        }
+
+        finished_ = true;
+        return false;
+    }
+
+    remaining_ = chunk_size;
+    in_chunk_ = true;
+
+    return true;
+}
+
+bool HTTPResponseBodyStreamBuf::exposeBuffered() {
+    const auto size = std::min<std::streamsize>(end_ - begin_, remaining_);
+    if (size == 0)
+        return false;
+
+    auto * data = &buffer_[begin_];
+    setg(data, data, data + size);
+
+    return true;
+}
+
+std::string HTTPResponseBodyStreamBuf::readLine() {
+    setg(nullptr, nullptr, nullptr);
+
+    std::size_t searched = 0; // The number of bytes at begin_, that are known not to contain the end of the line.
+
+    while (true) {
+        const auto * eol = static_cast<const char *>(std::memchr(&buffer_[begin_ + searched], '\n', end_ - begin_ - searched));
+
+        if (eol) {
+            const std::size_t eol_pos = eol - buffer_.data();
+            std::string line(buffer_, begin_, eol_pos - begin_);
+            begin_ = eol_pos + 1;
+
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+
+            return line;
+        }
+
+        searched = end_ - begin_;
+        if (searched >= max_line_size)
+            throw std::runtime_error("Malformed chunked HTTP response body: line is too long");
+
+        fillBuffer();
+    }
+}
+
+std::streamsize HTTPResponseBodyStreamBuf::receive(char * dest, std::streamsize count) {
+    const auto received = source_.readSome(dest, count);
+
+    if (received == 0) {
+        if (remaining_ != until_end_of_data)
+            throw std::runtime_error("Unexpected end of HTTP response body");
+
+        finished_ = true;
+    }
+
+    return received;
+}
+
+void HTTPResponseBodyStreamBuf::fillBuffer() {
+    setg(nullptr, nullptr, nullptr);
+
+    // Move the undecoded data to the beginning of the buffer.
+    if (begin_ > 0) {
+        std::memmove(&buffer_[0], &buffer_[begin_], end_ - begin_);
+        end_ -= begin_;
+        begin_ = 0;
+    }
+
+    // Read no further than the current chunk, or the body, if it is not chunked, unless a chunk header is being read.
+    auto count = static_cast<std::streamsize>(buffer_.size() - end_);
+    if (remaining_ > 0 && remaining_ < count)
+        count = remaining_;
+
+    end_ += receive(&buffer_[end_], count);
+}
+
+std::unique_ptr<std::istream> makeResponseBodyStream(ResponseBodySource & source, const Poco::Net::HTTPResponse & response) {
+    if (response.getChunkedTransferEncoding())
+        return std::make_unique<ResponseBodyStream>(source, true, 0);
+
+    if (response.hasContentLength())
+        return std::make_unique<ResponseBodyStream>(source, false, response.getContentLength64());
+
+    return std::make_unique<ResponseBodyStream>(source, false, HTTPResponseBodyStreamBuf::until_end_of_data);
+}
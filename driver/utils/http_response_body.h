@@ -0,0 +1,109 @@
+#pragma once
+
+#include <Poco/Net/HTTPClientSession.h>
+#include <Poco/Net/HTTPResponse.h>
+#include <Poco/Net/SocketAddress.h>
+
+#include <istream>
+#include <limits>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+// A source of the raw data of HTTP response bodies.
+class ResponseBodySource {
+public:
+    virtual ~ResponseBodySource() = default;
+
+    // Read at least 1 byte, blocking if needed, or return 0 at the end of the data.
+    virtual std::streamsize readSome(char * buffer, std::streamsize size) = 0;
+
+    // Return the number of bytes, that can be read right away, without blocking.
+    virtual std::streamsize available() = 0;
+};
+
+// A session, that can be connected to a specific address of its host, e.g., one of those resolved in advance.
+class AddressConnectable {
+public:
+    virtual ~AddressConnectable() = default;
+
+    // Connect to the address, doing the TLS handshake for the host name of the session, if it is secure.
+    virtual void connectTo(const Poco::Net::SocketAddress & address) = 0;
+};
+
+// An HTTP(S) session, that lets the response bodies be read directly from its socket, bypassing the stream buffers of Poco.
+template <typename Session>
+class DirectReadHTTPSession
+    : public Session
+    , public ResponseBodySource
+    , public AddressConnectable
+{
+public:
+    using Session::Session;
+
+    virtual void connectTo(const Poco::Net::SocketAddress & address) override {
+        this->connect(address);
+    }
+
+    virtual std::streamsize readSome(char * buffer, std::streamsize size) override {
+        // The data, that is already buffered by the session while reading the response header, is returned first.
+        return this->read(buffer, std::min<std::streamsize>(size, std::numeric_limits<int>::max()));
+    }
+
+    virtual std::streamsize available() override {
+        return this->socket().available();
+    }
+};
+
+// Decodes the body of an HTTP response, either chunked, of a known length, or ending with the connection, read from the source.
+// The payload is received directly into the buffers of the readers, unless it is mixed with the chunk headers read so far.
+class HTTPResponseBodyStreamBuf
+    : public std::streambuf
+{
+public:
+    static constexpr std::streamsize until_end_of_data = std::numeric_limits<std::streamsize>::max();
+
+    // content_length is ignored for chunked bodies.
+    explicit HTTPResponseBodyStreamBuf(ResponseBodySource & source, bool chunked, std::streamsize content_length);
+
+    // Return the number of the payload bytes left till the end of the body, or -1, if it is not known, e.g., for chunked bodies.
+    std::streamsize getRemainingSize();
+
+    // Skip the rest of the body, as long as its data has already arrived, but no more than max_size payload bytes, adding their number
+    // to skipped. Return true if the end of the body is reached.
+    bool skipAvailable(std::streamsize max_size, std::streamsize & skipped);
+
+protected:
+    virtual int_type underflow() override;
+    virtual std::streamsize xsgetn(char_type * dest, std::streamsize count) override;
+    virtual std::streamsize showmanyc() override;
+
+private:
+    // Account the bytes consumed from the get area since the last call.
+    void commit();
+
+    // Make sure that the current chunk has some payload left, return false at the end of the body.
+    bool prepare();
+
+    // Expose the buffered payload of the current chunk as the get area, return false if nothing is buffered.
+    bool exposeBuffered();
+
+    std::string readLine();
+    std::streamsize receive(char * dest, std::streamsize count);
+    void fillBuffer();
+
+private:
+    ResponseBodySource & source_;
+    const bool chunked_;
+    std::streamsize remaining_ = 0; // Payload bytes left in the current chunk, or in the entire body, if it is not chunked.
+    bool in_chunk_ = false;
+    bool finished_ = false;
+
+    // Raw data that is read from the source but not yet decoded, in [begin_, end_).
+    std::string buffer_;
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+};
+
+// Creates a stream, that reads the body of the response, which header has just been received from the source.
+std::unique_ptr<std::istream> makeResponseBodyStream(ResponseBodySource & source, const Poco::Net::HTTPResponse & response);
@@ -0,0 +1,280 @@
+#include "driver/utils/load_balancer.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <stdexcept>
+
+#include <cctype>
+
+namespace {
+
+    std::string trim(const std::string & str) {
+        const auto begin = std::find_if_not(str.begin(), str.end(), [] (unsigned char ch) { return std::isspace(ch); });
+        const auto end = std::find_if_not(str.rbegin(), str.rend(), [] (unsigned char ch) { return std::isspace(ch); }).base();
+        return (begin < end ? std::string(begin, end) : std::string{});
+    }
+
+    std::uint16_t parsePort(const std::string & str, const std::string & item) {
+        if (str.empty() || str.size() > 5 || !std::all_of(str.begin(), str.end(), [] (unsigned char ch) { return std::isdigit(ch); }))
+            throw std::runtime_error("Invalid port in server list item '" + item + "'");
+
+        const auto port = std::stoul(str);
+        if (port == 0 || port > std::numeric_limits<std::uint16_t>::max())
+            throw std::runtime_error("Invalid port in server list item '" + item + "'");
+
+        return static_cast<std::uint16_t>(port);
+    }
+
+} // namespace
+
+std::vector<Endpoint> parseEndpoints(const std::string & list, std::uint16_t default_port) {
+    std::vector<Endpoint> endpoints;
+    std::size_t begin = 0;
+
+    while (begin <= list.size()) {
+        auto end = list.find(',', begin);
+        if (end == std::string::npos)
+            end = list.size();
+
+        const auto item = trim(list.substr(begin, end - begin));
+        begin = end + 1;
+
+        if (item.empty())
+            continue;
+
+        Endpoint endpoint;
+        endpoint.port = default_port;
+
+        if (item[0] == '[') {
+            const auto closing = item.find(']');
+            if (closing == std::string::npos)
+                throw std::runtime_error("Invalid IPv6 address in server list item '" + item + "'");
+
+            endpoint.host = item.substr(1, closing - 1);
+
+            if (closing + 1 < item.size()) {
+                if (item[closing + 1] != ':')
+                    throw std::runtime_error("Invalid server list item '" + item + "'");
+
+                endpoint.port = parsePort(item.substr(closing + 2), item);
+            }
+        }
+        else {
+            const auto colon = item.find(':');
+
+            // More than one colon means an IPv6 address without a port.
+            if (colon != std::string::npos && item.find(':', colon + 1) == std::string::npos) {
+                endpoint.host = item.substr(0, colon);
+                endpoint.port = parsePort(item.substr(colon + 1), item);
+            }
+            else {
+                endpoint.host = item;
+            }
+        }
+
+        if (endpoint.host.empty())
+            throw std::runtime_error("Empty host in server list item '" + item + "'");
+
+        endpoints.emplace_back(std::move(endpoint));
+    }
+
+    return endpoints;
+}
+
+LoadBalancer::LoadBalancer(std::vector<Endpoint> endpoints, Policy policy, std::chrono::milliseconds cooldown, HealthCheck health_check)
+    : endpoints_(std::move(endpoints))
+    , policy_(policy)
+    , cooldown_(cooldown)
+    , health_check_(std::move(health_check))
+    , states_(endpoints_.size())
+    , random_(std::random_device{}())
+{
+    if (endpoints_.empty())
+        throw std::runtime_error("No servers to connect to");
+}
+
+LoadBalancer::~LoadBalancer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+
+    cv_.notify_all();
+
+    // The checker may still be waiting for a server to respond, in which case this waits until the check is over.
+    if (health_checker_.joinable())
+        health_checker_.join();
+}
+
+std::shared_ptr<LoadBalancer> LoadBalancer::getShared(const std::string & key, const std::function<std::shared_ptr<LoadBalancer> ()> & create) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<LoadBalancer>> balancers;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Forget the balancers, that are not used anymore.
+    for (auto it = balancers.begin(); it != balancers.end();) {
+        if (it->second.expired())
+            it = balancers.erase(it);
+        else
+            ++it;
+    }
+
+    auto & weak_balancer = balancers[key];
+    auto balancer = weak_balancer.lock();
+
+    if (!balancer) {
+        balancer = create();
+        weak_balancer = balancer;
+    }
+
+    return balancer;
+}
+
+std::size_t LoadBalancer::size() const {
+    return endpoints_.size();
+}
+
+const Endpoint & LoadBalancer::getEndpoint(std::size_t idx) const {
+    return endpoints_.at(idx);
+}
+
+std::size_t LoadBalancer::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto idx = choose(false);
+    if (idx >= endpoints_.size())
+        idx = choose(true); // All endpoints are ejected, so any of them may be the first to come back.
+
+    ++states_[idx].outstanding;
+    return idx;
+}
+
+void LoadBalancer::finish(std::size_t idx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (states_.at(idx).outstanding > 0)
+        --states_[idx].outstanding;
+}
+
+void LoadBalancer::eject(std::size_t idx) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto & state = states_.at(idx);
+
+        if (state.ejected)
+            return;
+
+        state.ejected = true;
+        state.next_check = Clock::now() + cooldown_;
+
+        if (!health_checker_.joinable())
+            health_checker_ = std::thread([this] () { runHealthChecks(); });
+    }
+
+    cv_.notify_all();
+}
+
+bool LoadBalancer::isEjected(std::size_t idx) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return states_.at(idx).ejected;
+}
+
+std::size_t LoadBalancer::choose(bool include_ejected) {
+    const auto count = endpoints_.size();
+    auto chosen = count;
+
+    switch (policy_) {
+        case Policy::RoundRobin: {
+            for (std::size_t i = 0; i < count && chosen == count; ++i) {
+                const auto idx = (next_ + i) % count;
+                if (include_ejected || !states_[idx].ejected)
+                    chosen = idx;
+            }
+            break;
+        }
+
+        case Policy::LeastOutstanding: {
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto idx = (next_ + i) % count;
+                if ((include_ejected || !states_[idx].ejected) && (chosen == count || states_[idx].outstanding < states_[chosen].outstanding))
+                    chosen = idx;
+            }
+            break;
+        }
+
+        case Policy::Random: {
+            std::uint64_t total_weight = 0;
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                if (include_ejected || !states_[idx].ejected)
+                    total_weight += endpoints_[idx].weight;
+            }
+
+            if (total_weight == 0)
+                break;
+
+            auto point = std::uniform_int_distribution<std::uint64_t>(0, total_weight - 1)(random_);
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                if (!include_ejected && states_[idx].ejected)
+                    continue;
+
+                if (point < endpoints_[idx].weight) {
+                    chosen = idx;
+                    break;
+                }
+
+                point -= endpoints_[idx].weight;
+            }
+            break;
+        }
+    }
+
+    if (chosen < count)
+        next_ = (chosen + 1) % count;
+
+    return chosen;
+}
+
+void LoadBalancer::runHealthChecks() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        auto due = Clock::time_point::max();
+        std::size_t due_idx = endpoints_.size();
+
+        for (std::size_t idx = 0; idx < endpoints_.size(); ++idx) {
+            if (states_[idx].ejected && states_[idx].next_check < due) {
+                due = states_[idx].next_check;
+                due_idx = idx;
+            }
+        }
+
+        if (due_idx == endpoints_.size()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        if (Clock::now() < due) {
+            cv_.wait_until(lock, due);
+            continue;
+        }
+
+        lock.unlock();
+
+        bool available = false;
+        try {
+            available = (health_check_ && health_check_(endpoints_[due_idx]));
+        }
+        catch (...) {
+        }
+
+        lock.lock();
+
+        auto & state = states_[due_idx];
+        if (available)
+            state.ejected = false;
+        else
+            state.next_check = Clock::now() + cooldown_;
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <cstdint>
+
+// A server, that the requests can be sent to.
+struct Endpoint {
+    std::string host;
+    std::uint16_t port = 0;
+    std::uint32_t weight = 1;
+};
+
+// Parses a comma-separated list of "host", "host:port", or "[IPv6 address]:port" items, using default_port for those without a port.
+std::vector<Endpoint> parseEndpoints(const std::string & list, std::uint16_t default_port);
+
+// Chooses the endpoints for the requests, keeping track of the requests, that are still outstanding, and of the failed endpoints.
+// The failed endpoints are ejected, until a periodic background health check finds them available again. Thread-safe.
+class LoadBalancer {
+public:
+    enum class Policy {
+        RoundRobin,
+        LeastOutstanding,
+        Random, // Weighted.
+    };
+
+    using HealthCheck = std::function<bool (const Endpoint & endpoint)>;
+
+    explicit LoadBalancer(std::vector<Endpoint> endpoints, Policy policy, std::chrono::milliseconds cooldown, HealthCheck health_check);
+    ~LoadBalancer();
+
+    // Return the balancer, that is shared by all users of the same key, while at least one of them holds it, creating it if needed.
+    static std::shared_ptr<LoadBalancer> getShared(const std::string & key, const std::function<std::shared_ptr<LoadBalancer> ()> & create);
+
+    std::size_t size() const;
+    const Endpoint & getEndpoint(std::size_t idx) const;
+
+    // Choose the endpoint for the next request, and count the request as outstanding, until finish() is called.
+    // The ejected endpoints are not chosen, unless all endpoints are ejected.
+    std::size_t start();
+
+    void finish(std::size_t idx);
+
+    // Stop choosing the endpoint, until it passes a health check, that is done each cooldown period.
+    void eject(std::size_t idx);
+
+    bool isEjected(std::size_t idx) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        std::size_t outstanding = 0;
+        bool ejected = false;
+        Clock::time_point next_check;
+    };
+
+    std::size_t choose(bool include_ejected);
+    void runHealthChecks();
+
+private:
+    const std::vector<Endpoint> endpoints_;
+    const Policy policy_;
+    const std::chrono::milliseconds cooldown_;
+    const HealthCheck health_check_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<State> states_;
+    std::size_t next_ = 0; // The endpoint to start the search from, rotated to spread the choices among equally good endpoints.
+    std::mt19937 random_;
+    bool stopping_ = false;
+    std::thread health_checker_; // Started by the first ejection.
+};
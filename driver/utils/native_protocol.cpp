@@ -0,0 +1,1040 @@
+#include "driver/utils/native_protocol.h"
+#include "driver/exception.h"
+
+#include <algorithm>
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+    namespace ClientPacket {
+        enum : std::uint64_t {
+            Hello = 0,
+            Query = 1,
+            Data = 2,
+            Cancel = 3,
+            Ping = 4
+        };
+    }
+
+    namespace ServerPacket {
+        enum : std::uint64_t {
+            Hello = 0,
+            Data = 1,
+            Exception = 2,
+            Progress = 3,
+            Pong = 4,
+            EndOfStream = 5,
+            ProfileInfo = 6,
+            Totals = 7,
+            Extremes = 8,
+            TablesStatusResponse = 9,
+            Log = 10,
+            TableColumns = 11
+        };
+    }
+
+    constexpr std::uint64_t min_revision_with_server_timezone = 54058;
+
+    constexpr std::uint8_t query_kind_initial = 1;
+    constexpr std::uint8_t interface_tcp = 1;
+    constexpr std::uint64_t stage_complete = 2;
+
+    // Each compressed frame starts with the checksum, followed by the header: the method, and the compressed (including the header)
+    // and the decompressed sizes.
+    constexpr std::size_t checksum_size = 16;
+    constexpr std::size_t frame_header_size = 9;
+    constexpr std::uint8_t method_none = 0x02;
+    constexpr std::uint8_t method_lz4 = 0x82;
+
+    // The limits, that guard against the malformed data, the same as those of the server.
+    constexpr std::size_t max_frame_size = 1 << 30;
+    constexpr std::size_t max_string_size = 1 << 30;
+    constexpr std::size_t max_column_count = 1 << 20;
+
+    void readBytes(std::istream & in, char * dest, std::size_t size) {
+        in.read(dest, size);
+        if (static_cast<std::size_t>(in.gcount()) != size)
+            throw std::runtime_error("Unexpected end of the data from the server");
+    }
+
+    template <typename T>
+    T readFixed(std::istream & in) {
+        T value;
+        readBytes(in, reinterpret_cast<char *>(&value), sizeof(value));
+        return value;
+    }
+
+    std::uint64_t readVarUInt(std::istream & in) {
+        std::uint64_t value = 0;
+
+        for (std::size_t i = 0; i < 10; ++i) {
+            const auto byte = readFixed<std::uint8_t>(in);
+            value |= static_cast<std::uint64_t>(byte & 0b01111111) << (7 * i);
+
+            if ((byte & 0b10000000) == 0)
+                break;
+        }
+
+        return value;
+    }
+
+    std::string readString(std::istream & in) {
+        const auto size = readVarUInt(in);
+        if (size > max_string_size)
+            throw std::runtime_error("Too large string in the data from the server");
+
+        std::string value(size, '\0');
+        if (size > 0)
+            readBytes(in, &value[0], size);
+
+        return value;
+    }
+
+    template <typename T>
+    void writeFixed(std::string & dest, T value) {
+        dest.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void writeVarUInt(std::string & dest, std::uint64_t value) {
+        do {
+            std::uint8_t byte = value & 0b01111111;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0b10000000;
+            dest.push_back(static_cast<char>(byte));
+        } while (value != 0);
+    }
+
+    void writeString(std::string & dest, const std::string & value) {
+        writeVarUInt(dest, value.size());
+        dest.append(value);
+    }
+
+    // A Data packet with an empty block ends the data of the external tables of a query, or the data of an INSERT query.
+    void writeEmptyDataPacket(std::string & dest, bool compression) {
+        writeVarUInt(dest, ClientPacket::Data);
+        writeString(dest, ""); // The name of the table is never compressed.
+
+        std::string block;
+        writeVarUInt(block, 1); // is_overflows
+        writeFixed<std::uint8_t>(block, 0);
+        writeVarUInt(block, 2); // bucket_num
+        writeFixed<std::int32_t>(block, -1);
+        writeVarUInt(block, 0); // The end of the block info.
+        writeVarUInt(block, 0); // Columns.
+        writeVarUInt(block, 0); // Rows.
+
+        dest.append(compression ? compressNativeFrame(block) : block);
+    }
+
+    bool isIdentifierChar(char ch) {
+        return (std::isalnum(static_cast<unsigned char>(ch)) || ch == '_');
+    }
+
+    // The server asks for the data of an INSERT query, unless the query has it, or selects it, by sending the structure of the table.
+    bool isInsertQuery(const std::string & query) {
+        std::size_t pos = 0;
+
+        while (pos < query.size()) {
+            if (std::isspace(static_cast<unsigned char>(query[pos])) || query[pos] == '(') {
+                ++pos;
+            }
+            else if (query.compare(pos, 2, "--") == 0) {
+                pos = query.find('\n', pos);
+            }
+            else if (query.compare(pos, 2, "/*") == 0) {
+                pos = query.find("*/", pos);
+                if (pos != std::string::npos)
+                    pos += 2;
+            }
+            else {
+                break;
+            }
+        }
+
+        static const std::string keyword = "INSERT";
+
+        if (pos >= query.size() || query.size() - pos < keyword.size())
+            return false;
+
+        for (std::size_t i = 0; i < keyword.size(); ++i) {
+            if (std::toupper(static_cast<unsigned char>(query[pos + i])) != keyword[i])
+                return false;
+        }
+
+        return (query.size() - pos == keyword.size() || !isIdentifierChar(query[pos + keyword.size()]));
+    }
+
+    std::size_t parseSize(const std::string & str, const std::string & type) {
+        char * end = nullptr;
+        const auto value = std::strtoull(str.c_str(), &end, 10);
+
+        if (str.empty() || !std::isdigit(static_cast<unsigned char>(str[0])) || (*end != ',' && *end != ')'))
+            throw std::runtime_error("Invalid parameters of column type '" + type + "' from the server");
+
+        return value;
+    }
+
+    // How the values of a column are laid out in Native format, and how they are re-encoded in RowBinary format.
+    struct ColumnLayout {
+        std::string row_binary_type;
+        std::size_t value_size = 0; // Of the fixed-size values, 0 for Strings.
+        bool nullable = false;
+        bool nothing = false; // Each value takes a byte in Native format, and nothing in RowBinary format.
+    };
+
+    ColumnLayout getColumnLayout(const std::string & type) {
+        static const std::vector<std::pair<std::string, std::size_t>> fixed_size_types = {
+            {"Int8", 1}, {"UInt8", 1}, {"Int16", 2}, {"UInt16", 2}, {"Int32", 4}, {"UInt32", 4}, {"Int64", 8}, {"UInt64", 8},
+            {"Float32", 4}, {"Float64", 8}, {"Date", 2}, {"UUID", 16}, {"Decimal32", 4}, {"Decimal64", 8}, {"Decimal128", 16}
+        };
+
+        static const std::string nullable_prefix = "Nullable(";
+
+        ColumnLayout layout;
+        layout.row_binary_type = type;
+
+        if (type.compare(0, nullable_prefix.size(), nullable_prefix) == 0 && type.back() == ')') {
+            layout.nullable = true;
+            layout.row_binary_type = type.substr(nullable_prefix.size(), type.size() - nullable_prefix.size() - 1);
+        }
+
+        const auto params_pos = layout.row_binary_type.find('(');
+        const auto name = layout.row_binary_type.substr(0, params_pos);
+        const auto params = (params_pos == std::string::npos ? std::string{} : layout.row_binary_type.substr(params_pos + 1));
+
+        const auto fixed_size_type_it = std::find_if(fixed_size_types.begin(), fixed_size_types.end(), [&] (const auto & fixed_size_type) {
+            return fixed_size_type.first == name;
+        });
+
+        if (fixed_size_type_it != fixed_size_types.end()) {
+            layout.value_size = fixed_size_type_it->second;
+        }
+        else if (name == "String") {
+            layout.value_size = 0;
+        }
+        else if (name == "Nothing") {
+            layout.nothing = true;
+        }
+        else if (name == "Bool") {
+            layout.value_size = 1;
+            layout.row_binary_type = "UInt8";
+        }
+        else if (name == "DateTime") {
+            // The time zone is not needed to decode the values.
+            layout.value_size = 4;
+            layout.row_binary_type = "DateTime";
+        }
+        else if (name == "FixedString") {
+            layout.value_size = parseSize(params, type);
+        }
+        else if (name == "Decimal") {
+            const auto precision = parseSize(params, type);
+            if (precision == 0 || precision > 38)
+                throw std::runtime_error("Invalid precision of column type '" + type + "' from the server");
+
+            layout.value_size = (precision <= 9 ? 4 : precision <= 18 ? 8 : 16);
+        }
+        else {
+            throw std::runtime_error("Column type '" + type + "' is not supported over the native protocol");
+        }
+
+        if (layout.value_size == 0 && !layout.nothing && name != "String")
+            throw std::runtime_error("Invalid size of column type '" + type + "' from the server");
+
+        if (layout.nullable)
+            layout.row_binary_type = nullable_prefix + layout.row_binary_type + ")";
+
+        return layout;
+    }
+
+    // The values of a column, each re-encoded in RowBinary format, the i-th value is in [offsets[i], offsets[i + 1]) of data.
+    struct ColumnValues {
+        std::string data;
+        std::vector<std::size_t> offsets;
+    };
+
+    void readColumn(std::istream & in, const ColumnLayout & layout, std::size_t row_count, ColumnValues & values) {
+        // The null map of a Nullable column precedes the values, which are there for the NULLs too.
+        std::string null_map(layout.nullable ? row_count : 0, '\0');
+        if (!null_map.empty())
+            readBytes(in, &null_map[0], null_map.size());
+
+        values.data.clear();
+        values.data.reserve(row_count * (layout.value_size + (layout.nullable ? 1 : 0)));
+        values.offsets.clear();
+        values.offsets.reserve(row_count + 1);
+        values.offsets.push_back(0);
+
+        for (std::size_t i = 0; i < row_count; ++i) {
+            const auto is_null = (layout.nullable && null_map[i] != 0);
+
+            if (layout.nullable)
+                values.data.push_back(is_null ? 1 : 0);
+
+            const auto value_begin = values.data.size();
+
+            if (layout.nothing) {
+                readFixed<std::uint8_t>(in);
+            }
+            else if (layout.value_size > 0) {
+                values.data.resize(value_begin + layout.value_size);
+                readBytes(in, &values.data[value_begin], layout.value_size);
+            }
+            else {
+                const auto size = readVarUInt(in);
+                if (size > max_string_size)
+                    throw std::runtime_error("Too large string in the data from the server");
+
+                writeVarUInt(values.data, size);
+                const auto pos = values.data.size();
+                values.data.resize(pos + size);
+                if (size > 0)
+                    readBytes(in, &values.data[pos], size);
+            }
+
+            if (is_null)
+                values.data.resize(value_begin);
+
+            values.offsets.push_back(values.data.size());
+        }
+    }
+
+    void readBlockFrom(std::istream & in, NativeProtocolClient::Block & block) {
+        while (true) {
+            const auto field_num = readVarUInt(in);
+
+            if (field_num == 0)
+                break;
+            else if (field_num == 1)
+                readFixed<std::uint8_t>(in); // is_overflows
+            else if (field_num == 2)
+                readFixed<std::int32_t>(in); // bucket_num
+            else
+                throw std::runtime_error("Unknown field of the block info from the server");
+        }
+
+        const auto column_count = readVarUInt(in);
+        const auto row_count = readVarUInt(in);
+
+        if (column_count > max_column_count)
+            throw std::runtime_error("Too many columns in the block from the server");
+
+        block.column_names.resize(column_count);
+        block.column_types.resize(column_count);
+        block.row_count = row_count;
+        block.rows.clear();
+
+        std::vector<ColumnValues> columns(column_count);
+        std::size_t total_size = 0;
+
+        // The columns have no data, when the block has no rows.
+        for (std::size_t i = 0; i < column_count; ++i) {
+            block.column_names[i] = readString(in);
+            const auto layout = getColumnLayout(readString(in));
+            block.column_types[i] = layout.row_binary_type;
+
+            if (row_count > 0)
+                readColumn(in, layout, row_count, columns[i]);
+
+            total_size += columns[i].data.size();
+        }
+
+        block.rows.reserve(total_size);
+
+        for (std::size_t row = 0; row < row_count; ++row) {
+            for (const auto & column : columns) {
+                block.rows.append(column.data, column.offsets[row], column.offsets[row + 1] - column.offsets[row]);
+            }
+        }
+    }
+
+    // Reads the data of the consecutive compressed frames from the stream, on demand.
+    class CompressedFramesStreamBuf
+        : public std::streambuf
+    {
+    public:
+        explicit CompressedFramesStreamBuf(std::istream & in)
+            : in_(in)
+        {
+        }
+
+    protected:
+        virtual int_type underflow() override {
+            while (gptr() == egptr()) {
+                readFrame();
+                setg(&buffer_[0], &buffer_[0], &buffer_[0] + buffer_.size());
+            }
+
+            return traits_type::to_int_type(*gptr());
+        }
+
+    private:
+        void readFrame() {
+            char checksum[checksum_size];
+            readBytes(in_, checksum, sizeof(checksum));
+
+            // The checksum covers the header too, so the header is read into the same buffer as the compressed data.
+            frame_.resize(frame_header_size);
+            readBytes(in_, &frame_[0], frame_header_size);
+
+            const auto method = static_cast<std::uint8_t>(frame_[0]);
+            std::uint32_t compressed_size = 0;
+            std::uint32_t decompressed_size = 0;
+            std::memcpy(&compressed_size, frame_.data() + 1, sizeof(compressed_size));
+            std::memcpy(&decompressed_size, frame_.data() + 5, sizeof(decompressed_size));
+
+            if (compressed_size < frame_header_size || compressed_size > max_frame_size || decompressed_size > max_frame_size)
+                throw std::runtime_error("Invalid size of a compressed frame from the server");
+
+            frame_.resize(compressed_size);
+            if (compressed_size > frame_header_size)
+                readBytes(in_, &frame_[frame_header_size], compressed_size - frame_header_size);
+
+            const auto expected_checksum = cityHash128(frame_.data(), frame_.size());
+            if (
+                std::memcmp(checksum, &expected_checksum.first, sizeof(expected_checksum.first)) != 0 ||
+                std::memcmp(checksum + sizeof(expected_checksum.first), &expected_checksum.second, sizeof(expected_checksum.second)) != 0
+            ) {
+                throw SqlException("Checksum mismatch of a compressed frame from the server", "08S01");
+            }
+
+            const auto * compressed = frame_.data() + frame_header_size;
+            const auto compressed_data_size = frame_.size() - frame_header_size;
+
+            buffer_.resize(decompressed_size);
+
+            if (method == method_lz4) {
+                decompressLZ4Block(compressed, compressed_data_size, &buffer_[0], buffer_.size());
+            }
+            else if (method == method_none) {
+                if (compressed_data_size != buffer_.size())
+                    throw std::runtime_error("Invalid size of an uncompressed frame from the server");
+
+                buffer_.assign(compressed, compressed_data_size);
+            }
+            else {
+                throw std::runtime_error("Unsupported compression method of the data from the server");
+            }
+        }
+
+    private:
+        std::istream & in_;
+        std::string frame_;
+        std::string buffer_;
+    };
+
+    class NativeResultStream
+        : public std::istream
+    {
+    public:
+        explicit NativeResultStream(NativeProtocolClient & client)
+            : std::istream(nullptr)
+            , buf_(client)
+        {
+            rdbuf(&buf_);
+
+            // Errors of receiving the results must not look like the end of the data.
+            exceptions(std::ios::badbit);
+        }
+
+    private:
+        NativeResultStreamBuf buf_;
+    };
+
+    [[noreturn]] void throwMalformedLZ4() {
+        throw std::runtime_error("Malformed LZ4 data from the server");
+    }
+
+    // The implementation of CityHash128 of version 1.0.2, the later versions produce different hashes.
+    namespace CityHash_v1_0_2 {
+
+        using uint64 = std::uint64_t;
+        using uint128 = std::pair<uint64, uint64>;
+
+        constexpr uint64 k0 = 0xc3a5c85c97cb3127ULL;
+        constexpr uint64 k1 = 0xb492b66fbe98f273ULL;
+        constexpr uint64 k2 = 0x9ae16a3b2f90404fULL;
+        constexpr uint64 k3 = 0xc949d7c7509e6557ULL;
+
+        uint64 Fetch64(const char * p) {
+            uint64 result;
+            std::memcpy(&result, p, sizeof(result));
+            return result;
+        }
+
+        uint64 Fetch32(const char * p) {
+            std::uint32_t result;
+            std::memcpy(&result, p, sizeof(result));
+            return result;
+        }
+
+        uint64 Rotate(uint64 val, int shift) {
+            return (shift == 0 ? val : ((val >> shift) | (val << (64 - shift))));
+        }
+
+        uint64 RotateByAtLeast1(uint64 val, int shift) {
+            return ((val >> shift) | (val << (64 - shift)));
+        }
+
+        uint64 ShiftMix(uint64 val) {
+            return val ^ (val >> 47);
+        }
+
+        uint64 Hash128to64(const uint128 & x) {
+            const uint64 kMul = 0x9ddfea08eb382d69ULL;
+            uint64 a = (x.first ^ x.second) * kMul;
+            a ^= (a >> 47);
+            uint64 b = (x.second ^ a) * kMul;
+            b ^= (b >> 47);
+            b *= kMul;
+            return b;
+        }
+
+        uint64 HashLen16(uint64 u, uint64 v) {
+            return Hash128to64(uint128(u, v));
+        }
+
+        uint64 HashLen0to16(const char * s, std::size_t len) {
+            if (len > 8) {
+                const uint64 a = Fetch64(s);
+                const uint64 b = Fetch64(s + len - 8);
+                return HashLen16(a, RotateByAtLeast1(b + len, static_cast<int>(len))) ^ b;
+            }
+
+            if (len >= 4) {
+                const uint64 a = Fetch32(s);
+                return HashLen16(len + (a << 3), Fetch32(s + len - 4));
+            }
+
+            if (len > 0) {
+                const std::uint8_t a = s[0];
+                const std::uint8_t b = s[len >> 1];
+                const std::uint8_t c = s[len - 1];
+                const std::uint32_t y = static_cast<std::uint32_t>(a) + (static_cast<std::uint32_t>(b) << 8);
+                const std::uint32_t z = static_cast<std::uint32_t>(len) + (static_cast<std::uint32_t>(c) << 2);
+                return ShiftMix(y * k2 ^ z * k3) * k2;
+            }
+
+            return k2;
+        }
+
+        uint128 WeakHashLen32WithSeeds(uint64 w, uint64 x, uint64 y, uint64 z, uint64 a, uint64 b) {
+            a += w;
+            b = Rotate(b + a + z, 21);
+            const uint64 c = a;
+            a += x;
+            a += y;
+            b += Rotate(a, 44);
+            return uint128(a + z, b + c);
+        }
+
+        uint128 WeakHashLen32WithSeeds(const char * s, uint64 a, uint64 b) {
+            return WeakHashLen32WithSeeds(Fetch64(s), Fetch64(s + 8), Fetch64(s + 16), Fetch64(s + 24), a, b);
+        }
+
+        uint128 CityMurmur(const char * s, std::size_t len, uint128 seed) {
+            uint64 a = seed.first;
+            uint64 b = seed.second;
+            uint64 c = 0;
+            uint64 d = 0;
+            std::int64_t l = static_cast<std::int64_t>(len) - 16;
+
+            if (l <= 0) {
+                a = ShiftMix(a * k1) * k1;
+                c = b * k1 + HashLen0to16(s, len);
+                d = ShiftMix(a + (len >= 8 ? Fetch64(s) : c));
+            }
+            else {
+                c = HashLen16(Fetch64(s + len - 8) + k1, a);
+                d = HashLen16(b + len, c + Fetch64(s + len - 16));
+                a += d;
+
+                do {
+                    a ^= ShiftMix(Fetch64(s) * k1) * k1;
+                    a *= k1;
+                    b ^= a;
+                    c ^= ShiftMix(Fetch64(s + 8) * k1) * k1;
+                    c *= k1;
+                    d ^= c;
+                    s += 16;
+                    l -= 16;
+                } while (l > 0);
+            }
+
+            a = HashLen16(a, c);
+            b = HashLen16(d, b);
+            return uint128(a ^ b, HashLen16(b, a));
+        }
+
+        uint128 CityHash128WithSeed(const char * s, std::size_t len, uint128 seed) {
+            if (len < 128)
+                return CityMurmur(s, len, seed);
+
+            uint128 v;
+            uint128 w;
+            uint64 x = seed.first;
+            uint64 y = seed.second;
+            uint64 z = len * k1;
+            v.first = Rotate(y ^ k1, 49) * k1 + Fetch64(s);
+            v.second = Rotate(v.first, 42) * k1 + Fetch64(s + 8);
+            w.first = Rotate(y + z, 35) * k1 + x;
+            w.second = Rotate(x + Fetch64(s + 88), 53) * k1;
+
+            do {
+                for (int i = 0; i < 2; ++i) {
+                    x = Rotate(x + y + v.first + Fetch64(s + 16), 37) * k1;
+                    y = Rotate(y + v.second + Fetch64(s + 48), 42) * k1;
+                    x ^= w.second;
+                    y ^= v.first;
+                    z = Rotate(z ^ w.first, 33);
+                    v = WeakHashLen32WithSeeds(s, v.second * k1, x + w.first);
+                    w = WeakHashLen32WithSeeds(s + 32, z + w.second, y);
+                    std::swap(z, x);
+                    s += 64;
+                }
+
+                len -= 128;
+            } while (len >= 128);
+
+            y += Rotate(w.first, 37) * k0 + z;
+            x += Rotate(v.first + z, 49) * k0;
+
+            for (std::size_t tail_done = 0; tail_done < len; ) {
+                tail_done += 32;
+                y = Rotate(y - x, 42) * k0 + v.second;
+                w.first += Fetch64(s + len - tail_done + 16);
+                x = Rotate(x, 49) * k0 + w.first;
+                w.first += v.first;
+                v = WeakHashLen32WithSeeds(s + len - tail_done, v.first, v.second);
+            }
+
+            x = HashLen16(x, v.first);
+            y = HashLen16(y, w.first);
+            return uint128(HashLen16(x + v.second, w.second) + y, HashLen16(x + w.second, y + v.second));
+        }
+
+        uint128 CityHash128(const char * s, std::size_t len) {
+            if (len >= 16)
+                return CityHash128WithSeed(s + 16, len - 16, uint128(Fetch64(s) ^ k3, Fetch64(s + 8)));
+            else if (len >= 8)
+                return CityHash128WithSeed(nullptr, 0, uint128(Fetch64(s) ^ (len * k0), Fetch64(s + len - 8) ^ k1));
+            else
+                return CityHash128WithSeed(s, len, uint128(k0, k1));
+        }
+
+    } // namespace CityHash_v1_0_2
+
+} // namespace
+
+NativeServerException::NativeServerException(std::int32_t code, const std::string & name, const std::string & message)
+    : std::runtime_error("Code: " + std::to_string(code) + ". " + message)
+    , code_(code)
+    , name_(name)
+{
+}
+
+std::int32_t NativeServerException::getCode() const {
+    return code_;
+}
+
+const std::string & NativeServerException::getName() const {
+    return name_;
+}
+
+NativeProtocolClient::NativeProtocolClient(std::istream & in, std::ostream & out, bool compression)
+    : in_(in)
+    , out_(out)
+    , compression_(compression)
+{
+}
+
+void NativeProtocolClient::handshake(const ClientInfo & client_info, const std::string & database, const std::string & user, const std::string & password) {
+    client_info_ = client_info;
+
+    std::string packet;
+    writeVarUInt(packet, ClientPacket::Hello);
+    writeString(packet, client_info_.name);
+    writeVarUInt(packet, client_info_.version_major);
+    writeVarUInt(packet, client_info_.version_minor);
+    writeVarUInt(packet, revision);
+    writeString(packet, database);
+    writeString(packet, user);
+    writeString(packet, password);
+    sendPacket(packet);
+
+    const auto packet_type = readVarUInt(in_);
+
+    if (packet_type == ServerPacket::Exception)
+        receiveException();
+
+    if (packet_type != ServerPacket::Hello)
+        throw std::runtime_error("Unexpected packet " + std::to_string(packet_type) + " from the server in reply to Hello");
+
+    server_info_.name = readString(in_);
+    server_info_.version_major = readVarUInt(in_);
+    server_info_.version_minor = readVarUInt(in_);
+    server_info_.revision = readVarUInt(in_);
+
+    // The rest of the fields are sent only to the clients of the revisions, that are newer than the one of this client.
+    if (server_info_.revision >= min_revision_with_server_timezone)
+        server_info_.timezone = readString(in_);
+}
+
+void NativeProtocolClient::sendQuery(const std::string & query_id, const std::string & query) {
+    if (query_running_)
+        throw std::runtime_error("Results of the previous query have not been received to the end");
+
+    std::string packet;
+    writeVarUInt(packet, ClientPacket::Query);
+    writeString(packet, query_id);
+
+    // Client info. The initial user, query and address are set by the server for the initial queries.
+    writeFixed<std::uint8_t>(packet, query_kind_initial);
+    writeString(packet, "");
+    writeString(packet, "");
+    writeString(packet, "0.0.0.0:0");
+    writeFixed<std::uint8_t>(packet, interface_tcp);
+    writeString(packet, ""); // OS user.
+    writeString(packet, ""); // Host name.
+    writeString(packet, client_info_.name);
+    writeVarUInt(packet, client_info_.version_major);
+    writeVarUInt(packet, client_info_.version_minor);
+    writeVarUInt(packet, revision);
+    writeString(packet, ""); // Quota key.
+
+    writeString(packet, ""); // The end of the settings, none are changed.
+    writeVarUInt(packet, stage_complete);
+    writeVarUInt(packet, compression_ ? 1 : 0);
+    writeString(packet, query);
+
+    // The query has no external tables.
+    writeEmptyDataPacket(packet, compression_);
+
+    progress_ = Progress{};
+    sendPacket(packet);
+
+    query_running_ = true;
+    expects_insert_data_ = isInsertQuery(query);
+}
+
+void NativeProtocolClient::sendCancel() {
+    if (!query_running_)
+        return;
+
+    std::string packet;
+    writeVarUInt(packet, ClientPacket::Cancel);
+    sendPacket(packet);
+}
+
+void NativeProtocolClient::ping() {
+    if (query_running_)
+        throw std::runtime_error("Unable to ping the server, while a query is being executed");
+
+    std::string packet;
+    writeVarUInt(packet, ClientPacket::Ping);
+    sendPacket(packet);
+
+    const auto packet_type = readVarUInt(in_);
+
+    if (packet_type == ServerPacket::Exception)
+        receiveException();
+
+    if (packet_type != ServerPacket::Pong)
+        throw std::runtime_error("Unexpected packet " + std::to_string(packet_type) + " from the server in reply to Ping");
+}
+
+bool NativeProtocolClient::receiveBlock(Block & block) {
+    while (query_running_) {
+        const auto packet_type = readVarUInt(in_);
+
+        switch (packet_type) {
+            case ServerPacket::Data: {
+                readString(in_); // The name of the table, empty for the results.
+                readBlock(block, compression_);
+
+                // The blocks without columns are sent, e.g., as the empty results of the queries, that do not return any.
+                if (block.column_names.empty())
+                    continue;
+
+                // The server asks for the data of an INSERT query by sending the structure of the table, none is sent then.
+                if (expects_insert_data_) {
+                    expects_insert_data_ = false;
+
+                    std::string packet;
+                    writeEmptyDataPacket(packet, compression_);
+                    sendPacket(packet);
+                    continue;
+                }
+
+                return true;
+            }
+
+            case ServerPacket::Totals:
+            case ServerPacket::Extremes: {
+                Block ignored;
+                readString(in_);
+                readBlock(ignored, compression_);
+                continue;
+            }
+
+            case ServerPacket::Log: {
+                // The logs of the server are never compressed.
+                Block ignored;
+                readString(in_);
+                readBlock(ignored, false);
+                continue;
+            }
+
+            case ServerPacket::Progress: {
+                progress_.rows += readVarUInt(in_);
+                progress_.bytes += readVarUInt(in_);
+                progress_.total_rows += readVarUInt(in_);
+                continue;
+            }
+
+            case ServerPacket::ProfileInfo: {
+                readVarUInt(in_); // rows
+                readVarUInt(in_); // blocks
+                readVarUInt(in_); // bytes
+                readFixed<std::uint8_t>(in_); // applied_limit
+                readVarUInt(in_); // rows_before_limit
+                readFixed<std::uint8_t>(in_); // calculated_rows_before_limit
+                continue;
+            }
+
+            case ServerPacket::TableColumns: {
+                readString(in_); // The name of the table.
+                readString(in_); // The description of the columns.
+                continue;
+            }
+
+            case ServerPacket::Exception: {
+                query_running_ = false;
+                expects_insert_data_ = false;
+                receiveException();
+            }
+
+            case ServerPacket::EndOfStream: {
+                query_running_ = false;
+                expects_insert_data_ = false;
+                return false;
+            }
+
+            default:
+                throw std::runtime_error("Unexpected packet " + std::to_string(packet_type) + " from the server");
+        }
+    }
+
+    return false;
+}
+
+bool NativeProtocolClient::isQueryRunning() const {
+    return query_running_;
+}
+
+const NativeProtocolClient::ServerInfo & NativeProtocolClient::getServerInfo() const {
+    return server_info_;
+}
+
+const NativeProtocolClient::Progress & NativeProtocolClient::getProgress() const {
+    return progress_;
+}
+
+void NativeProtocolClient::sendPacket(const std::string & packet) {
+    out_.write(packet.data(), packet.size());
+    out_.flush();
+
+    if (!out_)
+        throw std::runtime_error("Failed to send data to the server");
+}
+
+void NativeProtocolClient::readBlock(Block & block, bool compressed) {
+    if (!compressed) {
+        readBlockFrom(in_, block);
+        return;
+    }
+
+    CompressedFramesStreamBuf frames(in_);
+    std::istream frames_in(&frames);
+    frames_in.exceptions(std::ios::badbit);
+
+    readBlockFrom(frames_in, block);
+
+    // Each block is compressed into frames of its own.
+    if (frames.in_avail() > 0)
+        throw std::runtime_error("Unexpected data after a compressed block from the server");
+}
+
+void NativeProtocolClient::receiveException() {
+    const auto code = readFixed<std::int32_t>(in_);
+    const auto name = readString(in_);
+    auto message = readString(in_);
+    readString(in_); // The stack trace.
+
+    // The nested exceptions, if any, follow.
+    auto has_nested = (readFixed<std::uint8_t>(in_) != 0);
+    while (has_nested) {
+        readFixed<std::int32_t>(in_);
+        readString(in_);
+        message += "\n" + readString(in_);
+        readString(in_);
+        has_nested = (readFixed<std::uint8_t>(in_) != 0);
+    }
+
+    throw NativeServerException(code, name, message);
+}
+
+std::string compressNativeFrame(const std::string & data) {
+    // The literals of the only sequence follow the token, and the bytes, that extend their length beyond 14, if needed.
+    std::string compressed;
+    compressed.reserve(data.size() + data.size() / 255 + 2);
+    compressed.push_back(static_cast<char>(std::min<std::size_t>(data.size(), 15) << 4));
+
+    if (data.size() >= 15) {
+        auto rest = data.size() - 15;
+        for (; rest >= 255; rest -= 255) {
+            compressed.push_back(static_cast<char>(255));
+        }
+        compressed.push_back(static_cast<char>(rest));
+    }
+
+    compressed.append(data);
+
+    std::string frame(checksum_size, '\0');
+    writeFixed<std::uint8_t>(frame, method_lz4);
+    writeFixed<std::uint32_t>(frame, static_cast<std::uint32_t>(frame_header_size + compressed.size()));
+    writeFixed<std::uint32_t>(frame, static_cast<std::uint32_t>(data.size()));
+    frame.append(compressed);
+
+    // The checksum covers the header too.
+    const auto checksum = cityHash128(frame.data() + checksum_size, frame.size() - checksum_size);
+    std::memcpy(&frame[0], &checksum.first, sizeof(checksum.first));
+    std::memcpy(&frame[sizeof(checksum.first)], &checksum.second, sizeof(checksum.second));
+
+    return frame;
+}
+
+void decompressLZ4Block(const char * src, std::size_t src_size, char * dest, std::size_t dest_size) {
+    const auto * ip = reinterpret_cast<const std::uint8_t *>(src);
+    const auto * const ip_end = ip + src_size;
+    auto * op = reinterpret_cast<std::uint8_t *>(dest);
+    auto * const op_begin = op;
+    auto * const op_end = op + dest_size;
+
+    // The length of 15 in the token is extended by the following bytes, up to the first one, that is not 255.
+    const auto read_length = [&] (std::size_t length) {
+        if (length == 15) {
+            std::uint8_t byte = 0;
+            do {
+                if (ip == ip_end)
+                    throwMalformedLZ4();
+
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+        }
+
+        return length;
+    };
+
+    while (true) {
+        if (ip == ip_end)
+            throwMalformedLZ4();
+
+        const auto token = *ip++;
+
+        const auto literal_length = read_length(token >> 4);
+        if (literal_length > static_cast<std::size_t>(ip_end - ip) || literal_length > static_cast<std::size_t>(op_end - op))
+            throwMalformedLZ4();
+
+        std::memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // The last sequence has only the literals.
+        if (ip == ip_end)
+            break;
+
+        if (ip_end - ip < 2)
+            throwMalformedLZ4();
+
+        const std::size_t offset = ip[0] | (static_cast<std::size_t>(ip[1]) << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > static_cast<std::size_t>(op - op_begin))
+            throwMalformedLZ4();
+
+        const auto match_length = read_length(token & 15) + 4;
+        if (match_length > static_cast<std::size_t>(op_end - op))
+            throwMalformedLZ4();
+
+        // The match may overlap with the bytes, that it produces, repeating them.
+        const auto * match = op - offset;
+        if (offset >= match_length) {
+            std::memcpy(op, match, match_length);
+        }
+        else {
+            for (std::size_t i = 0; i < match_length; ++i) {
+                op[i] = match[i];
+            }
+        }
+
+        op += match_length;
+    }
+
+    if (op != op_end)
+        throwMalformedLZ4();
+}
+
+std::pair<std::uint64_t, std::uint64_t> cityHash128(const char * data, std::size_t size) {
+    return CityHash_v1_0_2::CityHash128(data, size);
+}
+
+NativeResultStreamBuf::NativeResultStreamBuf(NativeProtocolClient & client)
+    : client_(client)
+{
+}
+
+NativeResultStreamBuf::int_type NativeResultStreamBuf::underflow() {
+    while (gptr() == egptr()) {
+        if (!client_.receiveBlock(block_))
+            return traits_type::eof();
+
+        if (!header_written_) {
+            header_written_ = true;
+            column_count_ = block_.column_names.size();
+
+            // The header of RowBinaryWithNamesAndTypes format is made of the structure of the first block.
+            buffer_.clear();
+            writeVarUInt(buffer_, column_count_);
+
+            for (const auto & name : block_.column_names) {
+                writeString(buffer_, name);
+            }
+
+            for (const auto & type : block_.column_types) {
+                writeString(buffer_, type);
+            }
+
+            buffer_.append(block_.rows);
+        }
+        else {
+            if (block_.column_names.size() != column_count_)
+                throw std::runtime_error("Structure of the blocks from the server differs");
+
+            buffer_.swap(block_.rows);
+        }
+
+        setg(&buffer_[0], &buffer_[0], &buffer_[0] + buffer_.size());
+    }
+
+    return traits_type::to_int_type(*gptr());
+}
+
+std::unique_ptr<std::istream> makeNativeResultStream(NativeProtocolClient & client) {
+    return std::make_unique<NativeResultStream>(client);
+}
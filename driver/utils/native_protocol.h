@@ -0,0 +1,140 @@
+#pragma once
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cstddef>
+#include <cstdint>
+
+// An exception, that has been sent by the server, with the messages of the nested ones appended to its message.
+class NativeServerException
+    : public std::runtime_error
+{
+public:
+    explicit NativeServerException(std::int32_t code, const std::string & name, const std::string & message);
+
+    std::int32_t getCode() const;
+    const std::string & getName() const;
+
+private:
+    std::int32_t code_ = 0;
+    std::string name_;
+};
+
+// The client side of a connection to the server over the native TCP protocol of ClickHouse, working on a pair of streams, e.g.,
+// those of a socket. The client announces an old revision of the protocol, so that the server sends LowCardinality columns as
+// ordinary ones, and accepts the (empty) settings of the queries in the format, that does not depend on the types of their values.
+class NativeProtocolClient {
+public:
+    static constexpr std::uint64_t revision = 54213;
+
+    struct ClientInfo {
+        std::string name;
+        std::uint64_t version_major = 0;
+        std::uint64_t version_minor = 0;
+    };
+
+    struct ServerInfo {
+        std::string name;
+        std::uint64_t version_major = 0;
+        std::uint64_t version_minor = 0;
+        std::uint64_t revision = 0;
+        std::string timezone;
+    };
+
+    struct Progress {
+        std::uint64_t rows = 0;
+        std::uint64_t bytes = 0;
+        std::uint64_t total_rows = 0;
+    };
+
+    // A block of the results, with its values re-encoded row by row in RowBinary format.
+    struct Block {
+        std::vector<std::string> column_names;
+        std::vector<std::string> column_types; // As understood by the readers of RowBinaryWithNamesAndTypes format.
+        std::size_t row_count = 0;
+        std::string rows;
+    };
+
+    // The blocks are sent and received compressed with LZ4, if the compression is enabled.
+    explicit NativeProtocolClient(std::istream & in, std::ostream & out, bool compression = false);
+
+    // Exchange the Hello packets, throwing NativeServerException, if the server rejects the client, e.g., its credentials.
+    void handshake(const ClientInfo & client_info, const std::string & database, const std::string & user, const std::string & password);
+
+    // Send the query to be executed by the server. Its results must be received to the end, before another query is sent.
+    void sendQuery(const std::string & query_id, const std::string & query);
+
+    // Ask the server to stop executing the query. The results still have to be received to the end, which then comes soon.
+    void sendCancel();
+
+    // Make sure that the server is still there, while no query is being executed.
+    void ping();
+
+    // Receive the packets up to the next block of the results, that has columns, and decode it. Return false at the end of the results.
+    // An exception, sent by the server, is thrown as NativeServerException, and ends the results too.
+    bool receiveBlock(Block & block);
+
+    // Indicates whether a query has been sent, but its results have not been received to the end yet.
+    bool isQueryRunning() const;
+
+    const ServerInfo & getServerInfo() const;
+
+    // The progress of executing the current, or the last, query, accumulated from the Progress packets.
+    const Progress & getProgress() const;
+
+private:
+    void sendPacket(const std::string & packet);
+
+    // Read the block, that follows the name of the table in Data, Totals, Extremes and Log packets.
+    void readBlock(Block & block, bool compressed);
+
+    [[noreturn]] void receiveException();
+
+private:
+    std::istream & in_;
+    std::ostream & out_;
+    const bool compression_;
+    ClientInfo client_info_;
+    ServerInfo server_info_;
+    Progress progress_;
+    bool query_running_ = false;
+    bool expects_insert_data_ = false; // Set for an INSERT query, until the server asks for its data, if it does.
+};
+
+// Compress the data into a single frame of the compressed format of ClickHouse, with an LZ4 block, that consists of literals only.
+std::string compressNativeFrame(const std::string & data);
+
+// Decompress an LZ4 block into the buffer, that must be exactly of the size of the decompressed data.
+void decompressLZ4Block(const char * src, std::size_t src_size, char * dest, std::size_t dest_size);
+
+// CityHash128 of version 1.0.2, that is used for the checksums of the compressed frames. The low 64 bits are the first.
+std::pair<std::uint64_t, std::uint64_t> cityHash128(const char * data, std::size_t size);
+
+// Reads the results of the query, that has been sent by the client, as a stream in RowBinaryWithNamesAndTypes format, receiving
+// the blocks on demand. The stream is empty, if the results have no columns, e.g., for an INSERT query.
+class NativeResultStreamBuf
+    : public std::streambuf
+{
+public:
+    explicit NativeResultStreamBuf(NativeProtocolClient & client);
+
+protected:
+    virtual int_type underflow() override;
+
+private:
+    NativeProtocolClient & client_;
+    NativeProtocolClient::Block block_;
+    std::string buffer_;
+    bool header_written_ = false;
+    std::size_t column_count_ = 0;
+};
+
+// Creates a stream, that reads the results of the query, that has just been sent by the client.
+std::unique_ptr<std::istream> makeNativeResultStream(NativeProtocolClient & client);
@@ -0,0 +1,64 @@
+#include "driver/utils/native_session.h"
+
+#include <stdexcept>
+
+NativeSession::NativeSession(const Endpoint & endpoint, bool compression)
+    : endpoint_(endpoint)
+    , compression_(compression)
+{
+}
+
+const Endpoint & NativeSession::getEndpoint() const {
+    return endpoint_;
+}
+
+void NativeSession::setTimeout(const Poco::Timespan & connection_timeout, const Poco::Timespan & timeout) {
+    connection_timeout_ = connection_timeout;
+    timeout_ = timeout;
+
+    if (connected()) {
+        socket_.setReceiveTimeout(timeout_);
+        socket_.setSendTimeout(timeout_);
+    }
+}
+
+void NativeSession::connectTo(const Poco::Net::SocketAddress & address) {
+    reset();
+
+    socket_ = Poco::Net::StreamSocket();
+    socket_.connect(address, connection_timeout_);
+    socket_.setReceiveTimeout(timeout_);
+    socket_.setSendTimeout(timeout_);
+
+    // The packets are flushed by the client, once they are complete.
+    socket_.setNoDelay(true);
+
+    stream_ = std::make_unique<Poco::Net::SocketStream>(socket_);
+
+    // Errors of the socket must not look like the end of the data.
+    stream_->exceptions(std::ios::badbit);
+
+    client_ = std::make_unique<NativeProtocolClient>(*stream_, *stream_, compression_);
+}
+
+bool NativeSession::connected() const {
+    return static_cast<bool>(client_);
+}
+
+void NativeSession::reset() {
+    client_.reset();
+    stream_.reset();
+
+    try {
+        socket_.close();
+    }
+    catch (...) {
+    }
+}
+
+NativeProtocolClient & NativeSession::getClient() {
+    if (!client_)
+        throw std::runtime_error("Native session is not connected");
+
+    return *client_;
+}
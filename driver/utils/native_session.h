@@ -0,0 +1,45 @@
+#pragma once
+
+#include "driver/utils/http_response_body.h"
+#include "driver/utils/load_balancer.h"
+#include "driver/utils/native_protocol.h"
+
+#include <Poco/Net/SocketAddress.h>
+#include <Poco/Net/SocketStream.h>
+#include <Poco/Net/StreamSocket.h>
+#include <Poco/Timespan.h>
+
+#include <memory>
+
+// A connection to a server over the native TCP protocol, that is used by one statement at a time.
+class NativeSession
+    : public AddressConnectable
+{
+public:
+    explicit NativeSession(const Endpoint & endpoint, bool compression);
+
+    const Endpoint & getEndpoint() const;
+
+    // The timeouts are applied, when connecting.
+    void setTimeout(const Poco::Timespan & connection_timeout, const Poco::Timespan & timeout);
+
+    // Connect to the address of the server, the handshake is expected to follow.
+    virtual void connectTo(const Poco::Net::SocketAddress & address) override;
+
+    bool connected() const;
+
+    // Close the connection, e.g., when its state is not known after an error.
+    void reset();
+
+    // The client, that speaks the protocol over the connection, while connected.
+    NativeProtocolClient & getClient();
+
+private:
+    const Endpoint endpoint_;
+    const bool compression_;
+    Poco::Timespan connection_timeout_;
+    Poco::Timespan timeout_;
+    Poco::Net::StreamSocket socket_;
+    std::unique_ptr<Poco::Net::SocketStream> stream_;
+    std::unique_ptr<NativeProtocolClient> client_;
+};
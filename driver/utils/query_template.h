@@ -0,0 +1,187 @@
+#pragma once
+
+#include "driver/escaping/lexer.h"
+#include "driver/utils/type_info.h"
+#include "driver/exception.h"
+
+#include <algorithm>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cctype>
+
+// Extracts all unquoted ? and @name parameter markers from the query in a single pass.
+// The markers are removed from the query, and the names of the parameters and their positions in the resulting text are returned.
+inline std::vector<ParamInfo> extractQueryParameters(std::string & query) {
+    std::vector<ParamInfo> parameters;
+
+    std::string text;
+    text.reserve(query.size());
+
+    std::size_t copied = 0;
+    char quoted_by = '\0';
+
+    for (std::size_t i = 0; i < query.size(); ++i) {
+        const char curr = query[i];
+        const char next = (i + 1 < query.size() ? query[i + 1] : '\0');
+
+        switch (curr) {
+            case '\\': {
+                ++i; // Skip the next char unconditionally.
+                break;
+            }
+
+            case '"':
+            case '\'': {
+                if (quoted_by == curr) {
+                    if (next == curr) {
+                        ++i; // Skip the next char unconditionally: '' or "" SQL escaping.
+                        break;
+                    }
+                    else {
+                        quoted_by = '\0';
+                    }
+                }
+                else if (quoted_by == '\0') {
+                    quoted_by = curr;
+                }
+                break;
+            }
+
+            case '?':
+            case '@': {
+                if (quoted_by != '\0')
+                    break;
+
+                std::size_t marker_size = 1;
+                ParamInfo param_info;
+
+                if (curr == '@') {
+                    while (i + marker_size < query.size()) {
+                        const auto ch = static_cast<unsigned char>(query[i + marker_size]);
+                        if (ch == '_' || std::isalpha(ch) || (std::isdigit(ch) && marker_size > 1))
+                            ++marker_size;
+                        else
+                            break;
+                    }
+
+                    if (marker_size == 1)
+                        throw SqlException("Syntax error or access violation", "42000");
+
+                    param_info.name = query.substr(i, marker_size);
+                }
+
+                text.append(query, copied, i - copied);
+                copied = i + marker_size;
+                i = copied - 1; // - 1 to compensate for's next ++i
+
+                param_info.position = text.size();
+                parameters.emplace_back(std::move(param_info));
+                break;
+            }
+        }
+    }
+
+    if (!parameters.empty()) {
+        text.append(query, copied, std::string::npos);
+        query.swap(text);
+    }
+
+    return parameters;
+}
+
+// Renders the query, that has its parameters extracted by extractQueryParameters(), by appending it to dest in a single linear pass.
+// write_param(param_idx, dest) is called at the position of each parameter and must return the number of consecutive parameters
+// it has rendered (at least 1): the query text between them is skipped, e.g., when an entire list of values is replaced at once.
+template <typename WriteParam>
+inline void renderQuery(std::string & dest, const std::string & query, const std::vector<ParamInfo> & parameters, WriteParam && write_param) {
+    std::size_t copied = 0;
+
+    for (std::size_t i = 0; i < parameters.size();) {
+        dest.append(query, copied, parameters[i].position - copied);
+
+        const std::size_t rendered = write_param(i, dest);
+        i = std::min(i + std::max<std::size_t>(rendered, 1), parameters.size());
+        copied = parameters[i - 1].position;
+    }
+
+    dest.append(query, copied, std::string::npos);
+}
+
+// Same as above, but writes the query to the stream right away, instead of assembling it in memory.
+template <typename WriteParam>
+inline void renderQuery(std::ostream & dest, const std::string & query, const std::vector<ParamInfo> & parameters, WriteParam && write_param) {
+    std::size_t copied = 0;
+
+    for (std::size_t i = 0; i < parameters.size();) {
+        dest.write(query.data() + copied, parameters[i].position - copied);
+
+        const std::size_t rendered = write_param(i, dest);
+        i = std::min(i + std::max<std::size_t>(rendered, 1), parameters.size());
+        copied = parameters[i - 1].position;
+    }
+
+    dest.write(query.data() + copied, query.size() - copied);
+}
+
+enum class QueryKind {
+    Other,
+    Read,  // SELECT, WITH, SHOW, DESCRIBE, EXPLAIN, EXISTS
+    Write, // INSERT, and DDL or other statements, that modify the data or the schema
+};
+
+// Classifies the query by its first keyword, skipping the leading comments and parentheses.
+inline QueryKind classifyQuery(const std::string & query) {
+    std::size_t pos = 0;
+
+    // The lexer does not know the comments.
+    while (pos < query.size()) {
+        if (std::isspace(static_cast<unsigned char>(query[pos]))) {
+            ++pos;
+        }
+        else if (query.compare(pos, 2, "--") == 0) {
+            pos = query.find('\n', pos);
+        }
+        else if (query.compare(pos, 2, "/*") == 0) {
+            pos = query.find("*/", pos + 2);
+            if (pos != std::string::npos)
+                pos += 2;
+        }
+        else {
+            break;
+        }
+    }
+
+    if (pos >= query.size())
+        return QueryKind::Other;
+
+    Lexer lexer(StringView(query.data() + pos, query.size() - pos));
+    while (lexer.Match(Token::LPARENT)) {
+    }
+
+    const auto keyword = lexer.Consume();
+    if (keyword.isInvalid() || keyword.type == Token::EOS || keyword.literal.empty())
+        return QueryKind::Other;
+
+    static const std::vector<std::string> read_keywords = {
+        "SELECT", "WITH", "SHOW", "DESCRIBE", "DESC", "EXPLAIN", "EXISTS"
+    };
+
+    // KILL is not a write, since the queries to kill may run on the servers of any list, and it is sent to the main one.
+    static const std::vector<std::string> write_keywords = {
+        "INSERT", "CREATE", "ALTER", "DROP", "TRUNCATE", "RENAME", "EXCHANGE", "OPTIMIZE",
+        "ATTACH", "DETACH", "DELETE", "UPDATE", "GRANT", "REVOKE", "SYSTEM"
+    };
+
+    auto upper_keyword = keyword.literal.to_string();
+    std::transform(upper_keyword.begin(), upper_keyword.end(), upper_keyword.begin(), [] (unsigned char ch) { return std::toupper(ch); });
+
+    if (std::find(read_keywords.begin(), read_keywords.end(), upper_keyword) != read_keywords.end())
+        return QueryKind::Read;
+
+    if (std::find(write_keywords.begin(), write_keywords.end(), upper_keyword) != write_keywords.end())
+        return QueryKind::Write;
+
+    return QueryKind::Other;
+}
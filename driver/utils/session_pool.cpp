@@ -0,0 +1,101 @@
+#include "driver/utils/session_pool.h"
+
+#include <Poco/Net/Socket.h>
+#include <Poco/Timespan.h>
+
+#include <vector>
+
+namespace {
+
+    bool isUsable(Poco::Net::HTTPClientSession & session) {
+        try {
+            // An idle keep-alive connection has nothing to read, unless it has been closed by the server, or has failed otherwise.
+            return (
+                session.connected() &&
+                !session.socket().poll(Poco::Timespan(0), Poco::Net::Socket::SELECT_READ | Poco::Net::Socket::SELECT_ERROR)
+            );
+        }
+        catch (...) {
+            return false;
+        }
+    }
+
+} // namespace
+
+SessionPool & SessionPool::getInstance() {
+    static SessionPool pool;
+    return pool;
+}
+
+std::unique_ptr<Poco::Net::HTTPClientSession> SessionPool::acquire(const std::string & key, std::chrono::seconds max_idle_time) {
+    while (true) {
+        auto session = take(key, max_idle_time);
+
+        if (!session) {
+            ++misses_;
+            return session;
+        }
+
+        if (isUsable(*session)) {
+            ++hits_;
+            return session;
+        }
+    }
+}
+
+void SessionPool::release(const std::string & key, std::unique_ptr<Poco::Net::HTTPClientSession> && session, std::size_t max_size) {
+    if (!session || max_size == 0 || !session->connected())
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto & sessions = idle_sessions_[key];
+
+    if (sessions.size() < max_size)
+        sessions.push_back(IdleSession{std::move(session), Clock::now()});
+}
+
+void SessionPool::clear() {
+    decltype(idle_sessions_) discarded;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_sessions_.swap(discarded);
+    }
+}
+
+std::uint64_t SessionPool::getHitCount() const {
+    return hits_;
+}
+
+std::uint64_t SessionPool::getMissCount() const {
+    return misses_;
+}
+
+std::unique_ptr<Poco::Net::HTTPClientSession> SessionPool::take(const std::string & key, std::chrono::seconds max_idle_time) {
+    std::unique_ptr<Poco::Net::HTTPClientSession> session;
+    std::vector<std::unique_ptr<Poco::Net::HTTPClientSession>> expired; // Closed after the lock is released.
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = idle_sessions_.find(key);
+
+    if (it == idle_sessions_.end())
+        return session;
+
+    auto & sessions = it->second;
+    const auto now = Clock::now();
+
+    while (!sessions.empty() && now - sessions.front().idle_since > max_idle_time) {
+        expired.emplace_back(std::move(sessions.front().session));
+        sessions.pop_front();
+    }
+
+    if (!sessions.empty()) {
+        session = std::move(sessions.back().session);
+        sessions.pop_back();
+    }
+
+    if (sessions.empty())
+        idle_sessions_.erase(it);
+
+    return session;
+}
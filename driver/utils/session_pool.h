@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Poco/Net/HTTPClientSession.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <cstdint>
+
+// A process-wide pool of idle keep-alive HTTP(S) sessions, that lets the connections, established again with the same settings,
+// skip the TCP and TLS handshakes. Thread-safe.
+class SessionPool {
+public:
+    static SessionPool & getInstance();
+
+    // Take the most recently released session stored under the key, that is still usable, or return nullptr.
+    // The sessions, that have been idle for longer than max_idle_time, or have been closed by the server meanwhile, are discarded.
+    std::unique_ptr<Poco::Net::HTTPClientSession> acquire(const std::string & key, std::chrono::seconds max_idle_time);
+
+    // Store the session under the key for reuse, unless it is not connected, or max_size sessions are stored under the key already.
+    void release(const std::string & key, std::unique_ptr<Poco::Net::HTTPClientSession> && session, std::size_t max_size);
+
+    // Discard all stored sessions.
+    void clear();
+
+    // The numbers of acquire() calls, that have returned a session, and that have not.
+    std::uint64_t getHitCount() const;
+    std::uint64_t getMissCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct IdleSession {
+        std::unique_ptr<Poco::Net::HTTPClientSession> session;
+        Clock::time_point idle_since;
+    };
+
+    // Take the most recently released session stored under the key, discarding the expired ones, or return nullptr.
+    std::unique_ptr<Poco::Net::HTTPClientSession> take(const std::string & key, std::chrono::seconds max_idle_time);
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<std::string, std::deque<IdleSession>> idle_sessions_; // The least recently released sessions go first.
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#   include <emmintrin.h>
+#   define CH_ODBC_USE_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#   include <intrin.h>
+#endif
+
+namespace simd {
+
+    // Index of the lowest set bit. 'mask' must not be 0.
+    inline unsigned int lowestBitIndex(unsigned int mask) noexcept {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanForward(&index, mask);
+        return index;
+#else
+        return __builtin_ctz(mask);
+#endif
+    }
+
+    // Length of the canonical textual representation of UUID, e.g. "01234567-89ab-cdef-0123-456789abcdef".
+    constexpr std::size_t uuid_text_length = 36;
+
+    // Positions of '-' separators in the canonical textual representation of UUID.
+    constexpr std::size_t uuid_dash_positions[] = { 8, 13, 18, 23 };
+
+    // Encode 16 bytes into 32 lower-case hex digits.
+    inline void encodeHex16(const std::uint8_t * src, char * dest) noexcept {
+#if defined(CH_ODBC_USE_SSE2)
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i low_nibble_mask = _mm_set1_epi8(0x0F);
+
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble_mask);
+        const __m128i lo = _mm_and_si128(bytes, low_nibble_mask);
+
+        // Interleave so that the high nibble of each byte goes first.
+        const __m128i nibbles_1 = _mm_unpacklo_epi8(hi, lo);
+        const __m128i nibbles_2 = _mm_unpackhi_epi8(hi, lo);
+
+        const __m128i nine = _mm_set1_epi8(9);
+        const __m128i zero_char = _mm_set1_epi8('0');
+        const __m128i letter_offset = _mm_set1_epi8('a' - '0' - 10);
+
+        const auto to_chars = [&] (const __m128i nibbles) {
+            const __m128i is_letter = _mm_cmpgt_epi8(nibbles, nine);
+            return _mm_add_epi8(_mm_add_epi8(nibbles, zero_char), _mm_and_si128(is_letter, letter_offset));
+        };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), to_chars(nibbles_1));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest + 16), to_chars(nibbles_2));
+#else
+        constexpr const char * digits = "0123456789abcdef";
+        for (std::size_t i = 0; i < 16; ++i) {
+            dest[i * 2] = digits[src[i] >> 4];
+            dest[i * 2 + 1] = digits[src[i] & 0x0F];
+        }
+#endif
+    }
+
+    // Decode 32 hex digits (case-insensitive) into 16 bytes. Return false if any of the characters is not a hex digit.
+    inline bool decodeHex16(const char * src, std::uint8_t * dest) noexcept {
+#if defined(CH_ODBC_USE_SSE2)
+        const auto to_nibbles = [] (const __m128i chars, __m128i & nibbles) {
+            // Map '0'..'9' to 0..9 and 'a'..'f'/'A'..'F' to 10..15, using signed compares on biased values.
+            const __m128i digits = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+            const __m128i is_digit = _mm_and_si128(
+                _mm_cmpgt_epi8(digits, _mm_set1_epi8(-1)),
+                _mm_cmplt_epi8(digits, _mm_set1_epi8(10))
+            );
+
+            const __m128i letters = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i is_letter = _mm_and_si128(
+                _mm_cmpgt_epi8(letters, _mm_set1_epi8(-1)),
+                _mm_cmplt_epi8(letters, _mm_set1_epi8(6))
+            );
+
+            nibbles = _mm_or_si128(
+                _mm_and_si128(is_digit, digits),
+                _mm_and_si128(is_letter, _mm_add_epi8(letters, _mm_set1_epi8(10)))
+            );
+
+            return _mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) == 0xFFFF;
+        };
+
+        __m128i nibbles_1;
+        __m128i nibbles_2;
+
+        if (
+            !to_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), nibbles_1) ||
+            !to_nibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), nibbles_2)
+        ) {
+            return false;
+        }
+
+        // Each 16-bit lane holds [high nibble, low nibble] pair, combine them into a byte and pack.
+        const auto combine = [] (const __m128i nibbles) {
+            const __m128i hi = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+            const __m128i lo = _mm_srli_epi16(nibbles, 8);
+            return _mm_or_si128(hi, lo);
+        };
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dest), _mm_packus_epi16(combine(nibbles_1), combine(nibbles_2)));
+        return true;
+#else
+        const auto to_nibble = [] (const char ch) -> int {
+            if (ch >= '0' && ch <= '9') return ch - '0';
+            if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+            if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+            return -1;
+        };
+
+        for (std::size_t i = 0; i < 16; ++i) {
+            const auto hi = to_nibble(src[i * 2]);
+            const auto lo = to_nibble(src[i * 2 + 1]);
+
+            if (hi < 0 || lo < 0)
+                return false;
+
+            dest[i] = static_cast<std::uint8_t>((hi << 4) | lo);
+        }
+
+        return true;
+#endif
+    }
+
+    // Encode 16 bytes of UUID (in textual order) into its canonical 36-character textual representation.
+    inline void encodeUUID(const std::uint8_t * src, char * dest) noexcept {
+        char hex[32];
+        encodeHex16(src, hex);
+
+        std::memcpy(dest,      hex,      8); dest[8]  = '-';
+        std::memcpy(dest + 9,  hex + 8,  4); dest[13] = '-';
+        std::memcpy(dest + 14, hex + 12, 4); dest[18] = '-';
+        std::memcpy(dest + 19, hex + 16, 4); dest[23] = '-';
+        std::memcpy(dest + 24, hex + 20, 12);
+    }
+
+    // Decode the canonical 36-character textual representation of UUID into 16 bytes (in textual order).
+    // Return false if the text is not a well-formed UUID.
+    inline bool decodeUUID(const char * src, const std::size_t size, std::uint8_t * dest) noexcept {
+        if (size != uuid_text_length)
+            return false;
+
+        for (const auto pos : uuid_dash_positions) {
+            if (src[pos] != '-')
+                return false;
+        }
+
+        char hex[32];
+
+        std::memcpy(hex,      src,      8);
+        std::memcpy(hex + 8,  src + 9,  4);
+        std::memcpy(hex + 12, src + 14, 4);
+        std::memcpy(hex + 16, src + 19, 4);
+        std::memcpy(hex + 20, src + 24, 12);
+
+        return decodeHex16(hex, dest);
+    }
+
+    // Return a pointer to the first occurrence of any of the three characters in [begin, end), or 'end' if there is none.
+    inline const char * findFirstOf(const char * begin, const char * end, const char c1, const char c2, const char c3) noexcept {
+#if defined(CH_ODBC_USE_SSE2)
+        const __m128i v1 = _mm_set1_epi8(c1);
+        const __m128i v2 = _mm_set1_epi8(c2);
+        const __m128i v3 = _mm_set1_epi8(c3);
+
+        while (end - begin >= 16) {
+            const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+            const __m128i matches = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, v1), _mm_cmpeq_epi8(chunk, v2)),
+                _mm_cmpeq_epi8(chunk, v3)
+            );
+            const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(matches));
+
+            if (mask != 0)
+                return begin + lowestBitIndex(mask);
+
+            begin += 16;
+        }
+#endif
+
+        for (; begin < end; ++begin) {
+            if (*begin == c1 || *begin == c2 || *begin == c3)
+                break;
+        }
+
+        return begin;
+    }
+
+} // namespace simd
+
+#undef CH_ODBC_USE_SSE2
@@ -0,0 +1,82 @@
+#include "driver/utils/thread_pool.h"
+
+#include <stdexcept>
+#include <thread>
+
+ThreadPool::ThreadPool(std::size_t max_threads, std::chrono::milliseconds idle_timeout)
+    : max_threads_(max_threads)
+    , idle_timeout_(idle_timeout)
+{
+    if (max_threads_ == 0)
+        throw std::runtime_error("Thread pool must have at least one thread");
+}
+
+ThreadPool::~ThreadPool() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    stopping_ = true;
+    tasks_.clear();
+    cv_.notify_all();
+
+    // The threads are detached, so that the idle ones can stop on their own, hence the waiting for their count to drop.
+    stopped_cv_.wait(lock, [&] () { return thread_count_ == 0; });
+}
+
+ThreadPool & ThreadPool::getInstance() {
+    // Each running function blocks its thread, while waiting for the server, hence the generous limit.
+    // The pool is never destroyed, since the threads may be gone already, or blocked in a call to the server, at process exit,
+    // when the destructors of static objects run, and waiting for them then would hang the process, e.g., under the loader lock.
+    static auto * instance = new ThreadPool(256, std::chrono::seconds(60));
+    return *instance;
+}
+
+void ThreadPool::schedule(Task task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (stopping_)
+        throw std::runtime_error("Thread pool is stopping");
+
+    // Each of the queued tasks is going to be taken by one of the idle threads, a new thread is started, if none is left for this one.
+    if (idle_thread_count_ <= tasks_.size() && thread_count_ < max_threads_) {
+        std::thread([this] () { work(); }).detach();
+        ++thread_count_;
+    }
+
+    tasks_.emplace_back(std::move(task));
+    cv_.notify_one();
+}
+
+std::size_t ThreadPool::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return thread_count_;
+}
+
+void ThreadPool::work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        ++idle_thread_count_;
+        const bool has_task = cv_.wait_for(lock, idle_timeout_, [&] () { return stopping_ || !tasks_.empty(); });
+        --idle_thread_count_;
+
+        if (!has_task || stopping_)
+            break;
+
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+
+        lock.unlock();
+
+        try {
+            task();
+        }
+        catch (...) {
+        }
+
+        task = nullptr; // Release the captured state outside of the lock.
+        lock.lock();
+    }
+
+    --thread_count_;
+    stopped_cv_.notify_all();
+}
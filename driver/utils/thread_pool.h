@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+#include <cstddef>
+
+// A pool of threads, that run the scheduled tasks in the order they are scheduled. The threads are started on demand, when there is
+// no idle one, up to max_threads, and stop after being idle for idle_timeout. Thread-safe.
+class ThreadPool {
+public:
+    using Task = std::function<void ()>;
+
+    explicit ThreadPool(std::size_t max_threads, std::chrono::milliseconds idle_timeout);
+
+    // Wait for the running tasks to finish, the scheduled tasks, that have not been started, are dropped.
+    ~ThreadPool();
+
+    // The process-wide pool, that runs the asynchronously executed functions of the statements. It is never destroyed.
+    static ThreadPool & getInstance();
+
+    // Run the task on one of the threads. The exceptions, thrown by the task, are ignored.
+    void schedule(Task task);
+
+    std::size_t getThreadCount() const;
+
+private:
+    void work();
+
+private:
+    const std::size_t max_threads_;
+    const std::chrono::milliseconds idle_timeout_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_; // Notified when a task is scheduled, or when the pool is stopping.
+    std::condition_variable stopped_cv_; // Notified when a thread stops.
+    std::deque<Task> tasks_;
+    std::size_t thread_count_ = 0;
+    std::size_t idle_thread_count_ = 0;
+    bool stopping_ = false;
+};
@@ -2,6 +2,7 @@
 
 #include "driver/platform/platform.h"
 #include "driver/utils/unicode_conv.h"
+#include "driver/utils/simd.h"
 #include "driver/exception.h"
 
 #include <algorithm>
@@ -95,6 +96,9 @@ bool isInputParam(SQLSMALLINT param_io_type) noexcept;
 bool isOutputParam(SQLSMALLINT param_io_type) noexcept;
 bool isStreamParam(SQLSMALLINT param_io_type) noexcept;
 
+// Size of a value of a fixed-size C type, or 0 for variable-size types (character and binary ones).
+std::size_t getCTypeOctetLength(SQLSMALLINT c_type) noexcept;
+
 /// Helper structure that represents information about where and
 /// how to get or put values when reading or writing bound buffers.
 struct BindingInfo {
@@ -122,7 +126,7 @@ struct ParamBindingInfo
 /// Helper structure that represents different aspects of parameter info in a prepared query.
 struct ParamInfo {
     std::string name;
-    std::string tmp_placeholder;
+    std::size_t position = 0; // Position of the parameter in the query text, from which all the parameter markers are removed.
 };
 
 struct BoundTypeInfo {
@@ -878,26 +882,16 @@ namespace value_manip {
         using DestinationType = SQLGUID;
 
         static inline void convert(const SourceType & src, DestinationType & dest) {
-            unsigned int Data1 = 0;
-            unsigned int Data2 = 0;
-            unsigned int Data3 = 0;
-            unsigned int Data4[8] = { 0 };
-            char guard = '\0';
-
-            const auto read = std::sscanf(src.c_str(), "%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x%c",
-                &Data1, &Data2, &Data3,
-                &Data4[0], &Data4[1], &Data4[2], &Data4[3],
-                &Data4[4], &Data4[5], &Data4[6], &Data4[7],
-                &guard
-            );
+            std::uint8_t bytes[16];
 
-            if (read != 11) // All 'DataN' must be successfully read, but not the 'guard'.
+            if (!simd::decodeUUID(src.data(), src.size(), bytes))
                 throw std::runtime_error("Cannot interpret '" + src + "' as GUID");
 
-            dest.Data1 = Data1;
-            dest.Data2 = Data2;
-            dest.Data3 = Data3;
-            std::copy(std::begin(Data4), std::end(Data4), std::begin(dest.Data4));
+            // Textual representation lists Data1, Data2, and Data3 in big-endian byte order.
+            dest.Data1 = (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16) | (std::uint32_t(bytes[2]) << 8) | std::uint32_t(bytes[3]);
+            dest.Data2 = static_cast<decltype(dest.Data2)>((bytes[4] << 8) | bytes[5]);
+            dest.Data3 = static_cast<decltype(dest.Data3)>((bytes[6] << 8) | bytes[7]);
+            std::copy(bytes + 8, bytes + 16, std::begin(dest.Data4));
         }
     };
 
@@ -1402,18 +1396,17 @@ namespace value_manip {
         using DestinationType = std::string;
 
         static inline void convert(const SourceType & src, DestinationType & dest) {
-            char buf[256];
-
-            const auto written = std::snprintf(buf, lengthof(buf), "%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-                (unsigned int)src.Data1,    (unsigned int)src.Data2,    (unsigned int)src.Data3,
-                (unsigned int)src.Data4[0], (unsigned int)src.Data4[1], (unsigned int)src.Data4[2], (unsigned int)src.Data4[3],
-                (unsigned int)src.Data4[4], (unsigned int)src.Data4[5], (unsigned int)src.Data4[6], (unsigned int)src.Data4[7]
-            );
-
-            if (written < 36 || written >= lengthof(buf))
-                buf[0] = '\0';
-
-            dest = buf;
+            const std::uint8_t bytes[16] = {
+                static_cast<std::uint8_t>(src.Data1 >> 24), static_cast<std::uint8_t>(src.Data1 >> 16),
+                static_cast<std::uint8_t>(src.Data1 >> 8),  static_cast<std::uint8_t>(src.Data1),
+                static_cast<std::uint8_t>(src.Data2 >> 8),  static_cast<std::uint8_t>(src.Data2),
+                static_cast<std::uint8_t>(src.Data3 >> 8),  static_cast<std::uint8_t>(src.Data3),
+                src.Data4[0], src.Data4[1], src.Data4[2], src.Data4[3],
+                src.Data4[4], src.Data4[5], src.Data4[6], src.Data4[7]
+            };
+
+            dest.resize(simd::uuid_text_length);
+            simd::encodeUUID(bytes, dest.data());
         }
     };
 
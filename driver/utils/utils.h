@@ -134,6 +134,10 @@ public:
         }
     }
 
+    bool empty() const {
+        return cache_.empty();
+    }
+
     T get() {
         if (cache_.empty()) {
             return T{};
@@ -163,11 +167,16 @@ public:
 
     ~AmortizedIStreamReader() {
         // Put back any pre-read characters, just in case...
-        if (available() > 0) {
-            for (std::size_t i = buffer_.size() - 1; i >= offset_; --i) {
-                raw_stream_.putback(buffer_[i]);
+        // Streams that report errors by exceptions may fail to do that, which is not an error here.
+        try {
+            if (available() > 0) {
+                for (std::size_t i = buffer_.size(); i > offset_; --i) {
+                    raw_stream_.putback(buffer_[i - 1]);
+                }
             }
         }
+        catch (...) {
+        }
     }
 
     AmortizedIStreamReader(const AmortizedIStreamReader &) = delete;
@@ -213,6 +222,13 @@ public:
         return *this;
     }
 
+    // Try to make at least 'count' bytes available, and expose all the available bytes without consuming them.
+    // The returned view is valid only until the next call to any of the non-const member functions.
+    std::pair<const char *, std::size_t> peek(std::size_t count = 1) {
+        tryPrepare(count);
+        return { buffer_.data() + offset_, available() };
+    }
+
 private:
     std::size_t available() const {
         if (offset_ < buffer_.size())
@@ -225,9 +241,8 @@ private:
         const auto avail = available();
 
         if (avail < count) {
-            static constexpr std::size_t min_read_size = 1 << 13; // 8 KB
-
-            const auto to_read = std::max<std::size_t>(min_read_size, count - avail);
+            const auto required = count - avail;
+            const auto to_read = std::max<std::size_t>(read_size_, required);
             const auto tail_capacity = buffer_.capacity() - buffer_.size();
             const auto free_capacity = tail_capacity + offset_;
 
@@ -254,16 +269,30 @@ private:
                 resize_without_initialization(buffer_, buffer_.size() + to_read);
             }
 
-            raw_stream_.read(&buffer_[offset_ + avail], to_read);
+            // Wait only for the required bytes, and then take whatever else the stream can give right away.
+            auto * dest = &buffer_[offset_ + avail];
+            raw_stream_.read(dest, required);
+            std::size_t read_count = raw_stream_.gcount();
+
+            if (read_count == required && to_read > required)
+                read_count += raw_stream_.readsome(dest + read_count, to_read - required);
 
-            if (raw_stream_.gcount() < to_read)
-                buffer_.resize(buffer_.size() - (to_read - raw_stream_.gcount()));
+            // Read in larger pieces while the stream keeps up.
+            if (read_count == to_read && read_size_ < max_read_size)
+                read_size_ *= 2;
+
+            if (read_count < to_read)
+                buffer_.resize(buffer_.size() - (to_read - read_count));
         }
     }
 
 private:
+    static constexpr std::size_t min_read_size = 1 << 13; // 8 KB
+    static constexpr std::size_t max_read_size = 1 << 22; // 4 MB
+
     std::istream & raw_stream_;
     std::size_t offset_ = 0;
+    std::size_t read_size_ = min_read_size;
     std::string buffer_;
 };
 